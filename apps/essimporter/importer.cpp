@@ -344,7 +344,7 @@ namespace ESSImport
 
         ESM::ESMWriter writer;
 
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+        writer.setFormat (ESM::SavedGame::sUncompressedFormat);
 
         boost::filesystem::ofstream stream(boost::filesystem::path(mOutFile), std::ios::out | std::ios::binary);
         // all unused
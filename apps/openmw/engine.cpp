@@ -30,6 +30,8 @@
 
 #include <components/compiler/extensions0.hpp>
 
+#include <components/esm/esmreader.hpp>
+
 #include <components/sceneutil/workqueue.hpp>
 
 #include <components/files/configurationmanager.hpp>
@@ -44,6 +46,7 @@
 
 #include "mwscript/scriptmanagerimp.hpp"
 #include "mwscript/interpretercontext.hpp"
+#include "mwscript/scriptcache.hpp"
 
 #include "mwsound/soundmanagerimp.hpp"
 
@@ -739,8 +742,20 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
+    std::unique_ptr<MWScript::ScriptCache> scriptCache;
+    if (Settings::Manager::getBool("compiled script cache", "Game"))
+    {
+        std::vector<std::string> contentFiles;
+        for (const ESM::ESMReader& reader : mEnvironment.getWorld()->getEsmReader())
+            contentFiles.push_back(reader.getName());
+        const std::uintmax_t maxSize = static_cast<std::uintmax_t>(std::max(0,
+            Settings::Manager::getInt("compiled script cache max size", "Game"))) * 1024 * 1024;
+        scriptCache = std::make_unique<MWScript::ScriptCache>((mCfgMgr.getUserDataPath() / "scriptcache").string(),
+            mExtensions, contentFiles, maxSize);
+    }
+
     mEnvironment.setScriptManager (new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>(), std::move(scriptCache)));
 
     // Create game mechanics system
     MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <set>
+#include <vector>
 
 #include "../mwworld/ptr.hpp"
 #include "../mwsound/type.hpp"
@@ -180,6 +181,10 @@ namespace MWBase
 
             virtual void setListenerPosDir(const osg::Vec3f &pos, const osg::Vec3f &dir, const osg::Vec3f &up, bool underwater) = 0;
 
+            virtual void preloadSounds(const std::vector<std::string>& soundIds) = 0;
+            ///< Decode given sounds in background to have them ready when they are played.
+            /// Does nothing if the decoded sound cache is disabled.
+
             virtual void updatePtr(const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated) = 0;
 
             virtual void clear() = 0;
@@ -64,6 +64,10 @@ namespace MWBase
             ///
             /// \note Slot must belong to the current character.
 
+            virtual void waitForSaveGame() = 0;
+            ///< Wait until the saved game being written in background is completed. A failed save deletes its
+            /// slot, so this has to be called before pointers to slots are taken.
+
             virtual void loadGame (const std::string& filepath) = 0;
             ///< Load a saved game directly from the given file path. This will search the CharacterManager
             /// for a Character containing this save file, and set this Character current if one was found.
@@ -650,6 +650,20 @@ namespace MWClass
         return std::string();
     }
 
+    void Creature::getSoundsToPreload(const MWWorld::Ptr &ptr, std::vector<std::string> &sounds) const
+    {
+        MWWorld::LiveCellRef<ESM::Creature>* ref = ptr.get<ESM::Creature>();
+
+        const std::string& ourId = (ref->mBase->mOriginal.empty()) ? ptr.getCellRef().getRefId() : ref->mBase->mOriginal;
+
+        const MWWorld::ESMStore &store = MWBase::Environment::get().getWorld()->getStore();
+        for (const ESM::SoundGenerator& sound : store.get<ESM::SoundGenerator>())
+        {
+            if (!sound.mCreature.empty() && Misc::StringUtils::ciEqual(ourId, sound.mCreature))
+                sounds.push_back(sound.mSound);
+        }
+    }
+
     MWWorld::Ptr Creature::copyToCellImpl(const MWWorld::ConstPtr &ptr, MWWorld::CellStore &cell) const
     {
         const MWWorld::LiveCellRef<ESM::Creature> *ref = ptr.get<ESM::Creature>();
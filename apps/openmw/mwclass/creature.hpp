@@ -103,6 +103,8 @@ namespace MWClass
             void getModelsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& models) const override;
             ///< Get a list of models to preload that this object may use (directly or indirectly). default implementation: list getModel().
 
+            void getSoundsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& sounds) const override;
+
             bool isBipedal (const MWWorld::ConstPtr &ptr) const override;
             bool canFly (const MWWorld::ConstPtr &ptr) const override;
             bool canSwim (const MWWorld::ConstPtr &ptr) const override;
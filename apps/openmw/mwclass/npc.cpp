@@ -1,6 +1,7 @@
 ﻿#include "npc.hpp"
 
 #include <memory>
+#include <utility>
 
 #include <components/misc/constants.hpp>
 #include <components/misc/rng.hpp>
@@ -241,6 +242,25 @@ namespace
             npcStats.getSpells().addAllToInstance(spells);
         }
     }
+
+    /// @return left and right footstep sound ids for the boots worn, nullptr when the boots make no sound
+    std::pair<const char*, const char*> getFootstepSounds(const MWWorld::InventoryStore& inv)
+    {
+        MWWorld::ConstContainerStoreIterator boots = inv.getSlot(MWWorld::InventoryStore::Slot_Boots);
+        if (boots == inv.end() || boots->getTypeName() != typeid(ESM::Armor).name())
+            return {"FootBareLeft", "FootBareRight"};
+
+        switch (boots->getClass().getEquipmentSkill(*boots))
+        {
+            case ESM::Skill::LightArmor:
+                return {"FootLightLeft", "FootLightRight"};
+            case ESM::Skill::MediumArmor:
+                return {"FootMedLeft", "FootMedRight"};
+            case ESM::Skill::HeavyArmor:
+                return {"FootHeavyLeft", "FootHeavyRight"};
+        }
+        return {nullptr, nullptr};
+    }
 }
 
 namespace MWClass
@@ -508,6 +528,16 @@ namespace MWClass
 
     }
 
+    void Npc::getSoundsToPreload(const MWWorld::Ptr &ptr, std::vector<std::string> &sounds) const
+    {
+        // Footsteps with current boots and sounds of melee combat
+        const std::pair<const char*, const char*> footsteps = getFootstepSounds(getInventoryStore(ptr));
+        if (footsteps.first != nullptr)
+            sounds.insert(sounds.end(), {footsteps.first, footsteps.second});
+
+        sounds.insert(sounds.end(), {"Weapon Swish", "Hand To Hand Hit", "Health Damage", "miss"});
+    }
+
     std::string Npc::getName (const MWWorld::ConstPtr& ptr) const
     {
         if(ptr.getRefData().getCustomData() && ptr.getRefData().getCustomData()->asNpcCustomData().mNpcStats.isWerewolf())
@@ -1235,20 +1265,9 @@ namespace MWClass
                         return std::string();
                 }
 
-                const MWWorld::InventoryStore &inv = Npc::getInventoryStore(ptr);
-                MWWorld::ConstContainerStoreIterator boots = inv.getSlot(MWWorld::InventoryStore::Slot_Boots);
-                if(boots == inv.end() || boots->getTypeName() != typeid(ESM::Armor).name())
-                    return (name == "left") ? "FootBareLeft" : "FootBareRight";
-
-                switch(boots->getClass().getEquipmentSkill(*boots))
-                {
-                    case ESM::Skill::LightArmor:
-                        return (name == "left") ? "FootLightLeft" : "FootLightRight";
-                    case ESM::Skill::MediumArmor:
-                        return (name == "left") ? "FootMedLeft" : "FootMedRight";
-                    case ESM::Skill::HeavyArmor:
-                        return (name == "left") ? "FootHeavyLeft" : "FootHeavyRight";
-                }
+                const std::pair<const char*, const char*> footsteps = getFootstepSounds(Npc::getInventoryStore(ptr));
+                if (footsteps.first != nullptr)
+                    return (name == "left") ? footsteps.first : footsteps.second;
             }
             return std::string();
         }
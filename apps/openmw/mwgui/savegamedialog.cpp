@@ -159,6 +159,7 @@ namespace MWGui
         onSlotSelected(mSaveList, MyGUI::ITEM_NONE);
 
         MWBase::StateManager* mgr = MWBase::Environment::get().getStateManager();
+        mgr->waitForSaveGame();
         if (mgr->characterBegin() == mgr->characterEnd())
             return;
 
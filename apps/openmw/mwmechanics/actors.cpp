@@ -43,6 +43,8 @@
 #include "combat.hpp"
 #include "actorutil.hpp"
 #include "tickableeffects.hpp"
+#include "taskscheduler.hpp"
+#include "collisionprediction.hpp"
 
 namespace
 {
@@ -165,6 +167,62 @@ void forEachFollowingPackage(MWMechanics::Actors::PtrActorMap& actors, const MWW
     }
 }
 
+
+float getMaxHeadTrackDistance(const MWWorld::Ptr& actor)
+{
+    static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fMaxHeadTrackDistance")->mValue.getFloat();
+    static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fInteriorHeadTrackMult")->mValue.getFloat();
+    float maxDistance = fMaxHeadTrackDistance;
+    const ESM::Cell* currentCell = actor.getCell()->getCell();
+    if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
+        maxDistance *= fInteriorHeadTrackMult;
+    return maxDistance;
+}
+
+/// Evade the nearest predicted collision with a visible actor the actor is aware of. Must be called from the main thread.
+void avoidCollision(const MWWorld::Ptr& ptr, const MWMechanics::CollisionPredictionActor& actor,
+                    bool shouldTurnToApproachingActor, const std::vector<MWWorld::Ptr>& ptrs,
+                    const std::vector<MWMechanics::PredictedCollision>& collisions)
+{
+    float timeToCollision = MWMechanics::maxTimeToPredictCollision;
+    const MWMechanics::PredictedCollision* nearest = nullptr;
+    for (const MWMechanics::PredictedCollision& collision : collisions)
+    {
+        if (collision.mTime > timeToCollision)
+            continue;
+
+        // Check visibility and awareness last as it's expensive.
+        const MWWorld::Ptr& otherPtr = ptrs[collision.mOther];
+        if (!MWBase::Environment::get().getWorld()->getLOS(otherPtr, ptr))
+            continue;
+        if (!MWBase::Environment::get().getMechanicsManager()->awarenessCheck(otherPtr, ptr))
+            continue;
+
+        timeToCollision = collision.mTime;
+        nearest = &collision;
+    }
+
+    if (timeToCollision >= MWMechanics::maxTimeToPredictCollision)
+        return;
+
+    // Try to evade the nearest collision.
+    const osg::Vec2f origMovement(actor.mMovement.x(), actor.mMovement.y());
+    const bool isMoving = origMovement.length2() > 0.01;
+    osg::Vec2f newMovement = origMovement + nearest->mMovementCorrection;
+    // Step to the side rather than backward. Otherwise player will be able to push the NPC far away from it's original location.
+    newMovement.y() = std::max(newMovement.y(), 0.f);
+    newMovement.normalize();
+    if (isMoving)
+        newMovement *= origMovement.length(); // Keep the original speed.
+    MWMechanics::Movement& movement = ptr.getClass().getMovementSettings(ptr);
+    movement.mPosition[0] = newMovement.x();
+    movement.mPosition[1] = newMovement.y();
+    if (shouldTurnToApproachingActor)
+        MWMechanics::zTurn(ptr, nearest->mAngle);
+}
+
 }
 
 namespace MWMechanics
@@ -436,14 +494,7 @@ namespace MWMechanics
         if (targetActor.getClass().getCreatureStats(targetActor).isDead())
             return;
 
-        static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fMaxHeadTrackDistance")->mValue.getFloat();
-        static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fInteriorHeadTrackMult")->mValue.getFloat();
-        float maxDistance = fMaxHeadTrackDistance;
-        const ESM::Cell* currentCell = actor.getCell()->getCell();
-        if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
-            maxDistance *= fInteriorHeadTrackMult;
+        const float maxDistance = getMaxHeadTrackDistance(actor);
 
         const osg::Vec3f actor1Pos(actor.getRefData().getPosition().asVec3());
         const osg::Vec3f actor2Pos(targetActor.getRefData().getPosition().asVec3());
@@ -1553,7 +1604,11 @@ namespace MWMechanics
         }
     }
 
-    Actors::Actors() : mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
+    Actors::Actors()
+        : mActorsGrid(512.f)
+        , mActorsGridDirty(true)
+        , mTaskScheduler(std::make_unique<TaskScheduler>(Settings::Manager::getInt("collision prediction threads", "Game")))
+        , mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
     {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
 
@@ -1590,6 +1645,7 @@ namespace MWMechanics
         if (!anim)
             return;
         mActors.insert(std::make_pair(ptr, new Actor(ptr, anim)));
+        mActorsGridDirty = true;
 
         CharacterController* ctrl = mActors[ptr]->getCharacterController();
         if (updateImmediately)
@@ -1639,6 +1695,7 @@ namespace MWMechanics
         {
             delete iter->second;
             mActors.erase(iter);
+            mActorsGridDirty = true;
         }
     }
 
@@ -1691,9 +1748,16 @@ namespace MWMechanics
 
             actor->updatePtr(ptr);
             mActors.insert(std::make_pair(ptr, actor));
+            mActorsGridDirty = true;
         }
     }
 
+    void Actors::updateActorPosition(const MWWorld::Ptr& ptr)
+    {
+        if (mActors.find(ptr) != mActors.end())
+            mActorsGridDirty = true;
+    }
+
     void Actors::dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore)
     {
         PtrActorMap::iterator iter = mActors.begin();
@@ -1703,6 +1767,7 @@ namespace MWMechanics
             {
                 delete iter->second;
                 mActors.erase(iter++);
+                mActorsGridDirty = true;
             }
             else
                 ++iter;
@@ -1718,19 +1783,17 @@ namespace MWMechanics
 
         if (aiActive)
         {
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            std::vector<MWWorld::Ptr> neighbors;
+            getActorsInRange(playerPos, mActorsProcessingRange, neighbors);
+            for (const MWWorld::Ptr& neighbor : neighbors)
             {
-                if (iter->first == player) continue;
+                if (neighbor == player) continue;
 
-                bool inProcessingRange = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
-                if (inProcessingRange)
+                MWMechanics::CreatureStats& stats = neighbor.getClass().getCreatureStats(neighbor);
+                if (!stats.isDead() && stats.getAiSequence().isInCombat())
                 {
-                    MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-                    if (!stats.isDead() && stats.getAiSequence().isInCombat())
-                    {
-                        hasHostiles = true;
-                        break;
-                    }
+                    hasHostiles = true;
+                    break;
                 }
             }
         }
@@ -1757,137 +1820,106 @@ namespace MWMechanics
         if (!MWBase::Environment::get().getMechanicsManager()->isAIActive())
             return;
 
-        const float minGap = 10.f;
-        const float maxDistForPartialAvoiding = 200.f;
-        const float maxDistForStrictAvoiding = 100.f;
-        const float maxTimeToCheck = 2.0f;
         static const bool giveWayWhenIdle = Settings::Manager::getBool("NPCs give way", "Game");
 
         MWWorld::Ptr player = getPlayer();
         MWBase::World* world = MWBase::Environment::get().getWorld();
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
-        {
-            const MWWorld::Ptr& ptr = iter->first;
-            if (ptr == player)
-                continue; // Don't interfere with player controls.
 
-            float maxSpeed = ptr.getClass().getMaxSpeed(ptr);
-            if (maxSpeed == 0.0)
-                continue; // Can't move, so there is no sense to predict collisions.
-
-            Movement& movement = ptr.getClass().getMovementSettings(ptr);
-            osg::Vec2f origMovement(movement.mPosition[0], movement.mPosition[1]);
-            bool isMoving = origMovement.length2() > 0.01;
-            if (movement.mPosition[1] < 0)
-                continue; // Actors can not see others when move backward.
+        // Class methods and AI packages may update caches, so everything the prediction needs is gathered first.
+        // Actors are ordered the same way as mActors, so indices of neighbors can be found by binary search.
+        std::vector<MWWorld::Ptr> ptrs;
+        std::vector<CollisionPredictionActor> actors;
+        std::vector<MWWorld::Ptr> currentTargets;
+        std::vector<bool> shouldTurnToApproachingActor;
+        ptrs.reserve(mActors.size());
+        actors.reserve(mActors.size());
+        currentTargets.reserve(mActors.size());
+        shouldTurnToApproachingActor.reserve(mActors.size());
+        for (const auto& actor : mActors)
+        {
+            const MWWorld::Ptr& ptr = actor.first;
+
+            CollisionPredictionActor data;
+            data.mPosition = ptr.getRefData().getPosition().asVec3();
+            data.mRotZ = ptr.getRefData().getPosition().rot[2];
+            data.mHalfExtents = world->getHalfExtents(ptr);
+            data.mMovement = ptr.getClass().getMovementSettings(ptr).asVec3();
+            data.mMaxSpeed = ptr.getClass().getMaxSpeed(ptr);
+            data.mIsDead = ptr.getClass().getCreatureStats(ptr).isDead();
+
+            const bool isMoving = osg::Vec2f(data.mMovement.x(), data.mMovement.y()).length2() > 0.01;
 
             // Moving NPCs always should avoid collisions.
             // Standing NPCs give way to moving ones if they are not in combat (or pursue) mode and either
             // follow player or have a AIWander package with non-empty wander area.
-            bool shouldAvoidCollision = isMoving;
-            bool shouldTurnToApproachingActor = !isMoving;
+            data.mShouldAvoidCollision = isMoving;
+            bool shouldTurn = !isMoving;
             MWWorld::Ptr currentTarget; // Combat or pursue target (NPCs should not avoid collision with their targets).
-            for (const auto& package : ptr.getClass().getCreatureStats(ptr).getAiSequence())
+
+            // Don't interfere with player controls.
+            // Can't move, so there is no sense to predict collisions.
+            // Actors can not see others when move backward.
+            if (ptr != player && data.mMaxSpeed != 0 && data.mMovement.y() >= 0)
             {
-                if (package->getTypeId() == AiPackageTypeId::Follow)
-                    shouldAvoidCollision = true;
-                else if (package->getTypeId() == AiPackageTypeId::Wander && giveWayWhenIdle)
-                {
-                    if (!static_cast<const AiWander*>(package.get())->isStationary())
-                        shouldAvoidCollision = true;
-                }
-                else if (package->getTypeId() == AiPackageTypeId::Combat || package->getTypeId() == AiPackageTypeId::Pursue)
+                for (const auto& package : ptr.getClass().getCreatureStats(ptr).getAiSequence())
                 {
-                    currentTarget = package->getTarget();
-                    shouldAvoidCollision = isMoving;
-                    shouldTurnToApproachingActor = false;
-                    break;
+                    if (package->getTypeId() == AiPackageTypeId::Follow)
+                        data.mShouldAvoidCollision = true;
+                    else if (package->getTypeId() == AiPackageTypeId::Wander && giveWayWhenIdle)
+                    {
+                        if (!static_cast<const AiWander*>(package.get())->isStationary())
+                            data.mShouldAvoidCollision = true;
+                    }
+                    else if (package->getTypeId() == AiPackageTypeId::Combat || package->getTypeId() == AiPackageTypeId::Pursue)
+                    {
+                        currentTarget = package->getTarget();
+                        data.mShouldAvoidCollision = isMoving;
+                        shouldTurn = false;
+                        break;
+                    }
                 }
             }
-            if (!shouldAvoidCollision)
-                continue;
-
-            osg::Vec2f baseSpeed = origMovement * maxSpeed;
-            osg::Vec3f basePos = ptr.getRefData().getPosition().asVec3();
-            float baseRotZ = ptr.getRefData().getPosition().rot[2];
-            osg::Vec3f halfExtents = world->getHalfExtents(ptr);
-            float maxDistToCheck = isMoving ? maxDistForPartialAvoiding : maxDistForStrictAvoiding;
-
-            float timeToCollision = maxTimeToCheck;
-            osg::Vec2f movementCorrection(0, 0);
-            float angleToApproachingActor = 0;
-
-            // Iterate through all other actors and predict collisions.
-            for(PtrActorMap::iterator otherIter(mActors.begin()); otherIter != mActors.end(); ++otherIter)
-            {
-                const MWWorld::Ptr& otherPtr = otherIter->first;
-                if (otherPtr == ptr || otherPtr == currentTarget)
-                    continue;
-
-                osg::Vec3f otherHalfExtents = world->getHalfExtents(otherPtr);
-                osg::Vec3f deltaPos = otherPtr.getRefData().getPosition().asVec3() - basePos;
-                osg::Vec2f relPos = Misc::rotateVec2f(osg::Vec2f(deltaPos.x(), deltaPos.y()), baseRotZ);
-                float dist = deltaPos.length();
-
-                // Ignore actors which are not close enough or come from behind.
-                if (dist > maxDistToCheck || relPos.y() < 0)
-                    continue;
-
-                // Don't check for a collision if vertical distance is greater then the actor's height.
-                if (deltaPos.z() > halfExtents.z() * 2 || deltaPos.z() < -otherHalfExtents.z() * 2)
-                    continue;
-
-                osg::Vec3f speed = otherPtr.getClass().getMovementSettings(otherPtr).asVec3() *
-                                   otherPtr.getClass().getMaxSpeed(otherPtr);
-                float rotZ = otherPtr.getRefData().getPosition().rot[2];
-                osg::Vec2f relSpeed = Misc::rotateVec2f(osg::Vec2f(speed.x(), speed.y()), baseRotZ - rotZ) - baseSpeed;
-
-                float collisionDist = minGap + world->getHalfExtents(ptr).x() + world->getHalfExtents(otherPtr).x();
-                collisionDist = std::min(collisionDist, relPos.length());
-
-                // Find the earliest `t` when |relPos + relSpeed * t| == collisionDist.
-                float vr = relPos.x() * relSpeed.x() + relPos.y() * relSpeed.y();
-                float v2 = relSpeed.length2();
-                float Dh = vr * vr - v2 * (relPos.length2() - collisionDist * collisionDist);
-                if (Dh <= 0 || v2 == 0)
-                    continue; // No solution; distance is always >= collisionDist.
-                float t = (-vr - std::sqrt(Dh)) / v2;
+            else
+                data.mShouldAvoidCollision = false;
 
-                if (t < 0 || t > timeToCollision)
-                    continue;
+            ptrs.push_back(ptr);
+            actors.push_back(data);
+            currentTargets.push_back(currentTarget);
+            shouldTurnToApproachingActor.push_back(shouldTurn);
+        }
 
-                // Check visibility and awareness last as it's expensive.
-                if (!MWBase::Environment::get().getWorld()->getLOS(otherPtr, ptr))
-                    continue;
-                if (!MWBase::Environment::get().getMechanicsManager()->awarenessCheck(otherPtr, ptr))
-                    continue;
+        const auto findIndex = [&] (const MWWorld::Ptr& ptr)
+        {
+            const auto it = std::lower_bound(ptrs.begin(), ptrs.end(), ptr);
+            if (it == ptrs.end() || *it != ptr)
+                return std::numeric_limits<std::size_t>::max();
+            return static_cast<std::size_t>(it - ptrs.begin());
+        };
 
-                timeToCollision = t;
-                angleToApproachingActor = std::atan2(deltaPos.x(), deltaPos.y());
-                osg::Vec2f posAtT = relPos + relSpeed * t;
-                float coef = (posAtT.x() * relSpeed.x() + posAtT.y() * relSpeed.y()) / (collisionDist * collisionDist * maxSpeed);
-                coef *= osg::clampBetween((maxDistForPartialAvoiding - dist) / (maxDistForPartialAvoiding - maxDistForStrictAvoiding), 0.f, 1.f);
-                movementCorrection = posAtT * coef;
-                if (otherPtr.getClass().getCreatureStats(otherPtr).isDead())
-                    // In case of dead body still try to go around (it looks natural), but reduce the correction twice.
-                    movementCorrection.y() *= 0.5f;
-            }
+        for (std::size_t i = 0; i < actors.size(); ++i)
+            if (!currentTargets[i].isEmpty())
+                actors[i].mCurrentTarget = findIndex(currentTargets[i]);
 
-            if (timeToCollision < maxTimeToCheck)
+        // All actors predict collisions using movement from before any collision is avoided in this frame,
+        // so the result is the same for any number of threads.
+        updateActorsGrid();
+        const auto collisions = predictCollisions(actors,
+            [&] (const osg::Vec3f& position, float radius, std::vector<std::size_t>& out)
             {
-                // Try to evade the nearest collision.
-                osg::Vec2f newMovement = origMovement + movementCorrection;
-                // Step to the side rather than backward. Otherwise player will be able to push the NPC far away from it's original location.
-                newMovement.y() = std::max(newMovement.y(), 0.f);
-                newMovement.normalize();
-                if (isMoving)
-                    newMovement *= origMovement.length(); // Keep the original speed.
-                movement.mPosition[0] = newMovement.x();
-                movement.mPosition[1] = newMovement.y();
-                if (shouldTurnToApproachingActor)
-                    zTurn(ptr, angleToApproachingActor);
-            }
-        }
+                std::vector<MWWorld::Ptr> neighbors;
+                findActorsInRange(position, radius, neighbors);
+                for (const MWWorld::Ptr& neighbor : neighbors)
+                {
+                    const std::size_t index = findIndex(neighbor);
+                    if (index < ptrs.size())
+                        out.push_back(index);
+                }
+            },
+            *mTaskScheduler);
+
+        // Changes are applied in the main thread in the same order as actors are updated.
+        for (std::size_t i = 0; i < actors.size(); ++i)
+            avoidCollision(ptrs[i], actors[i], shouldTurnToApproachingActor[i], ptrs, collisions[i]);
     }
 
     void Actors::update (float duration, bool paused)
@@ -1929,6 +1961,8 @@ namespace MWMechanics
             }
             bool godmode = MWBase::Environment::get().getWorld()->getGodModeState();
 
+            std::vector<MWWorld::Ptr> neighbors;
+
              // AI and magic effects update
             for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
@@ -1984,14 +2018,19 @@ namespace MWMechanics
                     {
                         if (timerUpdateAITargets == 0)
                         {
-                            if (!isPlayer)
+                            if (!isPlayer) // player is not AI-controlled
+                            {
                                 adjustCommandedActor(iter->first);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
-                            {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                // Combat can't be engaged with actors outside of processing range
+                                neighbors.clear();
+                                getActorsInRange(iter->first.getRefData().getPosition().asVec3(), mActorsProcessingRange, neighbors);
+                                for (const MWWorld::Ptr& neighbor : neighbors)
+                                {
+                                    if (neighbor == iter->first)
+                                        continue;
+                                    engageCombat(iter->first, neighbor, cachedAllies, neighbor == player);
+                                }
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -2008,11 +2047,14 @@ namespace MWMechanics
                             // 3. Player character does not use headtracking in the 1st-person view
                             if (!stats.getKnockedDown() && !firstPersonPlayer && !inCombatOrPursue)
                             {
-                                for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                neighbors.clear();
+                                getActorsInRange(iter->first.getRefData().getPosition().asVec3(),
+                                                 getMaxHeadTrackDistance(iter->first), neighbors);
+                                for (const MWWorld::Ptr& neighbor : neighbors)
                                 {
-                                    if (it->first == iter->first)
+                                    if (neighbor == iter->first)
                                         continue;
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
+                                    updateHeadTracking(iter->first, neighbor, headTrackTarget, sqrHeadTrackDistance);
                                 }
                             }
 
@@ -2476,22 +2518,52 @@ namespace MWMechanics
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
-        }
+        getActorsInRange(position, radius, out);
     }
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        updateActorsGrid();
+
+        bool result = false;
+        mActorsGrid.forEachCandidate(position, radius, [&] (const MWWorld::Ptr& ptr)
         {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                return true;
-        }
+            if (!result && (ptr.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
+                result = true;
+        });
 
-        return false;
+        return result;
+    }
+
+    void Actors::updateActorsGrid()
+    {
+        if (!mActorsGridDirty)
+            return;
+
+        mActorsGrid.clear();
+        for (const auto& actor : mActors)
+            mActorsGrid.add(actor.first, actor.first.getRefData().getPosition().asVec3());
+        mActorsGrid.build();
+
+        mActorsGridDirty = false;
+    }
+
+    void Actors::getActorsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
+    {
+        updateActorsGrid();
+        findActorsInRange(position, radius, out);
+    }
+
+    void Actors::findActorsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out) const
+    {
+        const std::size_t initialSize = out.size();
+        mActorsGrid.forEachCandidate(position, radius, [&] (const MWWorld::Ptr& ptr)
+        {
+            if ((ptr.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
+                out.push_back(ptr);
+        });
+
+        std::sort(out.begin() + initialSize, out.end());
     }
 
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
@@ -2697,6 +2769,7 @@ namespace MWMechanics
             it->second = nullptr;
         }
         mActors.clear();
+        mActorsGridDirty = true;
         mDeathCount.clear();
     }
 
@@ -6,9 +6,12 @@
 #include <string>
 #include <list>
 #include <map>
+#include <memory>
 
 #include "../mwmechanics/actorutil.hpp"
 
+#include "actorsgrid.hpp"
+
 namespace ESM
 {
     class ESMReader;
@@ -36,6 +39,7 @@ namespace MWMechanics
     class Actor;
     class CharacterController;
     class CreatureStats;
+    class TaskScheduler;
 
     class Actors
     {
@@ -106,6 +110,9 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updateActorPosition(const MWWorld::Ptr& ptr);
+            ///< Must be called when an actor is moved so range queries see its new position
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -209,7 +216,19 @@ namespace MWMechanics
         void updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl);
         void applyCureEffects (const MWWorld::Ptr& actor);
 
+        void updateActorsGrid();
+        ///< Rebuild actors grid if registered actors or their positions changed
+
+        void getActorsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out);
+        ///< Append actors within \a radius of \a position ordered the same way as mActors
+
+        void findActorsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out) const;
+        ///< Same as getActorsInRange but requires actors grid to be up to date
+
         PtrActorMap mActors;
+        ActorsGrid mActorsGrid;
+        bool mActorsGridDirty;
+        std::unique_ptr<TaskScheduler> mTaskScheduler;
         float mTimerDisposeSummonsCorpses;
         float mActorsProcessingRange;
 
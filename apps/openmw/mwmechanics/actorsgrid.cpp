@@ -0,0 +1,49 @@
+#include "actorsgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace MWMechanics
+{
+    ActorsGrid::ActorsGrid(float cellSize)
+        : mCellSize(cellSize)
+    {
+    }
+
+    void ActorsGrid::clear()
+    {
+        mEntries.clear();
+        mCells.clear();
+    }
+
+    void ActorsGrid::add(const MWWorld::Ptr& ptr, const osg::Vec3f& position)
+    {
+        mEntries.push_back(Entry {makeCellKey(getCellIndex(position.x()), getCellIndex(position.y())), ptr});
+    }
+
+    void ActorsGrid::build()
+    {
+        // Keep insertion order inside each cell to make iteration order deterministic
+        std::stable_sort(mEntries.begin(), mEntries.end(),
+            [] (const Entry& lhs, const Entry& rhs) { return lhs.mCell < rhs.mCell; });
+
+        mCells.clear();
+        std::size_t begin = 0;
+        for (std::size_t i = 1; i <= mEntries.size(); ++i)
+        {
+            if (i == mEntries.size() || mEntries[i].mCell != mEntries[begin].mCell)
+            {
+                mCells.emplace(mEntries[begin].mCell, std::make_pair(begin, i));
+                begin = i;
+            }
+        }
+    }
+
+    int ActorsGrid::getCellIndex(float value) const
+    {
+        const float index = std::floor(value / mCellSize);
+        const float limit = static_cast<float>(std::numeric_limits<int>::max() / 2);
+        return static_cast<int>(std::max(-limit, std::min(limit, index)));
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef GAME_MWMECHANICS_ACTORSGRID_H
+#define GAME_MWMECHANICS_ACTORSGRID_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <osg/Vec3f>
+
+#include "../mwworld/ptr.hpp"
+
+namespace MWMechanics
+{
+    /// \brief Uniform grid over actor positions in XY plane to find actors near a point
+    /// without checking every registered actor.
+    ///
+    /// Stores positions actors had when they were added, so queries return candidates. Callers
+    /// are expected to check the actual distance.
+    class ActorsGrid
+    {
+        public:
+            explicit ActorsGrid(float cellSize);
+
+            void clear();
+
+            void add(const MWWorld::Ptr& ptr, const osg::Vec3f& position);
+
+            /// Must be called after adding actors and before any query
+            void build();
+
+            std::size_t size() const { return mEntries.size(); }
+
+            /// Call \a function for each actor stored in grid cells intersecting the square
+            /// with center at \a position and half size \a radius.
+            template <class Function>
+            void forEachCandidate(const osg::Vec3f& position, float radius, Function&& function) const
+            {
+                const int minX = getCellIndex(position.x() - radius);
+                const int maxX = getCellIndex(position.x() + radius);
+                const int minY = getCellIndex(position.y() - radius);
+                const int maxY = getCellIndex(position.y() + radius);
+
+                const auto visit = [&] (const std::pair<std::size_t, std::size_t>& range)
+                {
+                    for (std::size_t i = range.first; i < range.second; ++i)
+                        function(mEntries[i].mPtr);
+                };
+
+                // For large radius it's cheaper to check all non-empty cells
+                const auto cellsInRange = static_cast<std::size_t>(maxX - minX + 1) * static_cast<std::size_t>(maxY - minY + 1);
+                if (cellsInRange > mCells.size())
+                {
+                    for (const auto& cell : mCells)
+                    {
+                        const int x = getCellX(cell.first);
+                        const int y = getCellY(cell.first);
+                        if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+                            visit(cell.second);
+                    }
+                    return;
+                }
+
+                for (int x = minX; x <= maxX; ++x)
+                {
+                    for (int y = minY; y <= maxY; ++y)
+                    {
+                        const auto cell = mCells.find(makeCellKey(x, y));
+                        if (cell != mCells.end())
+                            visit(cell->second);
+                    }
+                }
+            }
+
+        private:
+            struct Entry
+            {
+                std::uint64_t mCell;
+                MWWorld::Ptr mPtr;
+            };
+
+            float mCellSize;
+            std::vector<Entry> mEntries;
+            std::unordered_map<std::uint64_t, std::pair<std::size_t, std::size_t>> mCells;
+
+            int getCellIndex(float value) const;
+
+            static std::uint64_t makeCellKey(int x, int y)
+            {
+                return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+            }
+
+            static int getCellX(std::uint64_t key)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(key >> 32));
+            }
+
+            static int getCellY(std::uint64_t key)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(key));
+            }
+    };
+}
+
+#endif
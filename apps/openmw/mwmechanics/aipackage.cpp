@@ -34,7 +34,8 @@ MWMechanics::AiPackage::AiPackage(AiPackageTypeId typeId, const Options& options
     mRotateOnTheRunChecks(0),
     mIsShortcutting(false),
     mShortcutProhibited(false),
-    mShortcutFailPos()
+    mShortcutFailPos(),
+    mDestInLOS(false)
 {
 }
 
@@ -68,6 +69,7 @@ void MWMechanics::AiPackage::reset()
     mIsShortcutting = false;
     mShortcutProhibited = false;
     mShortcutFailPos = osg::Vec3f();
+    mDestInLOS = false;
 
     mPathFinder.clearPath();
     mObstacleCheck.clear();
@@ -112,29 +114,19 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
 
         if (!mIsShortcutting)
         {
+            mDestInLOS = destInLOS;
+
             if (wasShortcutting || doesPathNeedRecalc(dest, actor)) // if need to rebuild path
             {
                 const auto pathfindingHalfExtents = world->getPathfindingHalfExtents(actor);
-                mPathFinder.buildPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
+                mPathFinder.buildPathAsync(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
                     pathfindingHalfExtents, getNavigatorFlags(actor), getAreaCosts(actor));
                 mRotateOnTheRunChecks = 3;
 
-                // give priority to go directly on target if there is minimal opportunity
-                if (destInLOS && mPathFinder.getPath().size() > 1)
-                {
-                    // get point just before dest
-                    auto pPointBeforeDest = mPathFinder.getPath().rbegin() + 1;
-
-                    // if start point is closer to the target then last point of path (excluding target itself) then go straight on the target
-                    if (distance(position, dest) <= distance(dest, *pPointBeforeDest))
-                    {
-                        mPathFinder.clearPath();
-                        mPathFinder.addPointToPath(dest);
-                    }
-                }
+                if (!mPathFinder.isPathPending())
+                    onPathBuilt(position, dest);
             }
-
-            if (!mPathFinder.getPath().empty()) //Path has points in it
+            else if (!mPathFinder.isPathPending() && !mPathFinder.getPath().empty()) //Path has points in it
             {
                 const osg::Vec3f& lastPos = mPathFinder.getPath().back(); //Get the end of the proposed path
 
@@ -146,6 +138,19 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
         mTimer = 0;
     }
 
+    // Path is found by navigator in background, actor follows the previous path meanwhile
+    if (mPathFinder.isPathPending())
+    {
+        if (mPathFinder.updatePendingPath(actor, getPathGridGraph(mPathFinder.getPendingPathCell())))
+            onPathBuilt(position, dest);
+        else if (!isDestReached && mPathFinder.getPath().empty())
+        {
+            actor.getClass().getMovementSettings(actor).mPosition[0] = 0;
+            actor.getClass().getMovementSettings(actor).mPosition[1] = 0;
+            return false;
+        }
+    }
+
     const float actorTolerance = 2 * actor.getClass().getMaxSpeed(actor) * duration
             + 1.2 * std::max(halfExtents.x(), halfExtents.y());
     const float pointTolerance = std::max(MIN_TOLERANCE, actorTolerance);
@@ -352,8 +357,37 @@ bool MWMechanics::AiPackage::checkWayIsClearForActor(const osg::Vec3f& startPoin
     return false;
 }
 
+void MWMechanics::AiPackage::onPathBuilt(const osg::Vec3f& position, const osg::Vec3f& dest)
+{
+    // give priority to go directly on target if there is minimal opportunity
+    if (mDestInLOS && mPathFinder.getPath().size() > 1)
+    {
+        // get point just before dest
+        auto pPointBeforeDest = mPathFinder.getPath().rbegin() + 1;
+
+        // if start point is closer to the target then last point of path (excluding target itself) then go straight on the target
+        if (distance(position, dest) <= distance(dest, *pPointBeforeDest))
+        {
+            mPathFinder.clearPath();
+            mPathFinder.addPointToPath(dest);
+        }
+    }
+
+    if (!mPathFinder.getPath().empty()) //Path has points in it
+    {
+        const osg::Vec3f& lastPos = mPathFinder.getPath().back(); //Get the end of the proposed path
+
+        if(distance(dest, lastPos) > 100) //End of the path is far from the destination
+            mPathFinder.addPointToPath(dest); //Adds the final destination to the path, to try to get to where you want to go
+    }
+}
+
 bool MWMechanics::AiPackage::doesPathNeedRecalc(const osg::Vec3f& newDest, const MWWorld::Ptr& actor) const
 {
+    if (mPathFinder.isPathPending())
+        return getPathDistance(actor, mPathFinder.getPendingPathEnd(), newDest) > 10
+            || mPathFinder.getPendingPathCell() != actor.getCell();
+
     return mPathFinder.getPath().empty()
         || getPathDistance(actor, mPathFinder.getPath().back(), newDest) > 10
         || mPathFinder.getPathCell() != actor.getCell();
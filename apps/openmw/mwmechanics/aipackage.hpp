@@ -168,9 +168,13 @@ namespace MWMechanics
             bool mIsShortcutting;   // if shortcutting at the moment
             bool mShortcutProhibited; // shortcutting may be prohibited after unsuccessful attempt
             osg::Vec3f mShortcutFailPos; // position of last shortcut fail
+            bool mDestInLOS; // if destination was in line of sight when path was requested
 
         private:
             bool isNearInactiveCell(osg::Vec3f position);
+
+            /// Adjust just built path to the destination
+            void onPathBuilt(const osg::Vec3f& position, const osg::Vec3f& dest);
     };
 }
 
@@ -0,0 +1,98 @@
+#include "collisionprediction.hpp"
+
+#include <components/misc/mathutil.hpp>
+
+#include <osg/Math>
+
+#include <algorithm>
+#include <cmath>
+
+#include "taskscheduler.hpp"
+
+namespace MWMechanics
+{
+    namespace
+    {
+        const float maxDistForPartialAvoiding = 200.f;
+        const float maxDistForStrictAvoiding = 100.f;
+
+        void predictCollisions(const std::vector<CollisionPredictionActor>& actors, std::size_t index,
+                               const std::vector<std::size_t>& neighbors, std::vector<PredictedCollision>& out)
+        {
+            const float minGap = 10.f;
+
+            const CollisionPredictionActor& actor = actors[index];
+            const osg::Vec2f origMovement(actor.mMovement.x(), actor.mMovement.y());
+            const osg::Vec2f baseSpeed = origMovement * actor.mMaxSpeed;
+            const float maxDistToCheck = getMaxDistToPredictCollision(actor);
+
+            for (const std::size_t otherIndex : neighbors)
+            {
+                if (otherIndex == index || otherIndex == actor.mCurrentTarget)
+                    continue;
+
+                const CollisionPredictionActor& other = actors[otherIndex];
+
+                osg::Vec3f deltaPos = other.mPosition - actor.mPosition;
+                osg::Vec2f relPos = Misc::rotateVec2f(osg::Vec2f(deltaPos.x(), deltaPos.y()), actor.mRotZ);
+                float dist = deltaPos.length();
+
+                // Ignore actors which are not close enough or come from behind.
+                if (dist > maxDistToCheck || relPos.y() < 0)
+                    continue;
+
+                // Don't check for a collision if vertical distance is greater then the actor's height.
+                if (deltaPos.z() > actor.mHalfExtents.z() * 2 || deltaPos.z() < -other.mHalfExtents.z() * 2)
+                    continue;
+
+                osg::Vec3f speed = other.mMovement * other.mMaxSpeed;
+                osg::Vec2f relSpeed = Misc::rotateVec2f(osg::Vec2f(speed.x(), speed.y()), actor.mRotZ - other.mRotZ) - baseSpeed;
+
+                float collisionDist = minGap + actor.mHalfExtents.x() + other.mHalfExtents.x();
+                collisionDist = std::min(collisionDist, relPos.length());
+
+                // Find the earliest `t` when |relPos + relSpeed * t| == collisionDist.
+                float vr = relPos.x() * relSpeed.x() + relPos.y() * relSpeed.y();
+                float v2 = relSpeed.length2();
+                float Dh = vr * vr - v2 * (relPos.length2() - collisionDist * collisionDist);
+                if (Dh <= 0 || v2 == 0)
+                    continue; // No solution; distance is always >= collisionDist.
+                float t = (-vr - std::sqrt(Dh)) / v2;
+
+                if (t < 0 || t > maxTimeToPredictCollision)
+                    continue;
+
+                osg::Vec2f posAtT = relPos + relSpeed * t;
+                float coef = (posAtT.x() * relSpeed.x() + posAtT.y() * relSpeed.y()) / (collisionDist * collisionDist * actor.mMaxSpeed);
+                coef *= osg::clampBetween((maxDistForPartialAvoiding - dist) / (maxDistForPartialAvoiding - maxDistForStrictAvoiding), 0.f, 1.f);
+                osg::Vec2f movementCorrection = posAtT * coef;
+                if (other.mIsDead)
+                    // In case of dead body still try to go around (it looks natural), but reduce the correction twice.
+                    movementCorrection.y() *= 0.5f;
+
+                out.push_back(PredictedCollision {otherIndex, t, std::atan2(deltaPos.x(), deltaPos.y()), movementCorrection});
+            }
+        }
+    }
+
+    float getMaxDistToPredictCollision(const CollisionPredictionActor& actor)
+    {
+        const bool isMoving = osg::Vec2f(actor.mMovement.x(), actor.mMovement.y()).length2() > 0.01;
+        return isMoving ? maxDistForPartialAvoiding : maxDistForStrictAvoiding;
+    }
+
+    std::vector<std::vector<PredictedCollision>> predictCollisions(const std::vector<CollisionPredictionActor>& actors,
+        const FindActorsInRange& findActorsInRange, TaskScheduler& taskScheduler)
+    {
+        std::vector<std::vector<PredictedCollision>> result(actors.size());
+        taskScheduler.run(actors.size(), [&] (std::size_t index)
+        {
+            if (!actors[index].mShouldAvoidCollision)
+                return;
+            std::vector<std::size_t> neighbors;
+            findActorsInRange(actors[index].mPosition, getMaxDistToPredictCollision(actors[index]), neighbors);
+            predictCollisions(actors, index, neighbors, result[index]);
+        });
+        return result;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GAME_MWMECHANICS_COLLISIONPREDICTION_H
+#define GAME_MWMECHANICS_COLLISIONPREDICTION_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <osg/Vec2f>
+#include <osg/Vec3f>
+
+namespace MWMechanics
+{
+    class TaskScheduler;
+
+    /// Collisions are predicted for this time period in seconds
+    constexpr float maxTimeToPredictCollision = 2.0f;
+
+    /// @brief Actor state the collision prediction depends on, gathered before the prediction starts
+    struct CollisionPredictionActor
+    {
+        osg::Vec3f mPosition;
+        float mRotZ = 0;
+        osg::Vec3f mHalfExtents;
+        osg::Vec3f mMovement;
+        float mMaxSpeed = 0;
+        bool mIsDead = false;
+        bool mShouldAvoidCollision = false;
+        /// Index of combat or pursue target, actors don't avoid collisions with their targets
+        std::size_t mCurrentTarget = std::numeric_limits<std::size_t>::max();
+    };
+
+    struct PredictedCollision
+    {
+        std::size_t mOther;
+        float mTime;
+        float mAngle;
+        osg::Vec2f mMovementCorrection;
+    };
+
+    /// Append indices of actors located within radius from position in ascending order
+    using FindActorsInRange = std::function<void (const osg::Vec3f& position, float radius, std::vector<std::size_t>& out)>;
+
+    /// @return distance to actors which are checked for collisions with the actor
+    float getMaxDistToPredictCollision(const CollisionPredictionActor& actor);
+
+    /// @brief Predict collisions of each actor that should avoid collisions with its neighbors.
+    /// Uses only given data, so actors are processed by taskScheduler in parallel and the result doesn't depend on
+    /// the number of threads. findActorsInRange is called from multiple threads.
+    /// @return collisions for each actor in the order of neighbors returned by findActorsInRange
+    std::vector<std::vector<PredictedCollision>> predictCollisions(const std::vector<CollisionPredictionActor>& actors,
+        const FindActorsInRange& findActorsInRange, TaskScheduler& taskScheduler);
+}
+
+#endif
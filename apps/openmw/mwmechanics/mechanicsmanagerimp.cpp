@@ -276,6 +276,12 @@ namespace MWMechanics
             mObjects.updateObject(old, ptr);
     }
 
+    void MechanicsManager::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        if (ptr.getClass().isActor())
+            mActors.updateActorPosition(ptr);
+    }
+
     void MechanicsManager::drop(const MWWorld::CellStore *cellStore)
     {
         mActors.dropActors(cellStore, getPlayer());
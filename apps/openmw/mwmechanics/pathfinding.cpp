@@ -316,6 +316,7 @@ namespace MWMechanics
     void PathFinder::buildStraightPath(const osg::Vec3f& endPoint)
     {
         mPath.clear();
+        mPendingPath = nullptr;
         mPath.push_back(endPoint);
         mConstructed = true;
     }
@@ -324,6 +325,7 @@ namespace MWMechanics
         const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph)
     {
         mPath.clear();
+        mPendingPath = nullptr;
         mCell = cell;
 
         buildPathByPathgridImpl(startPoint, endPoint, pathgridGraph, std::back_inserter(mPath));
@@ -336,6 +338,7 @@ namespace MWMechanics
         const DetourNavigator::AreaCosts& areaCosts)
     {
         mPath.clear();
+        mPendingPath = nullptr;
 
         // If it's not possible to build path over navmesh due to disabled navmesh generation fallback to straight path
         if (!buildPathByNavigatorImpl(actor, startPoint, endPoint, halfExtents, flags, areaCosts, std::back_inserter(mPath)))
@@ -349,6 +352,7 @@ namespace MWMechanics
         const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts)
     {
         mPath.clear();
+        mPendingPath = nullptr;
         mCell = cell;
 
         bool hasNavMesh = false;
@@ -369,6 +373,80 @@ namespace MWMechanics
         mConstructed = true;
     }
 
+    void PathFinder::buildPathAsync(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph,
+        const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts)
+    {
+        if (actor.getClass().isPureWaterCreature(actor) || actor.getClass().isPureFlyingCreature(actor))
+            return buildPath(actor, startPoint, endPoint, cell, pathgridGraph, halfExtents, flags, areaCosts);
+
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        navigator->demandPath(halfExtents, startPoint, endPoint);
+
+        DetourNavigator::PathQuery query;
+        query.mAgentHalfExtents = halfExtents;
+        query.mStepSize = getPathStepSize(actor);
+        query.mStart = startPoint;
+        query.mEnd = endPoint;
+        query.mIncludeFlags = flags;
+        query.mAreaCosts = areaCosts;
+
+        mPendingPath = navigator->submitPathQuery(query);
+        mPendingCell = cell;
+
+        updatePendingPath(actor, pathgridGraph);
+    }
+
+    bool PathFinder::updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph)
+    {
+        if (mPendingPath == nullptr)
+            return false;
+
+        const DetourNavigator::PathQueryResult* const result = mPendingPath->poll();
+        if (result == nullptr)
+            return false;
+
+        const DetourNavigator::PathQuery& query = mPendingPath->getQuery();
+        const bool hasNavMesh = result->mStatus != DetourNavigator::Status::NavMeshNotFound;
+
+        if (hasNavMesh && result->mStatus != DetourNavigator::Status::Success)
+        {
+            Log(Debug::Debug) << "Build path by navigator error: \"" << DetourNavigator::getMessage(result->mStatus)
+                << "\" for \"" << actor.getClass().getName(actor) << "\" (" << actor.getBase()
+                << ") from " << query.mStart << " to " << query.mEnd << " with flags ("
+                << DetourNavigator::WriteFlags {query.mIncludeFlags} << ")";
+        }
+
+        if (hasNavMesh && result->mPath.empty() && !(query.mIncludeFlags & DetourNavigator::Flag_usePathgrid))
+        {
+            DetourNavigator::PathQuery withPathgrid = query;
+            withPathgrid.mIncludeFlags = query.mIncludeFlags | DetourNavigator::Flag_usePathgrid;
+            mPendingPath = MWBase::Environment::get().getWorld()->getNavigator()->submitPathQuery(withPathgrid);
+            return updatePendingPath(actor, pathgridGraph);
+        }
+
+        mPath.assign(result->mPath.begin(), result->mPath.end());
+        mCell = mPendingCell;
+
+        if (mPath.empty())
+            buildPathByPathgridImpl(query.mStart, query.mEnd, pathgridGraph, std::back_inserter(mPath));
+
+        if (!hasNavMesh && mPath.empty())
+            mPath.push_back(query.mEnd);
+
+        mConstructed = true;
+        mPendingPath = nullptr;
+        mPendingCell = nullptr;
+
+        return true;
+    }
+
+    const osg::Vec3f& PathFinder::getPendingPathEnd() const
+    {
+        assert(mPendingPath != nullptr);
+        return mPendingPath->getQuery().mEnd;
+    }
+
     bool PathFinder::buildPathByNavigatorImpl(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
         const osg::Vec3f& endPoint, const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, std::back_insert_iterator<std::deque<osg::Vec3f>> out)
@@ -376,6 +454,7 @@ namespace MWMechanics
         const auto world = MWBase::Environment::get().getWorld();
         const auto stepSize = getPathStepSize(actor);
         const auto navigator = world->getNavigator();
+        navigator->demandPath(halfExtents, startPoint, endPoint);
         const auto status = navigator->findPath(halfExtents, stepSize, startPoint, endPoint, flags, areaCosts, out);
 
         if (status == DetourNavigator::Status::NavMeshNotFound)
@@ -405,6 +484,7 @@ namespace MWMechanics
             return;
 
         const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        navigator->demandPath(halfExtents, startPoint, mPath.front());
         std::deque<osg::Vec3f> prePath;
         auto prePathInserter = std::back_inserter(prePath);
         const auto status = navigator->findPath(halfExtents, stepSize, startPoint, mPath.front(), flags, areaCosts,
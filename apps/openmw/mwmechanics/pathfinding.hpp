@@ -4,12 +4,18 @@
 #include <deque>
 #include <cassert>
 #include <iterator>
+#include <memory>
 
 #include <components/detournavigator/flags.hpp>
 #include <components/detournavigator/areatype.hpp>
 #include <components/esm/defs.hpp>
 #include <components/esm/loadpgrd.hpp>
 
+namespace DetourNavigator
+{
+    class PendingPathQuery;
+}
+
 namespace MWWorld
 {
     class CellStore;
@@ -75,6 +81,7 @@ namespace MWMechanics
             PathFinder()
                 : mConstructed(false)
                 , mCell(nullptr)
+                , mPendingCell(nullptr)
             {
             }
 
@@ -83,6 +90,8 @@ namespace MWMechanics
                 mConstructed = false;
                 mPath.clear();
                 mCell = nullptr;
+                mPendingPath = nullptr;
+                mPendingCell = nullptr;
             }
 
             void buildStraightPath(const osg::Vec3f& endPoint);
@@ -98,6 +107,28 @@ namespace MWMechanics
                 const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph, const osg::Vec3f& halfExtents,
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
 
+            /// Same as buildPath but navmesh part is found by background threads of navigator. Current path stays
+            /// until updatePendingPath replaces it. Navigator may process the query right away.
+            void buildPathAsync(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
+                const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph, const osg::Vec3f& halfExtents,
+                const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
+
+            /// Replace current path by the result of buildPathAsync if it's ready
+            /// @return true if path is replaced
+            bool updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph);
+
+            bool isPathPending() const
+            {
+                return mPendingPath != nullptr;
+            }
+
+            const osg::Vec3f& getPendingPathEnd() const;
+
+            const MWWorld::CellStore* getPendingPathCell() const
+            {
+                return mPendingCell;
+            }
+
             void buildPathByNavMeshToNextPoint(const MWWorld::ConstPtr& actor, const osg::Vec3f& halfExtents,
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
 
@@ -200,6 +231,9 @@ namespace MWMechanics
 
             const MWWorld::CellStore* mCell;
 
+            std::shared_ptr<DetourNavigator::PendingPathQuery> mPendingPath;
+            const MWWorld::CellStore* mPendingCell;
+
             void buildPathByPathgridImpl(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
                 const PathgridGraph& pathgridGraph, std::back_insert_iterator<std::deque<osg::Vec3f>> out);
 
@@ -0,0 +1,104 @@
+#include "taskscheduler.hpp"
+
+#include <utility>
+
+namespace MWMechanics
+{
+    TaskScheduler::TaskScheduler(int numThreads)
+        : mJob(nullptr)
+        , mCount(0)
+        , mNextIndex(0)
+        , mGeneration(0)
+        , mBusyThreads(0)
+        , mQuit(false)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            mThreads.emplace_back([&] { worker(); });
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQuit = true;
+        }
+        mHasJob.notify_all();
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    void TaskScheduler::run(std::size_t count, const std::function<void(std::size_t)>& job)
+    {
+        if (count == 0)
+            return;
+
+        if (mThreads.empty() || count == 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                job(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mJob = &job;
+            mCount = count;
+            mNextIndex = 0;
+            mException = nullptr;
+            mBusyThreads = static_cast<int>(mThreads.size());
+            ++mGeneration;
+        }
+        mHasJob.notify_all();
+
+        process();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [&] { return mBusyThreads == 0; });
+        mJob = nullptr;
+
+        if (mException)
+            std::rethrow_exception(std::exchange(mException, nullptr));
+    }
+
+    void TaskScheduler::worker()
+    {
+        int generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mHasJob.wait(lock, [&] { return mQuit || mGeneration != generation; });
+                if (mQuit)
+                    return;
+                generation = mGeneration;
+            }
+
+            process();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mBusyThreads == 0)
+                mDone.notify_all();
+        }
+    }
+
+    void TaskScheduler::process()
+    {
+        while (true)
+        {
+            const std::size_t index = mNextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= mCount)
+                return;
+
+            try
+            {
+                (*mJob)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mException)
+                    mException = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef GAME_MWMECHANICS_TASKSCHEDULER_H
+#define GAME_MWMECHANICS_TASKSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWMechanics
+{
+    /// @brief Run independent per-actor jobs on worker threads and wait for the result
+    /// @note Jobs must not change world state. Side effects should be stored by a job and applied
+    /// by the caller after run() returns.
+    class TaskScheduler
+    {
+        public:
+            /// @param numThreads number of worker threads, with 0 all jobs are executed in the calling thread
+            explicit TaskScheduler(int numThreads);
+            ~TaskScheduler();
+
+            TaskScheduler(const TaskScheduler&) = delete;
+            TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+            /// @brief call job for each index in [0, count) and block until all calls are finished
+            /// Calling thread participates in processing. First exception thrown by any job is rethrown.
+            void run(std::size_t count, const std::function<void(std::size_t)>& job);
+
+            int getNumThreads() const { return static_cast<int>(mThreads.size()); }
+
+        private:
+            void worker();
+            void process();
+
+            const std::function<void(std::size_t)>* mJob;
+            std::size_t mCount;
+            std::atomic<std::size_t> mNextIndex;
+            std::exception_ptr mException;
+            int mGeneration;
+            int mBusyThreads;
+            bool mQuit;
+            std::mutex mMutex;
+            std::condition_variable mHasJob;
+            std::condition_variable mDone;
+            std::vector<std::thread> mThreads;
+    };
+}
+
+#endif
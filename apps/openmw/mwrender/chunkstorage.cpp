@@ -0,0 +1,300 @@
+#include "chunkstorage.hpp"
+
+#include <osg/Drawable>
+#include <osg/Image>
+#include <osg/Node>
+#include <osg/NodeVisitor>
+#include <osg/StateSet>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+
+#include <osgDB/ObjectWrapper>
+#include <osgDB/Options>
+#include <osgDB/Registry>
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/cachefile.hpp>
+#include <components/misc/hash.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/resource/scenemanager.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr std::uint32_t chunkMagic = 'O' << 24 | 'P' << 16 | 'C' << 8 | 'H'; //'OPCH';
+    constexpr std::uint32_t chunkVersion = 2;
+
+    // Saving is less important than building new chunks, drop chunks when the writer can't keep up
+    constexpr unsigned int maxPendingSaves = 64;
+
+    // Remove more than required when the limit is exceeded to not scan the storage on each new chunk
+    constexpr double trimFactor = 0.75;
+
+    bool isOsgObject(const osg::Object& object)
+    {
+        return std::strcmp(object.libraryName(), "osg") == 0;
+    }
+
+    /// @brief Check that scene graph can be written and read back without losing anything that affects rendering
+    class CanSaveVisitor : public osg::NodeVisitor
+    {
+    public:
+        CanSaveVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mResult(true)
+        {
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (!mResult)
+                return;
+
+            if (!isOsgObject(node) || node.getUpdateCallback() || node.getEventCallback() || node.getCullCallback()
+                    || !check(node.getUserDataContainer()) || !check(node.getStateSet()))
+            {
+                mResult = false;
+                return;
+            }
+
+            if (const osg::Drawable* drawable = node.asDrawable())
+            {
+                if (drawable->getDrawCallback() || drawable->getComputeBoundingBoxCallback())
+                {
+                    mResult = false;
+                    return;
+                }
+            }
+
+            traverse(node);
+        }
+
+        bool getResult() const { return mResult; }
+
+    private:
+        bool mResult;
+
+        static bool check(const osg::UserDataContainer* container)
+        {
+            if (!container)
+                return true;
+            for (unsigned int i = 0; i < container->getNumUserObjects(); ++i)
+                if (!isOsgObject(*container->getUserObject(i)))
+                    return false;
+            return true;
+        }
+
+        static bool check(const osg::StateAttribute& attribute)
+        {
+            if (!isOsgObject(attribute) || attribute.getUpdateCallback() || attribute.getEventCallback())
+                return false;
+            // Images are written as names of VFS files
+            if (const osg::Texture* texture = attribute.asTexture())
+            {
+                for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                {
+                    const osg::Image* image = texture->getImage(i);
+                    if (image == nullptr || image->getFileName().empty())
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        static bool check(const osg::StateSet* stateSet)
+        {
+            if (!stateSet)
+                return true;
+            if (stateSet->getUpdateCallback() || stateSet->getEventCallback())
+                return false;
+            for (const auto& attribute : stateSet->getAttributeList())
+                if (!check(*attribute.second.first))
+                    return false;
+            for (const auto& unit : stateSet->getTextureAttributeList())
+                for (const auto& attribute : unit)
+                    if (!check(*attribute.second.first))
+                        return false;
+            for (const auto& uniform : stateSet->getUniformList())
+                if (uniform.second.first->getUpdateCallback() || uniform.second.first->getEventCallback())
+                    return false;
+            return true;
+        }
+    };
+
+    /// SceneUtil::registerSerializers replaces osg::Geometry wrapper by one that doesn't write vertex data
+    bool canSerializeGeometry()
+    {
+        osgDB::ObjectWrapper* wrapper = osgDB::Registry::instance()->getObjectWrapperManager()->findWrapper("osg::Geometry");
+        return wrapper != nullptr && wrapper->getSerializer("PrimitiveSetList") != nullptr;
+    }
+
+    /// @brief Callback to read image files referenced by stored chunks from the VFS.
+    class ImageReadCallback : public osgDB::ReadFileCallback
+    {
+    public:
+        ImageReadCallback(Resource::ImageManager* imageManager)
+            : mImageManager(imageManager)
+        {
+        }
+
+        osgDB::ReaderWriter::ReadResult readImage(const std::string& filename, const osgDB::Options* options) override
+        {
+            try
+            {
+                return osgDB::ReaderWriter::ReadResult(mImageManager->getImage(filename), osgDB::ReaderWriter::ReadResult::FILE_LOADED);
+            }
+            catch (std::exception& e)
+            {
+                return osgDB::ReaderWriter::ReadResult(e.what());
+            }
+        }
+
+    private:
+        Resource::ImageManager* mImageManager;
+    };
+
+    osgDB::ReaderWriter* getReaderWriter()
+    {
+        osgDB::ReaderWriter* readerWriter = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!readerWriter)
+            throw std::runtime_error("no readerwriter for 'osgb' found");
+        return readerWriter;
+    }
+}
+
+namespace MWRender
+{
+    class ChunkStorage::SaveChunkWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        SaveChunkWorkItem(ChunkStorage& storage, boost::filesystem::path&& path, std::vector<unsigned char>&& key,
+                osg::ref_ptr<osg::Node>&& node)
+            : mStorage(storage)
+            , mPath(std::move(path))
+            , mKey(std::move(key))
+            , mNode(std::move(node))
+        {
+        }
+
+        void doWork() override
+        {
+            mStorage.write(mPath, mKey, *mNode);
+        }
+
+    private:
+        ChunkStorage& mStorage;
+        const boost::filesystem::path mPath;
+        const std::vector<unsigned char> mKey;
+        const osg::ref_ptr<osg::Node> mNode;
+    };
+
+    ChunkStorage::ChunkStorage(Resource::SceneManager* sceneManager, const std::string& path,
+            std::string_view environment, std::uintmax_t maxSize)
+        : mSceneManager(sceneManager)
+        , mRootPath(path)
+        , mPath(mRootPath / Files::toHex(Misc::fnv1aHash(environment)))
+        , mMaxSize(maxSize)
+        , mWorkQueue(new SceneUtil::WorkQueue(1))
+    {
+        Log(Debug::Info) << "Using object paging chunk storage at " << mPath;
+    }
+
+    ChunkStorage::~ChunkStorage() = default;
+
+    osg::ref_ptr<osg::Node> ChunkStorage::load(const osg::Vec2f& center, float size, const std::vector<unsigned char>& key) const
+    {
+        const auto path = getChunkPath(center, size, key);
+
+        try
+        {
+            boost::filesystem::ifstream file;
+            if (!Files::openCacheFile(file, path, chunkMagic, chunkVersion, Files::toStringView(key)))
+                return nullptr;
+
+            const std::string data = Files::readString(file);
+
+            osg::ref_ptr<osgDB::Options> options(new osgDB::Options);
+            options->setReadFileCallback(new ImageReadCallback(mSceneManager->getImageManager()));
+
+            std::istringstream stream(data);
+            osgDB::ReaderWriter::ReadResult result = getReaderWriter()->readNode(stream, options);
+            if (!result.success())
+                throw std::runtime_error(result.message());
+
+            osg::ref_ptr<osg::Node> node = result.getNode();
+            if (!node)
+                return nullptr;
+
+            Files::touchCacheFile(path);
+
+            // Stored shader programs are not shared with the ShaderManager and might be outdated
+            mSceneManager->recreateShaders(node);
+            mSceneManager->shareState(node);
+
+            return node;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to load object paging chunk from " << path << ": " << e.what();
+            return nullptr;
+        }
+    }
+
+    osg::ref_ptr<SceneUtil::WorkItem> ChunkStorage::save(const osg::Vec2f& center, float size,
+        std::vector<unsigned char>&& key, osg::ref_ptr<osg::Node> node)
+    {
+        if (!canSerializeGeometry() || mWorkQueue->getNumItems() >= maxPendingSaves)
+            return nullptr;
+
+        auto path = getChunkPath(center, size, key);
+        osg::ref_ptr<SceneUtil::WorkItem> item(new SaveChunkWorkItem(*this, std::move(path), std::move(key), std::move(node)));
+        mWorkQueue->addWorkItem(item, SceneUtil::WorkQueue::Priority::Low);
+        return item;
+    }
+
+    boost::filesystem::path ChunkStorage::getChunkPath(const osg::Vec2f& center, float size, const std::vector<unsigned char>& key) const
+    {
+        const auto hash = Misc::fnv1aHash(key.data(), key.size());
+        std::ostringstream name;
+        name << center.x() << "_" << center.y() << "_" << size << "_" << Files::toHex(hash) << ".chunk";
+        return mPath / name.str();
+    }
+
+    void ChunkStorage::write(const boost::filesystem::path& path, const std::vector<unsigned char>& key, osg::Node& node)
+    {
+        CanSaveVisitor canSaveVisitor;
+        node.accept(canSaveVisitor);
+        if (!canSaveVisitor.getResult())
+            return;
+
+        try
+        {
+            osg::ref_ptr<osgDB::Options> options(new osgDB::Options);
+            options->setPluginStringData("WriteImageHint", "UseExternal");
+
+            std::ostringstream stream;
+            osgDB::ReaderWriter::WriteResult result = getReaderWriter()->writeNode(node, stream, options);
+            if (!result.success())
+                throw std::runtime_error(result.message());
+            const std::string data = stream.str();
+
+            if (!mSize)
+                mSize = Files::trimCache(mRootPath, mMaxSize);
+
+            *mSize += Files::writeCacheFile(path, chunkMagic, chunkVersion, Files::toStringView(key),
+                [&] (std::ostream& file) { Files::writeString(file, data); });
+
+            if (*mSize > mMaxSize)
+                mSize = Files::trimCache(mRootPath, static_cast<std::uintmax_t>(mMaxSize * trimFactor));
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to save object paging chunk to " << path << ": " << e.what();
+        }
+    }
+}
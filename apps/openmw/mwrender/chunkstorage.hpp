@@ -0,0 +1,74 @@
+#ifndef OPENMW_MWRENDER_CHUNKSTORAGE_H
+#define OPENMW_MWRENDER_CHUNKSTORAGE_H
+
+#include <osg/ref_ptr>
+#include <osg/Vec2f>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace Resource
+{
+    class SceneManager;
+}
+
+namespace SceneUtil
+{
+    class WorkItem;
+    class WorkQueue;
+}
+
+namespace MWRender
+{
+    /// @brief Persistent storage for object paging chunks.
+    /// Chunks are stored one per file in .osgb format and identified by a key describing the instances a chunk was
+    /// built from, so a chunk with the same content can be loaded instead of merging its geometry again.
+    /// Chunks built in a different environment (content files, data directories, shader settings) are stored in
+    /// separate directories. Images are stored as references to VFS files and loaded with the ImageManager.
+    class ChunkStorage
+    {
+    public:
+        /// @param environment description of everything chunks depend on besides their keys
+        /// @param maxSize max total size of stored chunks in bytes
+        ChunkStorage(Resource::SceneManager* sceneManager, const std::string& path, std::string_view environment,
+            std::uintmax_t maxSize);
+        ~ChunkStorage();
+
+        /// @return stored chunk or nullptr when there is no chunk for given key
+        osg::ref_ptr<osg::Node> load(const osg::Vec2f& center, float size, const std::vector<unsigned char>& key) const;
+
+        /// @brief Queue the chunk to be written by a background thread.
+        /// The node must not be modified after this call.
+        /// @return queued work item or nullptr when the chunk is not going to be saved
+        /// @note Chunks containing objects that can't be restored from .osgb format (e.g. nodes with callbacks) are not saved.
+        osg::ref_ptr<SceneUtil::WorkItem> save(const osg::Vec2f& center, float size, std::vector<unsigned char>&& key,
+            osg::ref_ptr<osg::Node> node);
+
+    private:
+        class SaveChunkWorkItem;
+
+        Resource::SceneManager* mSceneManager;
+        const boost::filesystem::path mRootPath;
+        const boost::filesystem::path mPath;
+        const std::uintmax_t mMaxSize;
+        // Used only by the work queue thread, unknown until the first chunk is written
+        std::optional<std::uintmax_t> mSize;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        boost::filesystem::path getChunkPath(const osg::Vec2f& center, float size, const std::vector<unsigned char>& key) const;
+
+        void write(const boost::filesystem::path& path, const std::vector<unsigned char>& key, osg::Node& node);
+    };
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "objectpaging.hpp"
 
+#include <algorithm>
+#include <sstream>
 #include <unordered_map>
 
 #include <osg/Version>
@@ -9,7 +11,10 @@
 #include <osg/Material>
 #include <osgUtil/IncrementalCompileOperation>
 
+#include <components/debug/debuglog.hpp>
 #include <components/esm/esmreader.hpp>
+#include <components/files/cachefile.hpp>
+#include <components/misc/hash.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/sceneutil/optimizer.hpp>
@@ -31,6 +36,7 @@
 #include "apps/openmw/mwbase/world.hpp"
 
 #include "vismask.hpp"
+#include "chunkstorage.hpp"
 
 namespace MWRender
 {
@@ -68,6 +74,24 @@ namespace MWRender
         }
     }
 
+    /// Stored chunks depend on which files are present in data directories and which content files are loaded,
+    /// contents of the models are covered by chunk keys. Shader settings affect state sets made by the SceneManager.
+    std::string makeChunkStorageEnvironment(const VFS::Manager& vfs, const std::vector<std::string>& contentFiles)
+    {
+        std::ostringstream stream;
+        for (const std::string& file : contentFiles)
+            Files::writeFileStamp(stream, file);
+        Misc::Fnv1aHash vfsHash;
+        for (const auto& file : vfs.getIndex())
+            vfsHash.add(file.first).addValue('\0');
+        Files::writeValue(stream, vfsHash.getValue());
+        for (const char* setting : {"force shaders", "force per pixel lighting", "clamp lighting",
+                "auto use object normal maps", "auto use object specular maps", "normal map pattern",
+                "normal height map pattern", "specular map pattern", "apply lighting to environment maps", "radial fog"})
+            Files::writeString(stream, Settings::Manager::getString(setting, "Shaders"));
+        return stream.str();
+    }
+
     osg::ref_ptr<osg::Node> ObjectPaging::getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
     {
         if (activeGrid && !mActiveGrid)
@@ -359,7 +383,8 @@ namespace MWRender
         }
     };
 
-    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
+    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager, const std::string& chunkStoragePath,
+                               const std::vector<std::string>& contentFiles)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
          , mRefTrackerLocked(false)
@@ -370,6 +395,111 @@ namespace MWRender
         mMinSize = Settings::Manager::getFloat("object paging min size", "Terrain");
         mMinSizeMergeFactor = Settings::Manager::getFloat("object paging min size merge factor", "Terrain");
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
+        if (!chunkStoragePath.empty())
+        {
+            try
+            {
+                const std::uintmax_t maxSize = static_cast<std::uintmax_t>(std::max(0,
+                    Settings::Manager::getInt("object paging max disk cache size", "Terrain"))) * 1024 * 1024;
+                mChunkStorage = std::make_unique<ChunkStorage>(mSceneManager, chunkStoragePath,
+                    makeChunkStorageEnvironment(*mSceneManager->getVFS(), contentFiles), maxSize);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Object paging chunk storage is disabled: " << e.what();
+            }
+        }
+    }
+
+    ObjectPaging::~ObjectPaging() = default;
+
+    std::shared_ptr<const ObjectPaging::PagedRefs> ObjectPaging::getPagedRefs(int cellX, int cellY)
+    {
+        const auto cellIndex = std::make_pair(cellX, cellY);
+        {
+            std::lock_guard<std::mutex> lock(mPagedRefsMutex);
+            const auto found = mPagedRefs.find(cellIndex);
+            if (found != mPagedRefs.end())
+                return found->second;
+        }
+
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        std::shared_ptr<const PagedRefs> result;
+        if (const ESM::Cell* cell = store.get<ESM::Cell>().searchStatic(cellX, cellY))
+        {
+            std::map<ESM::RefNum, ESM::CellRef> refs;
+            std::map<ESM::RefNum, int> types;
+            std::set<ESM::RefNum> deleted;
+            const auto setRef = [&] (const ESM::RefNum& refNum, const ESM::CellRef& ref, int type)
+            {
+                refs[refNum] = ref;
+                types[refNum] = type;
+                deleted.erase(refNum);
+            };
+            const auto eraseRef = [&] (const ESM::RefNum& refNum)
+            {
+                refs.erase(refNum);
+                deleted.insert(refNum);
+            };
+
+            std::vector<ESM::ESMReader> esm;
+            for (size_t i=0; i<cell->mContextList.size(); ++i)
+            {
+                try
+                {
+                    unsigned int index = cell->mContextList.at(i).index;
+                    if (esm.size()<=index)
+                        esm.resize(index+1);
+                    cell->restore(esm[index], i);
+                    ESM::CellRef ref;
+                    ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+                    bool isDeleted = false;
+                    while(cell->getNextRef(esm[index], ref, isDeleted))
+                    {
+                        Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
+                        if (std::find(cell->mMovedRefs.begin(), cell->mMovedRefs.end(), ref.mRefNum) != cell->mMovedRefs.end()) continue;
+                        int type = store.findStatic(ref.mRefID);
+                        if (!typeFilter(type,false)) continue;
+                        if (isDeleted) { eraseRef(ref.mRefNum); continue; }
+                        setRef(ref.mRefNum, ref, type);
+                    }
+                }
+                catch (std::exception& e)
+                {
+                    continue;
+                }
+            }
+            for (ESM::CellRefTracker::const_iterator it = cell->mLeasedRefs.begin(); it != cell->mLeasedRefs.end(); ++it)
+            {
+                ESM::CellRef ref = it->first;
+                Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
+                bool isDeleted = it->second;
+                if (isDeleted) { eraseRef(ref.mRefNum); continue; }
+                int type = store.findStatic(ref.mRefID);
+                if (!typeFilter(type,false)) continue;
+                setRef(ref.mRefNum, ref, type);
+            }
+
+            auto pagedRefs = std::make_shared<PagedRefs>();
+            pagedRefs->reserve(refs.size() + deleted.size());
+            for (const ESM::RefNum& refNum : deleted)
+                pagedRefs->push_back(PagedRef {refNum, 0, std::string(), ESM::Position(), 1.f, true});
+            for (const auto& pair : refs)
+            {
+                const ESM::CellRef& ref = pair.second;
+                if (ref.mRefID == "prisonmarker" || ref.mRefID == "divinemarker" || ref.mRefID == "templemarker" || ref.mRefID == "northmarker")
+                    continue; // marker objects that have a hardcoded function in the game logic, should be hidden from the player
+
+                const int type = types[pair.first];
+                std::string model = getModel(type, ref.mRefID, store);
+                if (model.empty()) continue;
+                pagedRefs->push_back(PagedRef {pair.first, type, "meshes/" + model, ref.mPos, ref.mScale, false});
+            }
+            result = std::move(pagedRefs);
+        }
+
+        std::lock_guard<std::mutex> lock(mPagedRefsMutex);
+        return mPagedRefs.emplace(cellIndex, std::move(result)).first->second;
     }
 
     osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
@@ -379,52 +509,22 @@ namespace MWRender
         osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         osg::Vec3f relativeViewPoint = viewPoint - worldCenter;
 
-        std::map<ESM::RefNum, ESM::CellRef> refs;
-        std::vector<ESM::ESMReader> esm;
-        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        std::map<ESM::RefNum, const PagedRef*> refs;
+        std::vector<std::shared_ptr<const PagedRefs>> cellsRefs;
 
         for (int cellX = startCell.x(); cellX < startCell.x() + size; ++cellX)
         {
             for (int cellY = startCell.y(); cellY < startCell.y() + size; ++cellY)
             {
-                const ESM::Cell* cell = store.get<ESM::Cell>().searchStatic(cellX, cellY);
-                if (!cell) continue;
-                for (size_t i=0; i<cell->mContextList.size(); ++i)
-                {
-                    try
-                    {
-                        unsigned int index = cell->mContextList.at(i).index;
-                        if (esm.size()<=index)
-                            esm.resize(index+1);
-                        cell->restore(esm[index], i);
-                        ESM::CellRef ref;
-                        ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
-                        bool deleted = false;
-                        while(cell->getNextRef(esm[index], ref, deleted))
-                        {
-                            Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
-                            if (std::find(cell->mMovedRefs.begin(), cell->mMovedRefs.end(), ref.mRefNum) != cell->mMovedRefs.end()) continue;
-                            int type = store.findStatic(ref.mRefID);
-                            if (!typeFilter(type,size>=2)) continue;
-                            if (deleted) { refs.erase(ref.mRefNum); continue; }
-                            refs[ref.mRefNum] = ref;
-                        }
-                    }
-                    catch (std::exception& e)
-                    {
-                        continue;
-                    }
-                }
-                for (ESM::CellRefTracker::const_iterator it = cell->mLeasedRefs.begin(); it != cell->mLeasedRefs.end(); ++it)
+                std::shared_ptr<const PagedRefs> cellRefs = getPagedRefs(cellX, cellY);
+                if (!cellRefs) continue;
+                for (const PagedRef& ref : *cellRefs)
                 {
-                    ESM::CellRef ref = it->first;
-                    Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
-                    bool deleted = it->second;
-                    if (deleted) { refs.erase(ref.mRefNum); continue; }
-                    int type = store.findStatic(ref.mRefID);
-                    if (!typeFilter(type,size>=2)) continue;
-                    refs[ref.mRefNum] = ref;
+                    if (ref.mDeleted) { refs.erase(ref.mRefNum); continue; }
+                    if (!typeFilter(ref.mType,size>=2)) continue;
+                    refs[ref.mRefNum] = &ref;
                 }
+                cellsRefs.push_back(std::move(cellRefs));
             }
         }
 
@@ -439,9 +539,10 @@ namespace MWRender
         osg::Vec2f maxBound = (center + osg::Vec2f(size/2.f, size/2.f));
         struct InstanceList
         {
-            std::vector<const ESM::CellRef*> mInstances;
+            std::vector<const PagedRef*> mInstances;
             AnalyzeVisitor::Result mAnalyzeResult;
             bool mNeedCompile = false;
+            bool mMerge = false;
         };
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
         NodeMap nodes;
@@ -452,7 +553,7 @@ namespace MWRender
             minSize *= mMinSizeMergeFactor;
         for (const auto& pair : refs)
         {
-            const ESM::CellRef& ref = pair.second;
+            const PagedRef& ref = *pair.second;
 
             osg::Vec3f pos = ref.mPos.asVec3();
             if (size < 1.f)
@@ -472,15 +573,9 @@ namespace MWRender
                     continue;
             }
 
-            if (ref.mRefID == "prisonmarker" || ref.mRefID == "divinemarker" || ref.mRefID == "templemarker" || ref.mRefID == "northmarker")
-                continue; // marker objects that have a hardcoded function in the game logic, should be hidden from the player
+            std::string model = ref.mModel;
 
-            int type = store.findStatic(ref.mRefID);
-            std::string model = getModel(type, ref.mRefID, store);
-            if (model.empty()) continue;
-            model = "meshes/" + model;
-
-            if (activeGrid && type != ESM::REC_STAT)
+            if (activeGrid && ref.mType != ESM::REC_STAT)
             {
                 model = Misc::ResourceHelpers::correctActorModelPath(model, mSceneManager->getVFS());
                 std::string kfname = Misc::StringUtils::lowerCase(model);
@@ -528,20 +623,17 @@ namespace MWRender
             emplaced.first->second.mInstances.push_back(&ref);
         }
 
-        osg::ref_ptr<osg::Group> group = new osg::Group;
-        osg::ref_ptr<osg::Group> mergeGroup = new osg::Group;
-        osg::ref_ptr<TemplateRef> templateRefs = new TemplateRef;
-        osgUtil::StateToCompile stateToCompile(0, nullptr);
-        CopyOp copyop;
-        for (const auto& pair : nodes)
+        std::vector<const PagedRef*> instances;
+        for (auto& pair : nodes)
         {
             const osg::Node* cnode = pair.first;
+            InstanceList& instanceList = pair.second;
 
-            const AnalyzeVisitor::Result& analyzeResult = pair.second.mAnalyzeResult;
+            const AnalyzeVisitor::Result& analyzeResult = instanceList.mAnalyzeResult;
 
             float mergeCost = analyzeResult.mNumVerts * size;
             float mergeBenefit = analyzeVisitor.getMergeBenefit(analyzeResult) * mMergeFactor;
-            bool merge = mergeBenefit > mergeCost;
+            instanceList.mMerge = mergeBenefit > mergeCost;
 
             float minSizeMerged = mMinSize;
             float factor2 = mergeBenefit > 0 ? std::min(1.f, mergeCost * mMinSizeCostMultiplier / mergeBenefit) : 1;
@@ -549,15 +641,60 @@ namespace MWRender
             if (minSizeMergeFactor2 > 0)
                 minSizeMerged *= minSizeMergeFactor2;
 
+            if (!activeGrid && minSizeMerged != minSize)
+            {
+                const float radius2 = cnode->getBound().radius2();
+                auto& list = instanceList.mInstances;
+                list.erase(std::remove_if(list.begin(), list.end(), [&] (const PagedRef* ref)
+                {
+                    return radius2 * ref->mScale*ref->mScale < (viewPoint-ref->mPos.asVec3()).length2()*minSizeMerged*minSizeMerged;
+                }), list.end());
+            }
+
+            if (mChunkStorage)
+                instances.insert(instances.end(), instanceList.mInstances.begin(), instanceList.mInstances.end());
+        }
+
+        std::vector<unsigned char> storageKey;
+        if (mChunkStorage && !activeGrid && !mDebugBatches && !instances.empty())
+        {
+            storageKey = makeChunkStorageKey(center, size, std::move(instances));
+            if (osg::ref_ptr<osg::Node> stored = mChunkStorage->load(center, size, storageKey))
+            {
+                auto ico = mSceneManager->getIncrementalCompileOperation();
+                if (compile && ico)
+                {
+                    osgUtil::StateToCompile stateToCompile(osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS|osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES, nullptr);
+                    stored->accept(stateToCompile);
+                    if (!stateToCompile.empty())
+                    {
+                        auto compileSet = new osgUtil::IncrementalCompileOperation::CompileSet(stored);
+                        compileSet->buildCompileMap(ico->getContextSet(), stateToCompile);
+                        ico->add(compileSet, false);
+                    }
+                }
+                stored->getBound();
+                stored->setNodeMask(Mask_Static);
+                return stored;
+            }
+        }
+
+        osg::ref_ptr<osg::Group> group = new osg::Group;
+        osg::ref_ptr<osg::Group> mergeGroup = new osg::Group;
+        osg::ref_ptr<TemplateRef> templateRefs = new TemplateRef;
+        osgUtil::StateToCompile stateToCompile(0, nullptr);
+        CopyOp copyop;
+        for (const auto& pair : nodes)
+        {
+            const osg::Node* cnode = pair.first;
+            const bool merge = pair.second.mMerge;
+
             unsigned int numinstances = 0;
             for (auto cref : pair.second.mInstances)
             {
-                const ESM::CellRef& ref = *cref;
+                const PagedRef& ref = *cref;
                 osg::Vec3f pos = ref.mPos.asVec3();
 
-                if (!activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * cref->mScale*cref->mScale < (viewPoint-pos).length2()*minSizeMerged*minSizeMerged)
-                    continue;
-
                 osg::Matrixf matrix;
                 matrix.preMultTranslate(pos - worldCenter);
                 matrix.preMultRotate( osg::Quat(ref.mPos.rot[2], osg::Vec3f(0,0,-1)) *
@@ -645,6 +782,9 @@ namespace MWRender
 
         group->getBound();
         group->setNodeMask(Mask_Static);
+        // The chunk is written in background, a copy keeps it from seeing further changes of the group
+        if (!storageKey.empty())
+            mChunkStorage->save(center, size, std::move(storageKey), new osg::Group(*group, osg::CopyOp::SHALLOW_COPY));
         osg::UserDataContainer* udc = group->getOrCreateUserDataContainer();
         if (activeGrid)
         {
@@ -656,6 +796,71 @@ namespace MWRender
         return group;
     }
 
+    std::vector<unsigned char> ObjectPaging::makeChunkStorageKey(const osg::Vec2f& center, float size, std::vector<const PagedRef*> instances) const
+    {
+        // Sort to not depend on order of templates in memory
+        std::sort(instances.begin(), instances.end(), [] (const PagedRef* lhs, const PagedRef* rhs) { return lhs->mRefNum < rhs->mRefNum; });
+
+        std::vector<unsigned char> result;
+        const auto add = [&] (const void* data, std::size_t dataSize)
+        {
+            const auto bytes = static_cast<const unsigned char*>(data);
+            result.insert(result.end(), bytes, bytes + dataSize);
+        };
+        const auto addValue = [&] (const auto& value) { add(&value, sizeof(value)); };
+
+        addValue(center.x());
+        addValue(center.y());
+        addValue(size);
+        addValue(mMergeFactor);
+        addValue(mMinSize);
+        addValue(mMinSizeMergeFactor);
+        addValue(mMinSizeCostMultiplier);
+        for (const PagedRef* ref : instances)
+        {
+            addValue(ref->mRefNum.mIndex);
+            addValue(ref->mRefNum.mContentFile);
+            addValue(ref->mPos.pos);
+            addValue(ref->mPos.rot);
+            addValue(ref->mScale);
+            addValue(ref->mModel.size());
+            add(ref->mModel.data(), ref->mModel.size());
+            addValue(getModelHash(ref->mModel));
+        }
+        return result;
+    }
+
+    std::uint64_t ObjectPaging::getModelHash(const std::string& model) const
+    {
+        std::string normalized = model;
+        mSceneManager->getVFS()->normalizeFilename(normalized);
+
+        {
+            std::lock_guard<std::mutex> lock(mModelHashesMutex);
+            const auto found = mModelHashes.find(normalized);
+            if (found != mModelHashes.end())
+                return found->second;
+        }
+
+        // Missing or unreadable model is replaced by an error marker, it's enough to tell it from any real model
+        std::uint64_t result = 0;
+        try
+        {
+            Files::IStreamPtr stream = mSceneManager->getVFS()->get(normalized);
+            Misc::Fnv1aHash hash;
+            char buffer[4096];
+            while (stream->read(buffer, sizeof(buffer)) || stream->gcount() > 0)
+                hash.add(buffer, static_cast<std::size_t>(stream->gcount()));
+            result = hash.getValue();
+        }
+        catch (const std::exception&)
+        {
+        }
+
+        std::lock_guard<std::mutex> lock(mModelHashesMutex);
+        return mModelHashes.emplace(std::move(normalized), result).first->second;
+    }
+
     unsigned int ObjectPaging::getNodeMask()
     {
         return Mask_Static;
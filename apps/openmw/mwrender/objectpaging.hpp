@@ -5,7 +5,11 @@
 #include <components/resource/resourcemanager.hpp>
 #include <components/esm/loadcell.hpp>
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace Resource
 {
@@ -18,14 +22,18 @@ namespace MWWorld
 
 namespace MWRender
 {
+    class ChunkStorage;
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
-        ObjectPaging(Resource::SceneManager* sceneManager);
-        ~ObjectPaging() = default;
+        /// @param chunkStoragePath directory to store built chunks in, empty to disable the disk cache
+        /// @param contentFiles paths of loaded content files, stored chunks are not used when they change
+        ObjectPaging(Resource::SceneManager* sceneManager, const std::string& chunkStoragePath,
+                     const std::vector<std::string>& contentFiles);
+        ~ObjectPaging();
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
@@ -57,6 +65,7 @@ namespace MWRender
         float mMinSize;
         float mMinSizeMergeFactor;
         float mMinSizeCostMultiplier;
+        std::unique_ptr<ChunkStorage> mChunkStorage;
 
         std::mutex mRefTrackerMutex;
         struct RefTracker
@@ -75,6 +84,35 @@ namespace MWRender
         std::mutex mSizeCacheMutex;
         typedef std::map<ESM::RefNum, float> SizeCache;
         SizeCache mSizeCache;
+
+        /// Reference of exterior cell that may be paged, with the data needed to build chunks
+        struct PagedRef
+        {
+            ESM::RefNum mRefNum;
+            int mType;
+            std::string mModel;
+            ESM::Position mPos;
+            float mScale;
+            /// Reference was deleted in this cell and has to be removed from refs of cells processed before
+            bool mDeleted;
+        };
+
+        typedef std::vector<PagedRef> PagedRefs;
+
+        /// Content files don't change at runtime, so references of each cell are read from them only once
+        std::mutex mPagedRefsMutex;
+        std::map<std::pair<int, int>, std::shared_ptr<const PagedRefs>> mPagedRefs;
+
+        std::shared_ptr<const PagedRefs> getPagedRefs(int cellX, int cellY);
+
+        /// @return key identifying chunk built from given instances in the chunk storage
+        std::vector<unsigned char> makeChunkStorageKey(const osg::Vec2f& center, float size, std::vector<const PagedRef*> instances) const;
+
+        /// Models are read once per session to tell when a stored chunk was built from a different model file
+        mutable std::mutex mModelHashesMutex;
+        mutable std::map<std::string, std::uint64_t> mModelHashes;
+
+        std::uint64_t getModelHash(const std::string& model) const;
     };
 
     class RefnumMarker : public osg::Object
@@ -22,6 +22,8 @@
 
 #include <osgViewer/Viewer>
 
+#include <boost/filesystem/path.hpp>
+
 #include <components/nifosg/nifloader.hpp>
 
 #include <components/debug/debuglog.hpp>
@@ -193,7 +195,8 @@ namespace MWRender
 
     RenderingManager::RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                                        Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                                       const std::string& resourcePath, DetourNavigator::Navigator& navigator)
+                                       const std::string& resourcePath, const std::string& userDataPath, DetourNavigator::Navigator& navigator,
+                                       const std::vector<std::string>& contentFiles)
         : mViewer(viewer)
         , mRootNode(rootNode)
         , mResourceSystem(resourceSystem)
@@ -293,7 +296,10 @@ namespace MWRender
                 compMapResolution, compMapLevel, lodFactor, vertexLodMod, maxCompGeometrySize));
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
-                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager()));
+                std::string chunkStoragePath;
+                if (Settings::Manager::getBool("object paging disk cache", "Terrain"))
+                    chunkStoragePath = (boost::filesystem::path(userDataPath) / "objectpaging").string();
+                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager(), chunkStoragePath, contentFiles));
                 static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->addChunkManager(mObjectPaging.get());
                 mResourceSystem->addResourceManager(mObjectPaging.get());
             }
@@ -16,6 +16,8 @@
 
 #include <deque>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace osg
 {
@@ -93,7 +95,8 @@ namespace MWRender
     public:
         RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                          Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                         const std::string& resourcePath, DetourNavigator::Navigator& navigator);
+                         const std::string& resourcePath, const std::string& userDataPath, DetourNavigator::Navigator& navigator,
+                         const std::vector<std::string>& contentFiles);
         ~RenderingManager();
 
         osgUtil::IncrementalCompileOperation* getIncrementalCompileOperation();
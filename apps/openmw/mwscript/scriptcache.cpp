@@ -0,0 +1,150 @@
+#include "scriptcache.hpp"
+
+#include <cstdint>
+#include <sstream>
+
+#include <components/compiler/extensions.hpp>
+#include <components/debug/debuglog.hpp>
+#include <components/files/cachefile.hpp>
+#include <components/misc/hash.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    constexpr std::uint32_t scriptCacheMagic = 'O' << 24 | 'S' << 16 | 'C' << 8 | 'C'; //'OSCC';
+    // Increase when compiler changes the generated code
+    constexpr std::uint32_t scriptCacheVersion = 1;
+
+    constexpr char localTypes[] = {'s', 'l', 'f'};
+
+    std::string makeEnvironment(const Compiler::Extensions& extensions, const std::vector<std::string>& contentFiles)
+    {
+        std::ostringstream stream;
+        Files::writeValue(stream, extensions.getHash());
+        for (const std::string& file : contentFiles)
+            Files::writeFileStamp(stream, file);
+        return stream.str();
+    }
+}
+
+namespace MWScript
+{
+    ScriptCache::ScriptCache (const std::string& path, const Compiler::Extensions& extensions,
+        const std::vector<std::string>& contentFiles, std::uintmax_t maxSize)
+    : mMaxSize (maxSize)
+    , mChanged (false)
+    {
+        try
+        {
+            mEnvironment = makeEnvironment(extensions, contentFiles);
+            mPath = boost::filesystem::path(path) / (Files::toHex(Misc::fnv1aHash(mEnvironment)) + ".scripts");
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Compiled script cache is disabled: " << e.what();
+            return;
+        }
+
+        Log(Debug::Info) << "Using compiled script cache " << mPath;
+
+        load();
+    }
+
+    bool ScriptCache::get (const std::string& name, const std::string& text,
+        std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const
+    {
+        const auto it = mEntries.find(Misc::StringUtils::lowerCase(name));
+        if (it == mEntries.end() || it->second.mText != text)
+            return false;
+        code = it->second.mCode;
+        locals = it->second.mLocals;
+        return true;
+    }
+
+    void ScriptCache::add (const std::string& name, const std::string& text,
+        const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals)
+    {
+        if (mPath.empty())
+            return;
+        Entry& entry = mEntries[Misc::StringUtils::lowerCase(name)];
+        entry.mText = text;
+        entry.mCode = code;
+        entry.mLocals = locals;
+        mChanged = true;
+    }
+
+    void ScriptCache::load()
+    {
+        try
+        {
+            boost::filesystem::ifstream file;
+            if (!Files::openCacheFile(file, mPath, scriptCacheMagic, scriptCacheVersion, mEnvironment))
+                return;
+
+            // Cache of the current content files should be removed last
+            Files::touchCacheFile(mPath);
+
+            const auto count = Files::readValue<std::uint64_t>(file);
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                const std::string name = Files::readString(file);
+                Entry entry;
+                entry.mText = Files::readString(file);
+                entry.mCode.resize(Files::readValue<std::uint64_t>(file));
+                file.read(reinterpret_cast<char*>(entry.mCode.data()),
+                    static_cast<std::streamsize>(entry.mCode.size() * sizeof(Interpreter::Type_Code)));
+                for (char type : localTypes)
+                {
+                    const auto size = Files::readValue<std::uint64_t>(file);
+                    for (std::uint64_t j = 0; j < size; ++j)
+                        entry.mLocals.declare(type, Files::readString(file));
+                }
+                mEntries.emplace(name, std::move(entry));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to load compiled script cache from " << mPath << ": " << e.what();
+            mEntries.clear();
+        }
+    }
+
+    void ScriptCache::save()
+    {
+        if (!mChanged)
+            return;
+
+        try
+        {
+            Files::writeCacheFile(mPath, scriptCacheMagic, scriptCacheVersion, mEnvironment, [&] (std::ostream& file)
+            {
+                Files::writeValue(file, static_cast<std::uint64_t>(mEntries.size()));
+                for (const auto& entry : mEntries)
+                {
+                    Files::writeString(file, entry.first);
+                    Files::writeString(file, entry.second.mText);
+                    Files::writeValue(file, static_cast<std::uint64_t>(entry.second.mCode.size()));
+                    file.write(reinterpret_cast<const char*>(entry.second.mCode.data()),
+                        static_cast<std::streamsize>(entry.second.mCode.size() * sizeof(Interpreter::Type_Code)));
+                    for (char type : localTypes)
+                    {
+                        const std::vector<std::string>& names = entry.second.mLocals.get(type);
+                        Files::writeValue(file, static_cast<std::uint64_t>(names.size()));
+                        for (const std::string& name : names)
+                            Files::writeString(file, name);
+                    }
+                }
+            });
+
+            mChanged = false;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to save compiled script cache to " << mPath << ": " << e.what();
+            return;
+        }
+
+        // Files for other content files are not used until they are loaded again
+        Files::trimCache(mPath.parent_path(), mMaxSize);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef GAME_SCRIPT_SCRIPTCACHE_H
+#define GAME_SCRIPT_SCRIPTCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+#include <components/compiler/locals.hpp>
+#include <components/interpreter/types.hpp>
+
+namespace Compiler
+{
+    class Extensions;
+}
+
+namespace MWScript
+{
+    /// @brief On-disk cache of compiled scripts.
+    ///
+    /// Compiled code depends on the script text, compiler extensions and records of the loaded content files, so
+    /// there is a separate cache file for each set of extensions and content files. Content files are identified by
+    /// their paths, sizes and modification times. Scripts are matched by the full script text.
+    /// Least recently used cache files are removed when the directory size exceeds the limit.
+    class ScriptCache
+    {
+        public:
+
+            ScriptCache (const std::string& path, const Compiler::Extensions& extensions,
+                const std::vector<std::string>& contentFiles, std::uintmax_t maxSize);
+            ///< \param maxSize max total size of cache files in \a path in bytes.
+
+            bool get (const std::string& name, const std::string& text,
+                std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const;
+            ///< \return false if there is no compiled script for \a name with \a text.
+
+            void add (const std::string& name, const std::string& text,
+                const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals);
+
+            void save();
+            ///< Write the cache to disk if scripts were added since the last save and remove old cache files.
+
+        private:
+
+            struct Entry
+            {
+                std::string mText;
+                std::vector<Interpreter::Type_Code> mCode;
+                Compiler::Locals mLocals;
+            };
+
+            boost::filesystem::path mPath;
+            std::string mEnvironment;
+            std::uintmax_t mMaxSize;
+            std::map<std::string, Entry> mEntries;
+            bool mChanged;
+
+            void load();
+    };
+}
+
+#endif
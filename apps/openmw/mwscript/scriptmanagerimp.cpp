@@ -20,15 +20,16 @@
 
 #include "extensions.hpp"
 #include "interpretercontext.hpp"
+#include "scriptcache.hpp"
 
 namespace MWScript
 {
     ScriptManager::ScriptManager (const MWWorld::ESMStore& store,
         Compiler::Context& compilerContext, int warningsMode,
-        const std::vector<std::string>& scriptBlacklist)
+        const std::vector<std::string>& scriptBlacklist, std::unique_ptr<ScriptCache> cache)
     : mErrorHandler(), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mGlobalScripts (store), mCache (std::move (cache))
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -39,6 +40,12 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
+    ScriptManager::~ScriptManager()
+    {
+        if (mCache)
+            mCache->save();
+    }
+
     bool ScriptManager::compile (const std::string& name)
     {
         mParser.reset();
@@ -46,6 +53,17 @@ namespace MWScript
 
         if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
         {
+            if (mCache)
+            {
+                std::vector<Interpreter::Type_Code> code;
+                Compiler::Locals locals;
+                if (mCache->get (name, script->mScriptText, code, locals))
+                {
+                    mScripts.emplace(name, CompiledScript(code, locals));
+                    return true;
+                }
+            }
+
             mErrorHandler.setContext(name);
 
             bool Success = true;
@@ -82,6 +100,9 @@ namespace MWScript
                 mParser.getCode(code);
                 mScripts.emplace(name, CompiledScript(code, mParser.getLocals()));
 
+                if (mCache)
+                    mCache->add (name, script->mScriptText, code, mParser.getLocals());
+
                 return true;
             }
         }
@@ -118,7 +139,12 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.mByteCode[0], iter->second.mByteCode.size(), interpreterContext);
+                CompiledScript& script = iter->second;
+
+                if (script.mDecodedCode.empty())
+                    script.mDecodedCode = mInterpreter.decode (&script.mByteCode[0], script.mByteCode.size());
+
+                mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(), script.mDecodedCode, interpreterContext);
                 return true;
             }
             catch (const MissingImplicitRefError& e)
@@ -161,6 +187,9 @@ namespace MWScript
             }
         }
 
+        if (mCache)
+            mCache->save();
+
         return std::make_pair (count, success);
     }
 
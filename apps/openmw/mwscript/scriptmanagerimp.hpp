@@ -2,6 +2,7 @@
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include <components/compiler/streamerrorhandler.hpp>
@@ -32,6 +33,8 @@ namespace Interpreter
 
 namespace MWScript
 {
+    class ScriptCache;
+
     class ScriptManager : public MWBase::ScriptManager
     {
             Compiler::StreamErrorHandler mErrorHandler;
@@ -44,6 +47,7 @@ namespace MWScript
             struct CompiledScript
             {
                 std::vector<Interpreter::Type_Code> mByteCode;
+                Interpreter::Interpreter::DecodedCode mDecodedCode; // empty until the script is executed
                 Compiler::Locals mLocals;
                 bool mActive;
 
@@ -61,12 +65,16 @@ namespace MWScript
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
             std::vector<std::string> mScriptBlacklist;
+            std::unique_ptr<ScriptCache> mCache;
 
         public:
 
+            /// @param cache Compiled scripts to use instead of compiling scripts again, may be nullptr.
             ScriptManager (const MWWorld::ESMStore& store,
                 Compiler::Context& compilerContext, int warningsMode,
-                const std::vector<std::string>& scriptBlacklist);
+                const std::vector<std::string>& scriptBlacklist, std::unique_ptr<ScriptCache> cache = nullptr);
+
+            ~ScriptManager() override;
 
             void clear() override;
 
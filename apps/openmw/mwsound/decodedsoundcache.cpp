@@ -0,0 +1,51 @@
+#include "decodedsoundcache.hpp"
+
+#include "sound_decoder.hpp"
+
+namespace MWSound
+{
+    DecodedSoundCache::DecodedSoundCache(std::size_t maxSize)
+        : mMaxSize(maxSize)
+        , mSize(0)
+    {
+    }
+
+    std::shared_ptr<const DecodedSound> DecodedSoundCache::get(const std::string& name)
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        const auto it = mIndex.find(name);
+        if (it == mIndex.end())
+            return nullptr;
+        mItems.splice(mItems.begin(), mItems, it->second);
+        return it->second->second;
+    }
+
+    bool DecodedSoundCache::contains(const std::string& name) const
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        return mIndex.count(name) > 0;
+    }
+
+    void DecodedSoundCache::add(const std::string& name, std::shared_ptr<const DecodedSound> sound)
+    {
+        const std::size_t size = sound->mData.size();
+        if (size > mMaxSize)
+            return;
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mIndex.count(name) > 0)
+            return;
+
+        while (!mItems.empty() && mSize + size > mMaxSize)
+        {
+            mSize -= mItems.back().second->mData.size();
+            mIndex.erase(mItems.back().first);
+            mItems.pop_back();
+        }
+
+        mItems.emplace_front(name, std::move(sound));
+        mIndex.emplace(name, mItems.begin());
+        mSize += size;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef GAME_SOUND_DECODEDSOUNDCACHE_H
+#define GAME_SOUND_DECODEDSOUNDCACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MWSound
+{
+    struct DecodedSound;
+
+    /// @brief Thread safe cache of decoded sounds by VFS path.
+    /// Least recently used sounds are removed when the total size of the cached data exceeds the limit.
+    class DecodedSoundCache
+    {
+        public:
+            explicit DecodedSoundCache(std::size_t maxSize);
+
+            std::shared_ptr<const DecodedSound> get(const std::string& name);
+            ///< \return nullptr if \a name is not cached.
+
+            bool contains(const std::string& name) const;
+
+            void add(const std::string& name, std::shared_ptr<const DecodedSound> sound);
+
+        private:
+            using Item = std::pair<std::string, std::shared_ptr<const DecodedSound>>;
+
+            const std::size_t mMaxSize;
+            std::size_t mSize;
+            mutable std::mutex mMutex;
+            // Most recently used first
+            std::list<Item> mItems;
+            std::unordered_map<std::string, std::list<Item>::iterator> mIndex;
+    };
+}
+
+#endif
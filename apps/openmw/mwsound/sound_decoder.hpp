@@ -30,6 +30,14 @@ namespace MWSound
     size_t framesToBytes(size_t frames, ChannelConfig config, SampleType type);
     size_t bytesToFrames(size_t bytes, ChannelConfig config, SampleType type);
 
+    struct DecodedSound
+    {
+        std::vector<char> mData;
+        int mSampleRate = 0;
+        ChannelConfig mChannels = ChannelConfig_Mono;
+        SampleType mType = SampleType_UInt8;
+    };
+
     struct Sound_Decoder
     {
         const VFS::Manager* mResourceMgr;
@@ -52,6 +60,10 @@ namespace MWSound
         Sound_Decoder(const Sound_Decoder &rhs);
         Sound_Decoder& operator=(const Sound_Decoder &rhs);
     };
+
+    DecodedSound decodeSound(Sound_Decoder &decoder, const std::string &fname);
+    ///< Decode the whole file. Returns empty data if the file can't be decoded.
+    /// @note Can be called from any thread.
 }
 
 #endif
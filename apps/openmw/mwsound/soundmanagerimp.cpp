@@ -9,6 +9,7 @@
 #include <components/misc/rng.hpp>
 #include <components/debug/debuglog.hpp>
 #include <components/vfs/manager.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -23,6 +24,7 @@
 #include "sound_decoder.hpp"
 #include "sound_output.hpp"
 #include "sound.hpp"
+#include "decodedsoundcache.hpp"
 
 #include "openal_output.hpp"
 #include "ffmpeg_decoder.hpp"
@@ -52,12 +54,46 @@ namespace MWSound
     // For combining PlayMode and Type flags
     inline int operator|(PlayMode a, Type b) { return static_cast<int>(a) | static_cast<int>(b); }
 
+    /// Worker thread item: decode a sound file, using the decoded sound cache if there is one.
+    class DecodeSoundItem : public SceneUtil::WorkItem
+    {
+    public:
+        DecodeSoundItem(DecoderPtr decoder, const std::string &fname, DecodedSoundCache *cache)
+            : mDecoder(std::move(decoder))
+            , mFileName(fname)
+            , mCache(cache)
+        {
+        }
+
+        void doWork() override
+        {
+            if(mCache)
+                mResult = mCache->get(mFileName);
+            if(!mResult)
+            {
+                mResult = std::make_shared<DecodedSound>(MWSound::decodeSound(*mDecoder, mFileName));
+                if(mCache)
+                    mCache->add(mFileName, mResult);
+            }
+            mDecoder.reset();
+        }
+
+        const std::shared_ptr<const DecodedSound> &getResult() const { return mResult; }
+
+    private:
+        DecoderPtr mDecoder;
+        std::string mFileName;
+        DecodedSoundCache *mCache;
+        std::shared_ptr<const DecodedSound> mResult;
+    };
+
     SoundManager::SoundManager(const VFS::Manager* vfs, bool useSound)
         : mVFS(vfs)
         , mOutput(new DEFAULT_OUTPUT(*this))
         , mWaterSoundUpdater(makeWaterSoundUpdaterSettings())
         , mSoundBuffers(new SoundBufferList::element_type())
         , mBufferCacheSize(0)
+        , mAsyncDecoding(false)
         , mListenerUnderwater(false)
         , mListenerPos(0,0,0)
         , mListenerDir(1,0,0)
@@ -111,11 +147,21 @@ namespace MWSound
 
             Log(Debug::Info) << stream.str();
         }
+
+        if(Settings::Manager::getBool("decoded sound cache", "Sound"))
+            mDecodedSoundCache = std::make_unique<DecodedSoundCache>(mBufferCacheMax);
+
+        mAsyncDecoding = Settings::Manager::getBool("async decoding", "Sound");
+        if(mAsyncDecoding || mDecodedSoundCache)
+            mDecodeQueue = new SceneUtil::WorkQueue(1);
     }
 
     SoundManager::~SoundManager()
     {
         clear();
+        mDecodingBuffers.clear();
+        mPreloadingSounds.clear();
+        mDecodeQueue = nullptr;
         for(Sound_Buffer &sfx : *mSoundBuffers)
         {
             if(sfx.mHandle)
@@ -173,14 +219,14 @@ namespace MWSound
         if(snd != mBufferNameMap.end())
         {
             Sound_Buffer *sfx = snd->second;
-            if(sfx->mHandle) return sfx;
+            if(sfx->mHandle || mDecodingBuffers.count(sfx) > 0) return sfx;
         }
         return nullptr;
     }
 
     // Lookup a soundId for its sound data (resource name, local volume,
-    // minRange, and maxRange), and ensure it's ready for use.
-    Sound_Buffer *SoundManager::loadSound(const std::string &soundId)
+    // minRange, and maxRange)
+    Sound_Buffer *SoundManager::findSound(const std::string &soundId)
     {
 #ifdef __GNUC__
 #define LIKELY(x) __builtin_expect((bool)(x), true)
@@ -196,50 +242,137 @@ namespace MWSound
                 insertSound(Misc::StringUtils::lowerCase(sound.mId), &sound);
         }
 
-        Sound_Buffer *sfx;
         NameBufferMap::const_iterator snd = mBufferNameMap.find(soundId);
         if(LIKELY(snd != mBufferNameMap.end()))
-            sfx = snd->second;
-        else
-        {
-            MWBase::World *world = MWBase::Environment::get().getWorld();
-            const ESM::Sound *sound = world->getStore().get<ESM::Sound>().search(soundId);
-            if(!sound) return nullptr;
-            sfx = insertSound(soundId, sound);
-        }
+            return snd->second;
+
+        MWBase::World *world = MWBase::Environment::get().getWorld();
+        const ESM::Sound *sound = world->getStore().get<ESM::Sound>().search(soundId);
+        if(!sound) return nullptr;
+        return insertSound(soundId, sound);
 #undef LIKELY
 #undef UNLIKELY
+    }
 
-        if(!sfx->mHandle)
+    // Lookup a soundId for its sound data (resource name, local volume,
+    // minRange, and maxRange), and ensure it's ready for use.
+    Sound_Buffer *SoundManager::loadSound(const std::string &soundId)
+    {
+        Sound_Buffer *sfx = findSound(soundId);
+        if(!sfx) return nullptr;
+
+        if(!sfx->mHandle && mDecodingBuffers.count(sfx) == 0)
         {
-            size_t size;
-            std::tie(sfx->mHandle, size) = mOutput->loadSound(sfx->mResourceName);
-            if(!sfx->mHandle) return nullptr;
+            std::shared_ptr<const DecodedSound> decoded;
+            if(mDecodedSoundCache)
+                decoded = mDecodedSoundCache->get(sfx->mResourceName);
 
-            mBufferCacheSize += size;
-            if(mBufferCacheSize > mBufferCacheMax)
+            if(!decoded && mAsyncDecoding)
             {
-                do {
-                    if(mUnusedBuffers.empty())
-                    {
-                        Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
-                        break;
-                    }
-                    Sound_Buffer *unused = mUnusedBuffers.back();
+                // Sounds using this buffer will start playing when it's decoded
+                osg::ref_ptr<DecodeSoundItem> item(new DecodeSoundItem(getDecoder(), sfx->mResourceName,
+                                                                       mDecodedSoundCache.get()));
+                mDecodeQueue->addWorkItem(item, SceneUtil::WorkQueue::Priority::High);
+                mDecodingBuffers.emplace(sfx, std::move(item));
+                return sfx;
+            }
 
-                    size = mOutput->unloadSound(unused->mHandle);
-                    mBufferCacheSize -= size;
-                    unused->mHandle = nullptr;
+            if(!decoded)
+                decoded = decodeSound(sfx->mResourceName);
 
-                    mUnusedBuffers.pop_back();
-                } while(mBufferCacheSize > mBufferCacheMin);
-            }
-            mUnusedBuffers.push_front(sfx);
+            if(!loadBuffer(sfx, *decoded))
+                return nullptr;
         }
 
         return sfx;
     }
 
+    std::shared_ptr<const DecodedSound> SoundManager::decodeSound(const std::string &fname)
+    {
+        DecoderPtr decoder = getDecoder();
+        std::shared_ptr<const DecodedSound> decoded = std::make_shared<DecodedSound>(MWSound::decodeSound(*decoder, fname));
+        if(mDecodedSoundCache)
+            mDecodedSoundCache->add(fname, decoded);
+        return decoded;
+    }
+
+    bool SoundManager::loadBuffer(Sound_Buffer *sfx, const DecodedSound &sound)
+    {
+        size_t size;
+        std::tie(sfx->mHandle, size) = mOutput->loadSound(sound);
+        if(!sfx->mHandle) return false;
+
+        mBufferCacheSize += size;
+        if(mBufferCacheSize > mBufferCacheMax)
+        {
+            do {
+                if(mUnusedBuffers.empty())
+                {
+                    Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+                    break;
+                }
+                Sound_Buffer *unused = mUnusedBuffers.back();
+
+                size = mOutput->unloadSound(unused->mHandle);
+                mBufferCacheSize -= size;
+                unused->mHandle = nullptr;
+
+                mUnusedBuffers.pop_back();
+            } while(mBufferCacheSize > mBufferCacheMin);
+        }
+        // Buffer decoded in background may be already used by waiting sounds
+        if(sfx->mUses == 0)
+            mUnusedBuffers.push_front(sfx);
+
+        return true;
+    }
+
+    void SoundManager::updateDecodedSounds()
+    {
+        for(auto it = mDecodingBuffers.begin(); it != mDecodingBuffers.end();)
+        {
+            if(!it->second->isDone())
+            {
+                ++it;
+                continue;
+            }
+            if(!loadBuffer(it->first, *it->second->getResult()))
+                Log(Debug::Error) << "Failed to load sound buffer for " << it->first->mResourceName;
+            it = mDecodingBuffers.erase(it);
+        }
+
+        for(auto it = mPreloadingSounds.begin(); it != mPreloadingSounds.end();)
+        {
+            if(it->second->isDone())
+                it = mPreloadingSounds.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    bool SoundManager::startSound(Sound *sound, Sound_Buffer *sfx, float offset)
+    {
+        if(!sfx->mHandle)
+        {
+            mWaitingSounds.emplace(sound, offset);
+            return true;
+        }
+        if(sound->getIs3D())
+            return mOutput->playSound3D(sound, sfx->mHandle, offset);
+        return mOutput->playSound(sound, sfx->mHandle, offset);
+    }
+
+    void SoundManager::finishSound(Sound *sound)
+    {
+        mWaitingSounds.erase(sound);
+        mOutput->finishSound(sound);
+    }
+
+    bool SoundManager::isSoundPlaying(Sound *sound) const
+    {
+        return mWaitingSounds.count(sound) > 0 || mOutput->isSoundPlaying(sound);
+    }
+
     DecoderPtr SoundManager::loadVoice(const std::string &voicefile)
     {
         try
@@ -630,7 +763,7 @@ namespace MWSound
             params.mFlags = mode | type | Play_2D;
             return params;
         } ());
-        if(!mOutput->playSound(sound.get(), sfx->mHandle, offset))
+        if(!startSound(sound.get(), sfx, offset))
             return nullptr;
 
         if(sfx->mUses++ == 0)
@@ -674,7 +807,7 @@ namespace MWSound
                 params.mFlags = mode | type | Play_2D;
                 return params;
             } ());
-            played = mOutput->playSound(sound.get(), sfx->mHandle, offset);
+            played = startSound(sound.get(), sfx, offset);
         }
         else
         {
@@ -689,7 +822,7 @@ namespace MWSound
                 params.mFlags = mode | type | Play_3D;
                 return params;
             } ());
-            played = mOutput->playSound3D(sound.get(), sfx->mHandle, offset);
+            played = startSound(sound.get(), sfx, offset);
         }
         if(!played)
             return nullptr;
@@ -728,7 +861,7 @@ namespace MWSound
             params.mFlags = mode | type | Play_3D;
             return params;
         } ());
-        if(!mOutput->playSound3D(sound.get(), sfx->mHandle, offset))
+        if(!startSound(sound.get(), sfx, offset))
             return nullptr;
 
         if(sfx->mUses++ == 0)
@@ -745,7 +878,7 @@ namespace MWSound
     void SoundManager::stopSound(Sound *sound)
     {
         if(sound)
-            mOutput->finishSound(sound);
+            finishSound(sound);
     }
 
     void SoundManager::stopSound(Sound_Buffer *sfx, const MWWorld::ConstPtr &ptr)
@@ -756,7 +889,7 @@ namespace MWSound
             for(SoundBufferRefPair &snd : snditer->second)
             {
                 if(snd.second == sfx)
-                    mOutput->finishSound(snd.first.get());
+                    finishSound(snd.first.get());
             }
         }
     }
@@ -778,7 +911,7 @@ namespace MWSound
         if(snditer != mActiveSounds.end())
         {
             for(SoundBufferRefPair &snd : snditer->second)
-                mOutput->finishSound(snd.first.get());
+                finishSound(snd.first.get());
         }
         SaySoundMap::iterator sayiter = mSaySoundsQueue.find(ptr);
         if(sayiter != mSaySoundsQueue.end())
@@ -795,7 +928,7 @@ namespace MWSound
             if(!snd.first.isEmpty() && snd.first != MWMechanics::getPlayer() && snd.first.getCell() == cell)
             {
                 for(SoundBufferRefPair &sndbuf : snd.second)
-                    mOutput->finishSound(sndbuf.first.get());
+                    finishSound(sndbuf.first.get());
             }
         }
 
@@ -837,7 +970,9 @@ namespace MWSound
             Sound_Buffer *sfx = lookupSound(Misc::StringUtils::lowerCase(soundId));
             return std::find_if(snditer->second.cbegin(), snditer->second.cend(),
                 [this,sfx](const SoundBufferRefPair &snd) -> bool
-                { return snd.second == sfx && mOutput->isSoundPlaying(snd.first.get()); }
+                {
+                    return snd.second == sfx && isSoundPlaying(snd.first.get());
+                }
             ) != snditer->second.cend();
         }
         return false;
@@ -898,7 +1033,7 @@ namespace MWSound
 
         if (!cell->isExterior())
             return;
-        if (mCurrentRegionSound && mOutput->isSoundPlaying(mCurrentRegionSound))
+        if (mCurrentRegionSound && isSoundPlaying(mCurrentRegionSound))
             return;
 
         if (const auto next = mRegionSoundSelector.getNextRandom(duration, cell->mRegion, *world))
@@ -924,12 +1059,12 @@ namespace MWSound
                 mNearWaterSound->setVolume(update.mVolume * sfx->mVolume);
                 break;
             case WaterSoundAction::FinishSound:
-                mOutput->finishSound(mNearWaterSound);
+                finishSound(mNearWaterSound);
                 mNearWaterSound = nullptr;
                 break;
             case WaterSoundAction::PlaySound:
                 if (mNearWaterSound)
-                    mOutput->finishSound(mNearWaterSound);
+                    finishSound(mNearWaterSound);
                 mNearWaterSound = playSound(update.mId, update.mVolume, 1.0f, Type::Sfx, PlayMode::Loop);
                 break;
         }
@@ -996,6 +1131,8 @@ namespace MWSound
         duration = mTimePassed;
         mTimePassed = 0.0f;
 
+        updateDecodedSounds();
+
         // Make sure music is still playing
         if(!isMusicPlaying() && !mCurrentPlaylist.empty())
             startRandomTitle();
@@ -1005,7 +1142,7 @@ namespace MWSound
             env = Env_Underwater;
         else if(mUnderwaterSound)
         {
-            mOutput->finishSound(mUnderwaterSound);
+            finishSound(mUnderwaterSound);
             mUnderwaterSound = nullptr;
         }
 
@@ -1019,6 +1156,10 @@ namespace MWSound
 
         updateMusic(duration);
 
+        int pausedTypes = 0;
+        for(int types : mPausedSoundTypes)
+            pausedTypes |= types;
+
         // Check if any sounds are finished playing, and trash them
         SoundMap::iterator snditer = mActiveSounds.begin();
         while(snditer != mActiveSounds.end())
@@ -1039,18 +1180,34 @@ namespace MWSound
                     if(sound->getDistanceCull())
                     {
                         if((mListenerPos - objpos).length2() > 2000*2000)
-                            mOutput->finishSound(sound);
+                            finishSound(sound);
                     }
                 }
 
+                const auto waiting = mWaitingSounds.find(sound);
+                if(waiting != mWaitingSounds.end())
+                {
+                    if((!sfx->mHandle && mDecodingBuffers.count(sfx) > 0) || (pausedTypes & sound->getPlayType()))
+                    {
+                        ++sndidx;
+                        continue;
+                    }
+                    const float offset = waiting->second;
+                    mWaitingSounds.erase(waiting);
+                    // Sound is removed below if it can't be played
+                    if(sfx->mHandle)
+                        startSound(sound, sfx, offset);
+                }
+
                 if(!mOutput->isSoundPlaying(sound))
                 {
-                    mOutput->finishSound(sound);
+                    finishSound(sound);
                     if (sound == mUnderwaterSound)
                         mUnderwaterSound = nullptr;
                     if (sound == mNearWaterSound)
                         mNearWaterSound = nullptr;
-                    if(sfx->mUses-- == 1)
+                    // Buffer without a handle is added to unused ones when it is loaded
+                    if(sfx->mUses-- == 1 && sfx->mHandle)
                         mUnusedBuffers.push_front(sfx);
                     sndidx = snditer->second.erase(sndidx);
                 }
@@ -1212,6 +1369,26 @@ namespace MWSound
         mWaterSoundUpdater.setUnderwater(underwater);
     }
 
+    void SoundManager::preloadSounds(const std::vector<std::string>& soundIds)
+    {
+        if(!mOutput->isInitialized() || !mDecodedSoundCache)
+            return;
+
+        for(const std::string& soundId : soundIds)
+        {
+            Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
+            if(!sfx || sfx->mHandle || mDecodingBuffers.count(sfx) > 0
+                    || mPreloadingSounds.count(sfx->mResourceName) > 0
+                    || mDecodedSoundCache->contains(sfx->mResourceName))
+                continue;
+
+            osg::ref_ptr<DecodeSoundItem> item(new DecodeSoundItem(getDecoder(), sfx->mResourceName,
+                                                                   mDecodedSoundCache.get()));
+            mDecodeQueue->addWorkItem(item, SceneUtil::WorkQueue::Priority::Low);
+            mPreloadingSounds.emplace(sfx->mResourceName, std::move(item));
+        }
+    }
+
     void SoundManager::updatePtr(const MWWorld::ConstPtr &old, const MWWorld::ConstPtr &updated)
     {
         SoundMap::iterator snditer = mActiveSounds.find(old);
@@ -1255,6 +1432,34 @@ namespace MWSound
         output.resize(total);
     }
 
+    DecodedSound decodeSound(Sound_Decoder &decoder, const std::string &fname)
+    {
+        DecodedSound result;
+        try
+        {
+            // Workaround: Bethesda at some point converted some of the files to mp3, but the references were kept as .wav.
+            if(decoder.mResourceMgr->exists(fname))
+                decoder.open(fname);
+            else
+            {
+                std::string file = fname;
+                std::string::size_type pos = file.rfind('.');
+                if(pos != std::string::npos)
+                    file = file.substr(0, pos)+".mp3";
+                decoder.open(file);
+            }
+
+            decoder.getInfo(&result.mSampleRate, &result.mChannels, &result.mType);
+            decoder.readAll(result.mData);
+        }
+        catch(std::exception &e)
+        {
+            Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
+            result.mData.clear();
+        }
+        return result;
+    }
+
 
     const char *getSampleTypeName(SampleType type)
     {
@@ -1312,9 +1517,9 @@ namespace MWSound
         {
             for(SoundBufferRefPair &sndbuf : snd.second)
             {
-                mOutput->finishSound(sndbuf.first.get());
+                finishSound(sndbuf.first.get());
                 Sound_Buffer *sfx = sndbuf.second;
-                if(sfx->mUses-- == 1)
+                if(sfx->mUses-- == 1 && sfx->mHandle)
                     mUnusedBuffers.push_front(sfx);
             }
         }
@@ -7,6 +7,9 @@
 #include <deque>
 #include <map>
 #include <unordered_map>
+#include <vector>
+
+#include <osg/ref_ptr>
 
 #include <components/settings/settings.hpp>
 #include <components/misc/objectpool.hpp>
@@ -24,6 +27,11 @@ namespace VFS
     class Manager;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace ESM
 {
     struct Sound;
@@ -37,6 +45,9 @@ namespace MWSound
     class Sound;
     class Stream;
     class Sound_Buffer;
+    struct DecodedSound;
+    class DecodedSoundCache;
+    class DecodeSoundItem;
 
     enum Environment {
         Env_Normal,
@@ -82,6 +93,20 @@ namespace MWSound
         typedef std::deque<Sound_Buffer*> SoundList;
         SoundList mUnusedBuffers;
 
+        // Keeps decoded sounds to create buffers again without decoding after unloading
+        std::unique_ptr<DecodedSoundCache> mDecodedSoundCache;
+
+        bool mAsyncDecoding;
+        osg::ref_ptr<SceneUtil::WorkQueue> mDecodeQueue;
+
+        // Buffers without a handle being decoded in background
+        std::unordered_map<Sound_Buffer*, osg::ref_ptr<DecodeSoundItem>> mDecodingBuffers;
+
+        std::unordered_map<std::string, osg::ref_ptr<DecodeSoundItem>> mPreloadingSounds;
+
+        // Sounds to be played when their buffers are decoded, with the playback offset
+        std::unordered_map<const Sound*, float> mWaitingSounds;
+
         Misc::ObjectPool<Sound> mSounds;
 
         Misc::ObjectPool<Stream> mStreams;
@@ -125,7 +150,23 @@ namespace MWSound
         Sound_Buffer *insertSound(const std::string &soundId, const ESM::Sound *sound);
 
         Sound_Buffer *lookupSound(const std::string &soundId) const;
+        Sound_Buffer *findSound(const std::string &soundId);
         Sound_Buffer *loadSound(const std::string &soundId);
+        ///< \return buffer that is either loaded or being decoded, nullptr if there is no such sound.
+
+        std::shared_ptr<const DecodedSound> decodeSound(const std::string &fname);
+
+        bool loadBuffer(Sound_Buffer *sfx, const DecodedSound &sound);
+
+        void updateDecodedSounds();
+
+        bool startSound(Sound *sound, Sound_Buffer *sfx, float offset);
+        ///< Play \a sound or make it wait for \a sfx to be decoded.
+
+        void finishSound(Sound *sound);
+
+        bool isSoundPlaying(Sound *sound) const;
+        ///< Sound waiting to be decoded is treated as playing.
 
         // returns a decoder to start streaming, or nullptr if the sound was not found
         DecoderPtr loadVoice(const std::string &voicefile);
@@ -273,6 +314,8 @@ namespace MWSound
 
         void setListenerPosDir(const osg::Vec3f &pos, const osg::Vec3f &dir, const osg::Vec3f &up, bool underwater) override;
 
+        void preloadSounds(const std::vector<std::string>& soundIds) override;
+
         void updatePtr (const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated) override;
 
         void clear() override;
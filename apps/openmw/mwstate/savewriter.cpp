@@ -0,0 +1,83 @@
+#include "savewriter.hpp"
+
+#include <stdexcept>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+
+namespace MWState
+{
+    SaveWriter::SaveWriter()
+    : mDone (true)
+    {
+    }
+
+    SaveWriter::~SaveWriter()
+    {
+        const std::string error = wait();
+        if (!error.empty())
+            Log(Debug::Error) << "Failed to save game: " << error;
+    }
+
+    void SaveWriter::write (const boost::filesystem::path& path, std::string data)
+    {
+        if (isWriting())
+            throw std::logic_error("Saved game is already being written");
+
+        mDone = false;
+        mError.clear();
+        mThread = std::thread([this, path, data = std::move(data)] { run(path, data); });
+    }
+
+    bool SaveWriter::isWriting() const
+    {
+        return mThread.joinable();
+    }
+
+    bool SaveWriter::isDone() const
+    {
+        return mDone;
+    }
+
+    std::string SaveWriter::wait()
+    {
+        if (!isWriting())
+            return std::string();
+        mThread.join();
+        return std::move(mError);
+    }
+
+    void SaveWriter::run (const boost::filesystem::path& path, const std::string& data)
+    {
+        const auto tmpPath = path.parent_path() / boost::filesystem::unique_path("%%%%%%%%%%%%%%%%.tmp");
+
+        try
+        {
+            {
+                boost::filesystem::ofstream filestream (tmpPath, std::ios::binary);
+                if (!filestream.is_open())
+                    throw std::runtime_error("Failed to open file: " + tmpPath.string());
+
+                filestream.write(data.data(), static_cast<std::streamsize>(data.size()));
+                filestream.flush();
+
+                if (filestream.fail())
+                    throw std::runtime_error("Write operation failed (file stream)");
+            }
+
+            boost::filesystem::rename(tmpPath, path);
+        }
+        catch (const std::exception& e)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpPath, ec);
+            mError = e.what();
+            if (mError.empty())
+                mError = "Unknown error";
+        }
+
+        mDone = true;
+    }
+}
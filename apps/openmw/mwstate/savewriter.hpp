@@ -0,0 +1,50 @@
+#ifndef GAME_STATE_SAVEWRITER_H
+#define GAME_STATE_SAVEWRITER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem/path.hpp>
+
+namespace MWState
+{
+    /// @brief Writes serialized saved games to disk in a background thread.
+    ///
+    /// Data is written to a temporary file in the same directory which then replaces the target file, so an existing
+    /// saved game is not trashed if writing fails. Only one file is written at a time.
+    class SaveWriter
+    {
+        public:
+
+            SaveWriter();
+
+            ~SaveWriter();
+
+            void write (const boost::filesystem::path& path, std::string data);
+            ///< Start writing \a data to \a path.
+            ///
+            /// \note Previous write must be finished with wait().
+
+            bool isWriting() const;
+            ///< \return true if a write was started and wait() was not called yet.
+
+            bool isDone() const;
+            ///< \return true if wait() will not block.
+
+            std::string wait();
+            ///< Wait until the current write is done.
+            ///
+            /// \return error message or empty string on success.
+
+        private:
+
+            std::thread mThread;
+            std::atomic_bool mDone;
+            std::string mError;
+
+            void run (const boost::filesystem::path& path, const std::string& data);
+    };
+}
+
+#endif
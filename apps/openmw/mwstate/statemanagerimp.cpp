@@ -1,11 +1,19 @@
 #include "statemanagerimp.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <sstream>
+
 #include <components/debug/debuglog.hpp>
 
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/cellid.hpp>
 #include <components/esm/loadcell.hpp>
+#include <components/esm/compressedrecords.hpp>
+
+#include <components/files/memorystream.hpp>
 
 #include <components/loadinglistener/loadinglistener.hpp>
 
@@ -42,6 +50,8 @@
 
 void MWState::StateManager::cleanup (bool force)
 {
+    finishSaveGame(true);
+
     if (mState!=State_NoGame || force)
     {
         MWBase::Environment::get().getSoundManager()->clear();
@@ -56,6 +66,7 @@ void MWState::StateManager::cleanup (bool force)
         mState = State_NoGame;
         mCharacterManager.setCurrentCharacter(nullptr);
         mTimePlayed = 0;
+        mCompressedRecordsCache.clear();
 
         MWMechanics::CreatureStats::cleanup();
     }
@@ -88,12 +99,14 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
 
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, game), mTimePlayed (0)
+, mSaveCharacter (nullptr), mSaveSlot (nullptr)
 {
 
 }
 
 void MWState::StateManager::requestQuit()
 {
+    finishSaveGame(true);
     mQuitRequest = true;
 }
 
@@ -184,6 +197,10 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 {
     MWState::Character* character = getCurrentCharacter();
 
+    // Slots and characters are changed below, so the previous save has to be completed first.
+    // If the given slot was removed by a failed save, a new one is created instead.
+    slot = finishSaveGame(character, slot);
+
     try
     {
         if (!character)
@@ -239,7 +256,10 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         for (const std::string& contentFile : MWBase::Environment::get().getWorld()->getContentFiles())
             writer.addMaster(contentFile, 0); // not using the size information anyway -> use value of 0
 
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+        const bool compress = Settings::Manager::getBool("compress", "Saves");
+
+        // Older versions can load saved games without compressed records
+        writer.setFormat (compress ? ESM::SavedGame::sCurrentFormat : ESM::SavedGame::sUncompressedFormat);
 
         // all unused
         writer.setVersion(0);
@@ -247,37 +267,83 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         writer.setAuthor("");
         writer.setDescription("");
 
-        int recordCount =         1 // saved game header
-                +MWBase::Environment::get().getJournal()->countSavedGameRecords()
-                +MWBase::Environment::get().getWorld()->countSavedGameRecords()
-                +MWBase::Environment::get().getScriptManager()->getGlobalScripts().countSavedGameRecords()
-                +MWBase::Environment::get().getDialogueManager()->countSavedGameRecords()
-                +MWBase::Environment::get().getWindowManager()->countSavedGameRecords()
-                +MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords()
-                +MWBase::Environment::get().getInputManager()->countSavedGameRecords();
-        writer.setRecordCount (recordCount);
-
-        writer.save (stream);
-
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         int messagesCount = MWBase::Environment::get().getWindowManager()->getMessagesCount();
         // Using only Cells for progress information, since they typically have the largest records by far
         listener.setProgressRange(MWBase::Environment::get().getWorld()->countSavedGameCells());
         listener.setLabel("#{sNotifyMessage4}", true, messagesCount > 0);
 
+        // Records of each subsystem are stored as a separate group when compression is enabled
+        const std::vector<std::pair<int, std::function<void (ESM::ESMWriter&)>>> recordGroups {
+            {MWBase::Environment::get().getJournal()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getJournal()->write(groupWriter, listener); }},
+            {MWBase::Environment::get().getDialogueManager()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getDialogueManager()->write(groupWriter, listener); }},
+            {MWBase::Environment::get().getWorld()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getWorld()->write(groupWriter, listener); }},
+            {MWBase::Environment::get().getScriptManager()->getGlobalScripts().countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getScriptManager()->getGlobalScripts().write(groupWriter, listener); }},
+            {MWBase::Environment::get().getWindowManager()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getWindowManager()->write(groupWriter, listener); }},
+            {MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getMechanicsManager()->write(groupWriter, listener); }},
+            {MWBase::Environment::get().getInputManager()->countSavedGameRecords(),
+                [&] (ESM::ESMWriter& groupWriter) { MWBase::Environment::get().getInputManager()->write(groupWriter, listener); }},
+        };
+
+        int recordCount = 1; // saved game header
+        for (const auto& group : recordGroups)
+            recordCount += compress ? 1 : group.first;
+        writer.setRecordCount (recordCount);
+
+        writer.save (stream);
+
         Loading::ScopedLoad load(&listener);
 
         writer.startRecord (ESM::REC_SAVE);
         slot->mProfile.save (writer);
         writer.endRecord (ESM::REC_SAVE);
 
-        MWBase::Environment::get().getJournal()->write (writer, listener);
-        MWBase::Environment::get().getDialogueManager()->write (writer, listener);
-        MWBase::Environment::get().getWorld()->write (writer, listener);
-        MWBase::Environment::get().getScriptManager()->getGlobalScripts().write (writer, listener);
-        MWBase::Environment::get().getWindowManager()->write(writer, listener);
-        MWBase::Environment::get().getMechanicsManager()->write(writer, listener);
-        MWBase::Environment::get().getInputManager()->write(writer, listener);
+        mCompressedRecordsCache.resize(recordGroups.size());
+
+        for (std::size_t i = 0; i < recordGroups.size(); ++i)
+        {
+            const auto& group = recordGroups[i];
+
+            if (!compress)
+            {
+                group.second(writer);
+                continue;
+            }
+
+            std::stringstream groupStream;
+
+            ESM::ESMWriter groupWriter;
+            groupWriter.setFormat (ESM::SavedGame::sCurrentFormat);
+            groupWriter.setVersion(0);
+            groupWriter.setType(0);
+            groupWriter.setAuthor("");
+            groupWriter.setDescription("");
+            groupWriter.setRecordCount (group.first);
+            groupWriter.save (groupStream);
+
+            group.second(groupWriter);
+
+            if (groupWriter.getRecordCount() != group.first+1) // 1 extra for TES3 record
+                Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << group.first+1 << ", written: " << groupWriter.getRecordCount();
+
+            groupWriter.close();
+
+            if (groupStream.fail())
+                throw std::runtime_error("Write operation failed (memory stream)");
+
+            ESM::CompressedRecords records;
+            records.mData = groupStream.str();
+
+            writer.startRecord (ESM::REC_CMPR);
+            records.save (writer, mCompressedRecordsCache[i]);
+            writer.endRecord (ESM::REC_CMPR);
+        }
 
         // Ensure we have written the number of records that was estimated
         if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
@@ -288,34 +354,99 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
+        // All good, write to file in background. The file is replaced only when writing succeeds.
+        mSaveCharacter = character;
+        mSaveSlot = slot;
+        mSaveWriter.write(slot->mPath, stream.str());
+    }
+    catch (const std::exception& e)
+    {
+        reportSaveError(e.what(), character, slot);
+    }
+}
+
+void MWState::StateManager::finishSaveGame (bool wait)
+{
+    if (!mSaveWriter.isWriting() || (!wait && !mSaveWriter.isDone()))
+        return;
 
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+    const std::string error = mSaveWriter.wait();
 
-        Settings::Manager::setString ("character", "Saves",
-            slot->mPath.parent_path().filename().string());
+    Character* character = mSaveCharacter;
+    const Slot* slot = mSaveSlot;
+    mSaveCharacter = nullptr;
+    mSaveSlot = nullptr;
+
+    if (!error.empty())
+    {
+        reportSaveError(error, character, slot);
+        return;
     }
-    catch (const std::exception& e)
+
+    Settings::Manager::setString ("character", "Saves",
+        slot->mPath.parent_path().filename().string());
+}
+
+void MWState::StateManager::waitForSaveGame()
+{
+    finishSaveGame(true);
+}
+
+const MWState::Slot* MWState::StateManager::finishSaveGame (const Character* character, const Slot* slot)
+{
+    if (character == nullptr || slot == nullptr)
     {
-        std::stringstream error;
-        error << "Failed to save game: " << e.what();
+        finishSaveGame(true);
+        return slot;
+    }
 
-        Log(Debug::Error) << error.str();
+    const boost::filesystem::path path = slot->mPath;
 
-        std::vector<std::string> buttons;
-        buttons.emplace_back("#{sOk}");
-        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+    finishSaveGame(true);
 
-        // If no file was written, clean up the slot
-        if (character && slot && !boost::filesystem::exists(slot->mPath))
-        {
-            character->deleteSlot(slot);
-            character->cleanup();
-        }
+    const auto it = std::find_if(character->begin(), character->end(),
+        [&] (const Slot& existing) { return existing.mPath == path; });
+    return it == character->end() ? nullptr : &*it;
+}
+
+void MWState::StateManager::reportSaveError (const std::string& message, Character* character, const Slot* slot)
+{
+    std::stringstream error;
+    error << "Failed to save game: " << message;
+
+    Log(Debug::Error) << error.str();
+
+    // Message box may be dropped by menus, e.g. when save dialog is closed or a game is loaded
+    mSaveErrors.push_back(error.str());
+    if (!MWBase::Environment::get().getWindowManager()->isGuiMode())
+        showSaveErrors();
+
+    // If no file was written, clean up the slot
+    if (character && slot && !boost::filesystem::exists(slot->mPath))
+    {
+        character->deleteSlot(slot);
+        character->cleanup();
+    }
+}
+
+void MWState::StateManager::showSaveErrors()
+{
+    if (mSaveErrors.empty())
+        return;
+
+    // Only one interactive message box can be shown at a time
+    std::string message;
+    for (const std::string& error : mSaveErrors)
+    {
+        if (!message.empty())
+            message += '\n';
+        message += error;
     }
+    mSaveErrors.clear();
+
+    std::vector<std::string> buttons;
+    buttons.emplace_back("#{sOk}");
+    MWBase::Environment::get().getWindowManager()->interactiveMessageBox(message, buttons);
 }
 
 void MWState::StateManager::quickSave (std::string name)
@@ -368,6 +499,83 @@ void MWState::StateManager::loadGame(const std::string& filepath)
     loadGame(character, filepath);
 }
 
+void MWState::StateManager::readRecord (ESM::ESMReader& reader, const ESM::NAME& n,
+    const std::map<int, int>& contentFileMap, bool& firstPersonCam)
+{
+    switch (n.intval)
+    {
+        case ESM::REC_JOUR:
+        case ESM::REC_JOUR_LEGACY:
+        case ESM::REC_QUES:
+
+            MWBase::Environment::get().getJournal()->readRecord (reader, n.intval);
+            break;
+
+        case ESM::REC_DIAS:
+
+            MWBase::Environment::get().getDialogueManager()->readRecord (reader, n.intval);
+            break;
+
+        case ESM::REC_ALCH:
+        case ESM::REC_ARMO:
+        case ESM::REC_BOOK:
+        case ESM::REC_CLAS:
+        case ESM::REC_CLOT:
+        case ESM::REC_ENCH:
+        case ESM::REC_NPC_:
+        case ESM::REC_SPEL:
+        case ESM::REC_WEAP:
+        case ESM::REC_GLOB:
+        case ESM::REC_PLAY:
+        case ESM::REC_CSTA:
+        case ESM::REC_WTHR:
+        case ESM::REC_DYNA:
+        case ESM::REC_ACTC:
+        case ESM::REC_PROJ:
+        case ESM::REC_MPRJ:
+        case ESM::REC_ENAB:
+        case ESM::REC_LEVC:
+        case ESM::REC_LEVI:
+        case ESM::REC_CREA:
+        case ESM::REC_CONT:
+            MWBase::Environment::get().getWorld()->readRecord(reader, n.intval, contentFileMap);
+            break;
+
+        case ESM::REC_CAM_:
+            reader.getHNT(firstPersonCam, "FIRS");
+            break;
+
+        case ESM::REC_GSCR:
+
+            MWBase::Environment::get().getScriptManager()->getGlobalScripts().readRecord (reader, n.intval);
+            break;
+
+        case ESM::REC_GMAP:
+        case ESM::REC_KEYS:
+        case ESM::REC_ASPL:
+        case ESM::REC_MARK:
+
+            MWBase::Environment::get().getWindowManager()->readRecord(reader, n.intval);
+            break;
+
+        case ESM::REC_DCOU:
+        case ESM::REC_STLN:
+
+            MWBase::Environment::get().getMechanicsManager()->readRecord(reader, n.intval);
+            break;
+
+        case ESM::REC_INPU:
+            MWBase::Environment::get().getInputManager()->readRecord(reader, n.intval);
+            break;
+
+        default:
+
+            // ignore invalid records
+            Log(Debug::Warning) << "Warning: Ignoring unknown record: " << n.toString();
+            reader.skipRecord();
+    }
+}
+
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
     try
@@ -396,6 +604,15 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
 
         size_t total = reader.getFileSize();
         int currentPercent = 0;
+        const auto updateProgress = [&] (float offset)
+        {
+            int progressPercent = static_cast<int>(offset/total*100);
+            if (progressPercent > currentPercent)
+            {
+                listener.increaseProgress(progressPercent-currentPercent);
+                currentPercent = progressPercent;
+            }
+        };
         while (reader.hasMoreRecs())
         {
             ESM::NAME n = reader.getRecName();
@@ -418,82 +635,34 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                     }
                     break;
 
-                case ESM::REC_JOUR:
-                case ESM::REC_JOUR_LEGACY:
-                case ESM::REC_QUES:
-
-                    MWBase::Environment::get().getJournal()->readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_DIAS:
-
-                    MWBase::Environment::get().getDialogueManager()->readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_ALCH:
-                case ESM::REC_ARMO:
-                case ESM::REC_BOOK:
-                case ESM::REC_CLAS:
-                case ESM::REC_CLOT:
-                case ESM::REC_ENCH:
-                case ESM::REC_NPC_:
-                case ESM::REC_SPEL:
-                case ESM::REC_WEAP:
-                case ESM::REC_GLOB:
-                case ESM::REC_PLAY:
-                case ESM::REC_CSTA:
-                case ESM::REC_WTHR:
-                case ESM::REC_DYNA:
-                case ESM::REC_ACTC:
-                case ESM::REC_PROJ:
-                case ESM::REC_MPRJ:
-                case ESM::REC_ENAB:
-                case ESM::REC_LEVC:
-                case ESM::REC_LEVI:
-                case ESM::REC_CREA:
-                case ESM::REC_CONT:
-                    MWBase::Environment::get().getWorld()->readRecord(reader, n.intval, contentFileMap);
-                    break;
-
-                case ESM::REC_CAM_:
-                    reader.getHNT(firstPersonCam, "FIRS");
-                    break;
-
-                case ESM::REC_GSCR:
-
-                    MWBase::Environment::get().getScriptManager()->getGlobalScripts().readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_GMAP:
-                case ESM::REC_KEYS:
-                case ESM::REC_ASPL:
-                case ESM::REC_MARK:
-
-                    MWBase::Environment::get().getWindowManager()->readRecord(reader, n.intval);
-                    break;
-
-                case ESM::REC_DCOU:
-                case ESM::REC_STLN:
+                case ESM::REC_CMPR:
+                    {
+                        const size_t groupBegin = reader.getFileOffset();
+                        ESM::CompressedRecords records;
+                        records.load(reader);
+                        const size_t groupSize = reader.getFileOffset() - groupBegin;
 
-                    MWBase::Environment::get().getMechanicsManager()->readRecord(reader, n.intval);
-                    break;
+                        // Stream reads the data in place, records have to outlive the reader
+                        ESM::ESMReader groupReader;
+                        groupReader.open(std::make_shared<Files::IMemStream>(records.mData.data(), records.mData.size()),
+                                         reader.getName());
 
-                case ESM::REC_INPU:
-                    MWBase::Environment::get().getInputManager()->readRecord(reader, n.intval);
+                        while (groupReader.hasMoreRecs())
+                        {
+                            ESM::NAME groupRecordName = groupReader.getRecName();
+                            groupReader.getRecHeader();
+                            readRecord(groupReader, groupRecordName, contentFileMap, firstPersonCam);
+                            // Spread progress of the group over its compressed size in the file
+                            updateProgress(groupBegin + float(groupReader.getFileOffset()) / records.mData.size() * groupSize);
+                        }
+                    }
                     break;
 
                 default:
 
-                    // ignore invalid records
-                    Log(Debug::Warning) << "Warning: Ignoring unknown record: " << n.toString();
-                    reader.skipRecord();
-            }
-            int progressPercent = static_cast<int>(float(reader.getFileOffset())/total*100);
-            if (progressPercent > currentPercent)
-            {
-                listener.increaseProgress(progressPercent-currentPercent);
-                currentPercent = progressPercent;
+                    readRecord(reader, n, contentFileMap, firstPersonCam);
             }
+            updateProgress(reader.getFileOffset());
         }
 
         mCharacterManager.setCurrentCharacter(character);
@@ -575,7 +744,9 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
-    mCharacterManager.deleteSlot(character, slot);
+    slot = finishSaveGame(character, slot);
+    if (slot)
+        mCharacterManager.deleteSlot(character, slot);
 }
 
 MWState::Character *MWState::StateManager::getCurrentCharacter ()
@@ -597,6 +768,13 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    // Menus may hold pointers to slots, which are invalidated when a failed save deletes its slot
+    if (!MWBase::Environment::get().getWindowManager()->isGuiMode())
+    {
+        finishSaveGame(false);
+        showSaveErrors();
+    }
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -2,12 +2,17 @@
 #define GAME_STATE_STATEMANAGER_H
 
 #include <map>
+#include <vector>
 
 #include "../mwbase/statemanager.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <components/esm/compressedrecords.hpp>
+#include <components/esm/esmcommon.hpp>
+
 #include "charactermanager.hpp"
+#include "savewriter.hpp"
 
 namespace MWState
 {
@@ -18,6 +23,11 @@ namespace MWState
             State mState;
             CharacterManager mCharacterManager;
             double mTimePlayed;
+            SaveWriter mSaveWriter;
+            Character* mSaveCharacter;
+            const Slot* mSaveSlot;
+            std::vector<ESM::CompressedRecordsCache> mCompressedRecordsCache;
+            std::vector<std::string> mSaveErrors;
 
         private:
 
@@ -29,6 +39,26 @@ namespace MWState
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
+            void readRecord (ESM::ESMReader& reader, const ESM::NAME& n, const std::map<int, int>& contentFileMap,
+                bool& firstPersonCam);
+            ///< Read a saved game record other than the saved game header.
+
+            void finishSaveGame (bool wait);
+            ///< Report the result of the saved game being written in background.
+            ///
+            /// \param wait Block until the file is written, otherwise do nothing if writing is still in progress.
+
+            const Slot* finishSaveGame (const Character* character, const Slot* slot);
+            ///< Wait until the saved game being written in background is completed.
+            ///
+            /// A failed save deletes its slot, which invalidates pointers to other slots of the same character.
+            /// \return \a slot of \a character found again by its path or nullptr if the slot was deleted.
+
+            void reportSaveError (const std::string& message, Character* character, const Slot* slot);
+            ///< Message box is shown only outside of GUI mode, otherwise it's queued until GUI mode ends.
+
+            void showSaveErrors();
+
         public:
 
             StateManager (const boost::filesystem::path& saves, const std::string& game);
@@ -58,6 +88,8 @@ namespace MWState
             ///
             /// \note Slot must belong to the current character.
 
+            void waitForSaveGame() override;
+
             ///Saves a file, using supplied filename, overwritting if needed
             /** This is mostly used for quicksaving and autosaving, for they use the same name over and over again
                 \param name Name of save, defaults to "Quicksave"**/
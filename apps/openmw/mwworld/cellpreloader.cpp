@@ -17,6 +17,7 @@
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
+#include "../mwbase/soundmanager.hpp"
 
 #include "../mwrender/landmanager.hpp"
 
@@ -27,23 +28,26 @@
 namespace MWWorld
 {
 
-    struct ListModelsVisitor
+    struct ListResourcesVisitor
     {
-        ListModelsVisitor(std::vector<std::string>& out)
-            : mOut(out)
+        ListResourcesVisitor(std::vector<std::string>& models, std::vector<std::string>& sounds)
+            : mModels(models)
+            , mSounds(sounds)
         {
         }
 
         virtual bool operator()(const MWWorld::Ptr& ptr)
         {
-            ptr.getClass().getModelsToPreload(ptr, mOut);
+            ptr.getClass().getModelsToPreload(ptr, mModels);
+            ptr.getClass().getSoundsToPreload(ptr, mSounds);
 
             return true;
         }
 
-        virtual ~ListModelsVisitor() = default;
+        virtual ~ListResourcesVisitor() = default;
 
-        std::vector<std::string>& mOut;
+        std::vector<std::string>& mModels;
+        std::vector<std::string>& mSounds;
     };
 
     /// Worker thread item: preload models in a cell.
@@ -65,8 +69,12 @@ namespace MWWorld
         {
             mTerrainView = mTerrain->createView();
 
-            ListModelsVisitor visitor (mMeshes);
+            std::vector<std::string> sounds;
+            ListResourcesVisitor visitor (mMeshes, sounds);
             cell->forEach(visitor);
+
+            // Sounds are decoded by the sound manager's own thread
+            MWBase::Environment::get().getSoundManager()->preloadSounds(sounds);
         }
 
         void abort() override
@@ -253,7 +261,7 @@ namespace MWWorld
         }
 
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
-            it->second.mWorkItem->abort();
+            it->second.mWorkItem->cancel();
 
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
             it->second.mWorkItem->waitTillDone();
@@ -299,7 +307,7 @@ namespace MWWorld
 
             if (oldestTimestamp + threshold < timestamp)
             {
-                oldestCell->second.mWorkItem->abort();
+                oldestCell->second.mWorkItem->cancel();
                 mPreloadCells.erase(oldestCell);
             }
             else
@@ -320,7 +328,7 @@ namespace MWWorld
             // do the deletion in the background thread
             if (found->second.mWorkItem)
             {
-                found->second.mWorkItem->abort();
+                found->second.mWorkItem->cancel();
                 mUnrefQueue->push(mPreloadCells[cell].mWorkItem);
             }
 
@@ -334,7 +342,7 @@ namespace MWWorld
         {
             if (it->second.mWorkItem)
             {
-                it->second.mWorkItem->abort();
+                it->second.mWorkItem->cancel();
                 mUnrefQueue->push(it->second.mWorkItem);
             }
 
@@ -348,9 +356,10 @@ namespace MWWorld
         {
             if (mPreloadCells.size() >= mMinCacheSize && it->second.mTimeStamp < timestamp - mExpiryDelay)
             {
+                // The player has moved away, don't start the preloading if it's still queued
                 if (it->second.mWorkItem)
                 {
-                    it->second.mWorkItem->abort();
+                    it->second.mWorkItem->cancel();
                     mUnrefQueue->push(it->second.mWorkItem);
                 }
                 mPreloadCells.erase(it++);
@@ -0,0 +1,75 @@
+#include "cellrefindex.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/loadcell.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace MWWorld
+{
+    void readCellRefs(const ESM::Cell& cell, std::size_t index, ESM::ESMReader& esm,
+                      std::vector<CellRefIndex::Ref>* refs, const CellRefFunction& function)
+    {
+        // Reopen the ESM reader and seek to the right position.
+        cell.restore (esm, static_cast<int>(index));
+
+        ESM::CellRef ref;
+        ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+
+        // Get each reference in turn
+        bool deleted = false;
+        while (true)
+        {
+            const ESM::ESM_Context context = esm.getContext();
+
+            if (!cell.getNextRef (esm, ref, deleted))
+                break;
+
+            // Don't use reference if it was moved to a different cell.
+            const bool moved = std::find(cell.mMovedRefs.begin(), cell.mMovedRefs.end(), ref.mRefNum)
+                != cell.mMovedRefs.end();
+
+            if (refs != nullptr)
+                refs->push_back(CellRefIndex::Ref {ref.mRefNum, Misc::StringUtils::lowerCase(ref.mRefID), deleted, moved,
+                    context.filePos, context.leftRec, context.subCached, context.subName});
+
+            if (!moved)
+                function(ref, deleted);
+        }
+    }
+
+    void readIndexedCellRefs(const ESM::Cell& cell, std::size_t index, ESM::ESMReader& esm,
+                             const std::vector<CellRefIndex::Ref>& refs, const CellRefFunction& function)
+    {
+        ESM::ESM_Context context = cell.mContextList.at(index);
+        ESM::CellRef ref;
+        bool deleted = false;
+        // Only seek when the previous reference was skipped, otherwise the reader is already in place
+        bool positioned = false;
+        for (const CellRefIndex::Ref& indexedRef : refs)
+        {
+            if (indexedRef.mMoved)
+            {
+                positioned = false;
+                continue;
+            }
+
+            if (!positioned)
+            {
+                context.filePos = indexedRef.mFilePos;
+                context.leftRec = indexedRef.mLeftRec;
+                context.subCached = indexedRef.mSubCached;
+                context.subName = indexedRef.mSubName;
+                esm.restoreContext(context);
+                positioned = true;
+            }
+
+            if (!cell.getNextRef(esm, ref, deleted))
+                throw std::runtime_error("Indexed reference is not found");
+
+            function(ref, deleted);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef GAME_MWWORLD_CELLREFINDEX_H
+#define GAME_MWWORLD_CELLREFINDEX_H
+
+#include <components/esm/cellref.hpp>
+#include <components/esm/esmcommon.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    class ESMReader;
+    struct Cell;
+}
+
+namespace MWWorld
+{
+    /// \brief Locations of the references of a cell in content files
+    ///
+    /// Recorded the first time the references of a cell are read, so listing them doesn't require reading the content
+    /// files again and loading them can jump over references that are not needed. Kept outside of CellStore, so it
+    /// stays valid when the game is reloaded.
+    struct CellRefIndex
+    {
+        struct Ref
+        {
+            ESM::RefNum mRefNum;
+            std::string mRefId; ///< lower case
+            bool mDeleted;
+            bool mMoved; ///< moved to a different cell, in which case it is loaded from ESM::Cell::mLeasedRefs of that cell
+            std::size_t mFilePos;
+            std::uint32_t mLeftRec;
+            bool mSubCached;
+            ESM::NAME mSubName;
+        };
+
+        struct Context
+        {
+            bool mComplete = false;
+            std::vector<Ref> mRefs;
+        };
+
+        /// Elements match ESM::Cell::mContextList
+        std::vector<Context> mContexts;
+    };
+
+    using CellRefFunction = std::function<void (ESM::CellRef& ref, bool deleted)>;
+
+    /// Read all references of content file context \a index of \a cell. \a function is called for each reference that
+    /// was not moved to a different cell. Locations of all references are stored in \a refs unless it is nullptr.
+    void readCellRefs(const ESM::Cell& cell, std::size_t index, ESM::ESMReader& esm,
+                      std::vector<CellRefIndex::Ref>* refs, const CellRefFunction& function);
+
+    /// Read references of content file context \a index of \a cell at locations stored in \a refs by readCellRefs.
+    /// Moved references are skipped without being read, \a function is called for the rest.
+    void readIndexedCellRefs(const ESM::Cell& cell, std::size_t index, ESM::ESMReader& esm,
+                             const std::vector<CellRefIndex::Ref>& refs, const CellRefFunction& function);
+}
+
+#endif
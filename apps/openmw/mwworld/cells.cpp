@@ -60,6 +60,14 @@ namespace
     };
 }
 
+MWWorld::CellStore MWWorld::Cells::makeCellStore (const ESM::Cell *cell)
+{
+    // Dynamically generated cells have no references in content files
+    if (cell->mContextList.empty())
+        return CellStore (cell, mStore, mReader);
+    return CellStore (cell, mStore, mReader, &mRefIndices[cell]);
+}
+
 MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
 {
     if (cell->mData.mFlags & ESM::Cell::Interior)
@@ -69,7 +77,7 @@ MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
 
         if (result==mInteriors.end())
         {
-            result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mReader))).first;
+            result = mInteriors.insert (std::make_pair (lowerName, makeCellStore (cell))).first;
         }
 
         return &result->second;
@@ -82,7 +90,7 @@ MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
         if (result==mExteriors.end())
         {
             result = mExteriors.insert (std::make_pair (
-                std::make_pair (cell->getGridX(), cell->getGridY()), CellStore (cell, mStore, mReader))).first;
+                std::make_pair (cell->getGridX(), cell->getGridY()), makeCellStore (cell))).first;
 
         }
 
@@ -164,7 +172,7 @@ MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
         }
 
         result = mExteriors.insert (std::make_pair (
-            std::make_pair (x, y), CellStore (cell, mStore, mReader))).first;
+            std::make_pair (x, y), makeCellStore (cell))).first;
     }
 
     if (result->second.getState()!=CellStore::State_Loaded)
@@ -184,7 +192,7 @@ MWWorld::CellStore *MWWorld::Cells::getInterior (const std::string& name)
     {
         const ESM::Cell *cell = mStore.get<ESM::Cell>().find(lowerName);
 
-        result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mReader))).first;
+        result = mInteriors.insert (std::make_pair (lowerName, makeCellStore (cell))).first;
     }
 
     if (result->second.getState()!=CellStore::State_Loaded)
@@ -24,6 +24,7 @@ namespace Loading
 namespace MWWorld
 {
     class ESMStore;
+    struct CellRefIndex;
 
     /// \brief Cell container
     class Cells
@@ -34,12 +35,15 @@ namespace MWWorld
             mutable std::map<std::pair<int, int>, CellStore> mExteriors;
             std::vector<std::pair<std::string, CellStore *> > mIdCache;
             std::size_t mIdCacheIndex;
+            std::map<const ESM::Cell*, CellRefIndex> mRefIndices;
 
             Cells (const Cells&);
             Cells& operator= (const Cells&);
 
             CellStore *getCellStore (const ESM::Cell *cell);
 
+            CellStore makeCellStore (const ESM::Cell *cell);
+
             Ptr getPtrAndCache (const std::string& name, CellStore& cellStore);
 
             Ptr getPtr(CellStore& cellStore, const std::string& id, const ESM::RefNum& refNum);
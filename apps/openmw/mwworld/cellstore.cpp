@@ -334,8 +334,9 @@ namespace MWWorld
         return false;
     }
 
-    CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList)
-        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0), mRechargingItemsUpToDate(false)
+    CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList,
+                          CellRefIndex* refIndex)
+        : mStore(esmStore), mReader(readerList), mCell (cell), mRefIndex(refIndex), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0), mRechargingItemsUpToDate(false)
     {
         mWaterLevel = cell->mWater;
     }
@@ -490,10 +491,33 @@ namespace MWWorld
         }
     }
 
-    void CellStore::listRefs()
+    void CellStore::readRefs(std::size_t index, const CellRefFunction& function)
     {
-        std::vector<ESM::ESMReader>& esm = mReader;
+        ESM::ESMReader& esm = mReader[mCell->mContextList.at(index).index];
+
+        if (mRefIndex == nullptr)
+        {
+            readCellRefs(*mCell, index, esm, nullptr, function);
+            return;
+        }
 
+        std::vector<CellRefIndex::Ref> refs;
+        readCellRefs(*mCell, index, esm, &refs, function);
+
+        mRefIndex->mContexts.resize(mCell->mContextList.size());
+        mRefIndex->mContexts[index].mRefs = std::move(refs);
+        mRefIndex->mContexts[index].mComplete = true;
+    }
+
+    const CellRefIndex::Context* CellStore::getIndexedRefs(std::size_t index) const
+    {
+        if (mRefIndex == nullptr || index >= mRefIndex->mContexts.size() || !mRefIndex->mContexts[index].mComplete)
+            return nullptr;
+        return &mRefIndex->mContexts[index];
+    }
+
+    void CellStore::listRefs()
+    {
         assert (mCell);
 
         if (mCell->mContextList.empty())
@@ -504,28 +528,19 @@ namespace MWWorld
         {
             try
             {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
-
-                ESM::CellRef ref;
-
-                // Get each reference in turn
-                bool deleted = false;
-                while (mCell->getNextRef (esm[index], ref, deleted))
+                if (const CellRefIndex::Context* indexed = getIndexedRefs(i))
                 {
-                    if (deleted)
-                        continue;
-
-                    // Don't list reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
-
-                    mIds.push_back (Misc::StringUtils::lowerCase (ref.mRefID));
+                    for (const CellRefIndex::Ref& ref : indexed->mRefs)
+                        if (!ref.mDeleted && !ref.mMoved)
+                            mIds.push_back (ref.mRefId);
+                    continue;
                 }
+
+                readRefs(i, [&] (const ESM::CellRef& ref, bool deleted)
+                {
+                    if (!deleted)
+                        mIds.push_back (Misc::StringUtils::lowerCase (ref.mRefID));
+                });
             }
             catch (std::exception& e)
             {
@@ -562,26 +577,20 @@ namespace MWWorld
         {
             try
             {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
-
-                ESM::CellRef ref;
-                ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
-
-                // Get each reference in turn
-                bool deleted = false;
-                while(mCell->getNextRef(esm[index], ref, deleted))
+                if (const CellRefIndex::Context* indexed = getIndexedRefs(i))
                 {
-                    // Don't load reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
+                    readIndexedCellRefs(*mCell, i, esm[mCell->mContextList[i].index], indexed->mRefs,
+                        [&] (ESM::CellRef& ref, bool deleted)
+                    {
+                        loadRef (ref, deleted, refNumToID);
+                    });
+                    continue;
+                }
 
+                readRefs(i, [&] (ESM::CellRef& ref, bool deleted)
+                {
                     loadRef (ref, deleted, refNumToID);
-                }
+                });
             }
             catch (std::exception& e)
             {
@@ -34,6 +34,7 @@
 
 #include "timestamp.hpp"
 #include "ptr.hpp"
+#include "cellrefindex.hpp"
 
 namespace ESM
 {
@@ -69,6 +70,7 @@ namespace MWWorld
             std::shared_ptr<ESM::FogState> mFogState;
 
             const ESM::Cell *mCell;
+            CellRefIndex *mRefIndex;
             State mState;
             bool mHasState;
             std::vector<std::string> mIds;
@@ -211,9 +213,11 @@ namespace MWWorld
             }
 
             /// @param readerList The readers to use for loading of the cell on-demand.
+            /// @param refIndex Where to keep locations of the references in content files, may be nullptr.
             CellStore (const ESM::Cell *cell_,
                        const MWWorld::ESMStore& store,
-                       std::vector<ESM::ESMReader>& readerList);
+                       std::vector<ESM::ESMReader>& readerList,
+                       CellRefIndex* refIndex = nullptr);
 
             const ESM::Cell *getCell() const;
 
@@ -402,6 +406,12 @@ namespace MWWorld
             /// Run through references and store IDs
             void listRefs();
 
+            /// Read references of content file context \a index without using mRefIndex and record them there.
+            /// \a function is called for each reference that was not moved to a different cell.
+            void readRefs(std::size_t index, const CellRefFunction& function);
+
+            const CellRefIndex::Context* getIndexedRefs(std::size_t index) const;
+
             void loadRefs();
 
             void loadRef (ESM::CellRef& ref, bool deleted, std::map<ESM::RefNum, std::string>& refNumToID);
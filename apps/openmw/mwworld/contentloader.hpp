@@ -27,6 +27,11 @@ struct ContentLoader
         mListener.setLabel(MyGUI::TextIterator::toTagsString(filepath.string()));
     }
 
+    /// Called once after load was called for all content files, loaders deferring work must complete it here
+    virtual void finish()
+    {
+    }
+
     protected:
         Loading::Listener& mListener;
 };
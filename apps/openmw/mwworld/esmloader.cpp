@@ -2,6 +2,9 @@
 #include "esmstore.hpp"
 
 #include <components/esm/esmreader.hpp>
+#include <components/settings/settings.hpp>
+
+#include "../mwmechanics/taskscheduler.hpp"
 
 namespace MWWorld
 {
@@ -12,9 +15,12 @@ EsmLoader::EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& read
   , mEsm(readers)
   , mStore(store)
   , mEncoder(encoder)
+  , mTaskScheduler(std::make_unique<MWMechanics::TaskScheduler>(Settings::Manager::getInt("content loading threads", "Game")))
 {
 }
 
+EsmLoader::~EsmLoader() = default;
+
 void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
 {
   ContentLoader::load(filepath.filename(), index);
@@ -23,9 +29,27 @@ void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
   lEsm.setEncoder(mEncoder);
   lEsm.setIndex(index);
   lEsm.setGlobalReaderList(&mEsm);
-  lEsm.open(filepath.string());
+  lEsm.openMapped(filepath.string());
   mEsm[index] = lEsm;
-  mStore.load(mEsm[index], &mListener);
+
+  if (mTaskScheduler->getNumThreads() > 0)
+    mPending.push_back(index);
+  else
+    mStore.load(mEsm[index], &mListener);
+}
+
+void EsmLoader::finish()
+{
+  if (mPending.empty())
+    return;
+
+  std::vector<ESM::ESMReader*> readers;
+  readers.reserve(mPending.size());
+  for (int index : mPending)
+    readers.push_back(&mEsm[index]);
+  mPending.clear();
+
+  mStore.load(readers, &mListener, *mTaskScheduler);
 }
 
 } /* namespace MWWorld */
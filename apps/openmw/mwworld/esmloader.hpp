@@ -1,6 +1,7 @@
 #ifndef ESMLOADER_HPP
 #define ESMLOADER_HPP
 
+#include <memory>
 #include <vector>
 
 #include "contentloader.hpp"
@@ -15,6 +16,11 @@ namespace ESM
     class ESMReader;
 }
 
+namespace MWMechanics
+{
+    class TaskScheduler;
+}
+
 namespace MWWorld
 {
 
@@ -24,13 +30,19 @@ struct EsmLoader : public ContentLoader
 {
     EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
       ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener);
+    ~EsmLoader();
 
     void load(const boost::filesystem::path& filepath, int& index) override;
 
+    void finish() override;
+
     private:
       std::vector<ESM::ESMReader>& mEsm;
       MWWorld::ESMStore& mStore;
       ToUTF8::Utf8Encoder* mEncoder;
+      std::unique_ptr<MWMechanics::TaskScheduler> mTaskScheduler;
+      // Indices of opened files to be loaded together by finish when loading in parallel
+      std::vector<int> mPending;
 };
 
 } /* namespace MWWorld */
@@ -1,6 +1,9 @@
 #include "esmstore.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <set>
+#include <thread>
 
 #include <boost/filesystem/operations.hpp>
 
@@ -8,8 +11,10 @@
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
+#include <components/to_utf8/to_utf8.hpp>
 
 #include "../mwmechanics/spelllist.hpp"
+#include "../mwmechanics/taskscheduler.hpp"
 
 namespace
 {
@@ -67,12 +72,8 @@ static bool isCacheableRecord(int id)
     return false;
 }
 
-void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
+void ESMStore::prepareLoad(ESM::ESMReader &esm)
 {
-    listener->setProgressRange(1000);
-
-    ESM::Dialogue *dialogue = nullptr;
-
     // Land texture loading needs to use a separate internal store for each plugin.
     // We set the number of plugins here to avoid continual resizes during loading,
     // and so we can properly verify if valid plugin indices are being passed to the
@@ -106,6 +107,21 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
         }
         esm.addParentFileIndex(index);
     }
+}
+
+void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener, MWMechanics::TaskScheduler* taskScheduler)
+{
+    if (taskScheduler != nullptr && taskScheduler->getNumThreads() > 0)
+    {
+        load(std::vector<ESM::ESMReader*> {&esm}, listener, *taskScheduler);
+        return;
+    }
+
+    listener->setProgressRange(1000);
+
+    prepareLoad(esm);
+
+    ESM::Dialogue *dialogue = nullptr;
 
     // Loop through all records
     while(esm.hasMoreRecs())
@@ -113,50 +129,191 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
         ESM::NAME n = esm.getRecName();
         esm.getRecHeader();
 
-        // Look up the record type.
-        std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
+        loadRecord(esm, n, dialogue);
 
-        if (it == mStores.end()) {
-            if (n.intval == ESM::REC_INFO) {
-                if (dialogue)
-                {
-                    dialogue->readInfo(esm, esm.getIndex() != 0);
-                }
-                else
-                {
-                    Log(Debug::Error) << "Error: info record without dialog";
-                    esm.skipRecord();
-                }
-            } else if (n.intval == ESM::REC_MGEF) {
-                mMagicEffects.load (esm);
-            } else if (n.intval == ESM::REC_SKIL) {
-                mSkills.load (esm);
+        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+    }
+}
+
+void ESMStore::loadRecord(ESM::ESMReader &esm, ESM::NAME name, ESM::Dialogue*& dialogue)
+{
+    // Look up the record type.
+    std::map<int, StoreBase *>::iterator it = mStores.find(name.intval);
+
+    if (it == mStores.end()) {
+        if (name.intval == ESM::REC_INFO) {
+            if (dialogue)
+            {
+                dialogue->readInfo(esm, esm.getIndex() != 0);
             }
-            else if (n.intval==ESM::REC_FILT || n.intval == ESM::REC_DBGP)
+            else
             {
-                // ignore project file only records
+                Log(Debug::Error) << "Error: info record without dialog";
                 esm.skipRecord();
             }
-            else {
-                std::stringstream error;
-                error << "Unknown record: " << n.toString();
-                throw std::runtime_error(error.str());
+        } else if (name.intval == ESM::REC_MGEF) {
+            mMagicEffects.load (esm);
+        } else if (name.intval == ESM::REC_SKIL) {
+            mSkills.load (esm);
+        }
+        else if (name.intval==ESM::REC_FILT || name.intval == ESM::REC_DBGP)
+        {
+            // ignore project file only records
+            esm.skipRecord();
+        }
+        else {
+            std::stringstream error;
+            error << "Unknown record: " << name.toString();
+            throw std::runtime_error(error.str());
+        }
+    } else {
+        onRecordLoaded(*it->second, name, it->second->load(esm), dialogue);
+    }
+}
+
+void ESMStore::onRecordLoaded(StoreBase& store, ESM::NAME name, const RecordId& id, ESM::Dialogue*& dialogue)
+{
+    if (id.mIsDeleted)
+    {
+        store.eraseStatic(id.mId);
+        return;
+    }
+
+    if (name.intval==ESM::REC_DIAL) {
+        dialogue = const_cast<ESM::Dialogue*>(mDialogs.find(id.mId));
+    } else {
+        dialogue = nullptr;
+    }
+}
+
+void ESMStore::load(const std::vector<ESM::ESMReader*>& readers, Loading::Listener* listener,
+    MWMechanics::TaskScheduler& taskScheduler)
+{
+    struct Record
+    {
+        ESM::ESM_Context mContext;
+        ESM::NAME mName;
+        StoreBase* mStore;
+        std::unique_ptr<StoreBase::DecodedRecord> mDecoded;
+    };
+
+    struct File
+    {
+        ESM::ESMReader* mReader;
+        std::vector<Record> mRecords;
+        ESM::ESM_Context mEnd;
+    };
+
+    struct Job
+    {
+        File* mFile;
+        std::size_t mBegin;
+        std::size_t mSize;
+    };
+
+    // Progress is reported for each of the three passes
+    constexpr std::size_t progressPerPass = 1000;
+    listener->setProgressRange(3 * progressPerPass);
+
+    std::size_t totalFileSize = 0;
+    for (const ESM::ESMReader* esm : readers)
+        totalFileSize += esm->getFileSize();
+
+    // First pass reads only record headers to find where each record starts
+    std::vector<File> files;
+    files.reserve(readers.size());
+    std::size_t scannedFileSize = 0;
+    std::size_t totalRecords = 0;
+    for (ESM::ESMReader* esm : readers)
+    {
+        prepareLoad(*esm);
+
+        File& file = files.emplace_back(File {esm, {}, {}});
+        while (esm->hasMoreRecs())
+        {
+            ESM::ESM_Context context = esm->getContext();
+            ESM::NAME n = esm->getRecName();
+            esm->getRecHeader();
+            esm->skipRecord();
+
+            std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
+            file.mRecords.push_back(Record {std::move(context), n, it == mStores.end() ? nullptr : it->second, nullptr});
+
+            listener->setProgress((scannedFileSize + esm->getFileOffset()) * progressPerPass / std::max<std::size_t>(totalFileSize, 1));
+        }
+        file.mEnd = esm->getContext();
+        scannedFileSize += esm->getFileSize();
+        totalRecords += file.mRecords.size();
+    }
+
+    // Second pass reads records of all files into memory on multiple threads, each job with its own reader
+    constexpr std::size_t recordsPerJob = 1024;
+    std::vector<Job> jobs;
+    for (File& file : files)
+        for (std::size_t begin = 0; begin < file.mRecords.size(); begin += recordsPerJob)
+            jobs.push_back(Job {&file, begin, std::min(recordsPerJob, file.mRecords.size() - begin)});
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<std::size_t> decodedRecords {0};
+    taskScheduler.run(jobs.size(), [&] (std::size_t index)
+    {
+        const Job& job = jobs[index];
+
+        std::unique_ptr<ToUTF8::Utf8Encoder> jobEncoder;
+        ESM::ESMReader reader;
+        if (const ToUTF8::Utf8Encoder* encoder = job.mFile->mReader->getEncoder())
+        {
+            // encoder is not thread safe
+            jobEncoder = std::make_unique<ToUTF8::Utf8Encoder>(encoder->getEncoding());
+            reader.setEncoder(jobEncoder.get());
+        }
+        reader.openMapped(job.mFile->mRecords[job.mBegin].mContext.filename);
+        reader.restoreContext(job.mFile->mRecords[job.mBegin].mContext);
+
+        for (std::size_t i = job.mBegin; i < job.mBegin + job.mSize; ++i)
+        {
+            Record& record = job.mFile->mRecords[i];
+            reader.getRecName();
+            reader.getRecHeader();
+            if (record.mStore != nullptr)
+                record.mDecoded = record.mStore->decode(reader);
+            reader.skipRecord();
+        }
+
+        const std::size_t decoded = decodedRecords += job.mSize;
+
+        // Loading screen can be updated only by the main thread, it takes jobs as well
+        if (std::this_thread::get_id() == mainThread)
+            listener->setProgress(progressPerPass + decoded * progressPerPass / std::max<std::size_t>(totalRecords, 1));
+    });
+
+    // Third pass adds records to the stores in the order of files and records in a file, records that depend
+    // on already loaded records are read at this point
+    std::size_t appliedRecords = 0;
+    for (File& file : files)
+    {
+        ESM::ESMReader& esm = *file.mReader;
+        ESM::Dialogue *dialogue = nullptr;
+        for (Record& record : file.mRecords)
+        {
+            if (record.mDecoded != nullptr)
+            {
+                onRecordLoaded(*record.mStore, record.mName, record.mStore->apply(*record.mDecoded), dialogue);
+                record.mDecoded.reset();
             }
-        } else {
-            RecordId id = it->second->load(esm);
-            if (id.mIsDeleted)
+            else
             {
-                it->second->eraseStatic(id.mId);
-                continue;
+                esm.restoreContext(record.mContext);
+                ESM::NAME n = esm.getRecName();
+                esm.getRecHeader();
+                loadRecord(esm, n, dialogue);
             }
 
-            if (n.intval==ESM::REC_DIAL) {
-                dialogue = const_cast<ESM::Dialogue*>(mDialogs.find(id.mId));
-            } else {
-                dialogue = nullptr;
-            }
+            ++appliedRecords;
+            listener->setProgress(2 * progressPerPass + appliedRecords * progressPerPass / std::max<std::size_t>(totalRecords, 1));
         }
-        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+
+        esm.restoreContext(file.mEnd);
     }
 }
 
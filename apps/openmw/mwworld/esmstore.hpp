@@ -4,6 +4,7 @@
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <components/esm/records.hpp>
 #include "store.hpp"
@@ -16,6 +17,7 @@ namespace Loading
 namespace MWMechanics
 {
     class SpellList;
+    class TaskScheduler;
 }
 
 namespace MWWorld
@@ -73,8 +75,8 @@ namespace MWWorld
 
         // Lookup of all IDs. Makes looking up references faster. Just
         // maps the id name to the record type.
-        std::map<std::string, int> mIds;
-        std::map<std::string, int> mStaticIds;
+        std::unordered_map<std::string, int> mIds;
+        std::unordered_map<std::string, int> mStaticIds;
 
         std::map<std::string, int> mRefCount;
 
@@ -90,6 +92,13 @@ namespace MWWorld
         void validate();
 
         void countRecords();
+
+        void loadRecord(ESM::ESMReader &esm, ESM::NAME name, ESM::Dialogue*& dialogue);
+
+        void onRecordLoaded(StoreBase& store, ESM::NAME name, const RecordId& id, ESM::Dialogue*& dialogue);
+
+        /// Resolve indices of parent files, must be called before records of the file are loaded
+        void prepareLoad(ESM::ESMReader &esm);
     public:
         /// \todo replace with SharedIterator<StoreBase>
         typedef std::map<int, StoreBase *>::const_iterator iterator;
@@ -106,7 +115,7 @@ namespace MWWorld
         /// \note id must be in lower case.
         int find(const std::string &id) const
         {
-            std::map<std::string, int>::const_iterator it = mIds.find(id);
+            std::unordered_map<std::string, int>::const_iterator it = mIds.find(id);
             if (it == mIds.end()) {
                 return 0;
             }
@@ -114,7 +123,7 @@ namespace MWWorld
         }
         int findStatic(const std::string &id) const
         {
-            std::map<std::string, int>::const_iterator it = mStaticIds.find(id);
+            std::unordered_map<std::string, int>::const_iterator it = mStaticIds.find(id);
             if (it == mStaticIds.end()) {
                 return 0;
             }
@@ -182,7 +191,14 @@ namespace MWWorld
             mNpcs.insert(mPlayerTemplate);
         }
 
-        void load(ESM::ESMReader &esm, Loading::Listener* listener);
+        /// @param taskScheduler when given and it has worker threads, records that don't depend on previously
+        /// loaded records are read in parallel. The result is the same as loading them one by one.
+        void load(ESM::ESMReader &esm, Loading::Listener* listener, MWMechanics::TaskScheduler* taskScheduler = nullptr);
+
+        /// Load multiple content files in the given order, records of all files are read in parallel by
+        /// taskScheduler and added to the stores file by file. The result is the same as loading them one by one.
+        void load(const std::vector<ESM::ESMReader*>& readers, Loading::Listener* listener,
+            MWMechanics::TaskScheduler& taskScheduler);
 
         template <class T>
         const Store<T> &get() const {
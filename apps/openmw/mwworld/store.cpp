@@ -122,6 +122,8 @@ namespace MWWorld
     Store<T>::Store(const Store<T>& orig)
         : mStatic(orig.mStatic)
     {
+        for (auto& pair : mStatic)
+            mStaticIndex.emplace(pair.first, &pair.second);
     }
 
     template<typename T>
@@ -130,40 +132,36 @@ namespace MWWorld
         // remove the dynamic part of mShared
         assert(mShared.size() >= mStatic.size());
         mShared.erase(mShared.begin() + mStatic.size(), mShared.end());
+        mDynamicIndex.clear();
         mDynamic.clear();
     }
 
     template<typename T>
-    const T *Store<T>::search(const std::string &id) const
+    const T *Store<T>::search(std::string_view id) const
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename Dynamic::const_iterator dit = mDynamic.find(idLower);
-        if (dit != mDynamic.end())
-            return &dit->second;
-
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(idLower);
-        if (it != mStatic.end())
-            return &(it->second);
+        if (!mDynamicIndex.empty())
+        {
+            typename Index::const_iterator dit = mDynamicIndex.find(id);
+            if (dit != mDynamicIndex.end())
+                return dit->second;
+        }
 
-        return nullptr;
+        return searchStatic(id);
     }
     template<typename T>
-    const T *Store<T>::searchStatic(const std::string &id) const
+    const T *Store<T>::searchStatic(std::string_view id) const
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(idLower);
-        if (it != mStatic.end())
-            return &(it->second);
+        typename Index::const_iterator it = mStaticIndex.find(id);
+        if (it != mStaticIndex.end())
+            return it->second;
 
         return nullptr;
     }
 
     template<typename T>
-    bool Store<T>::isDynamic(const std::string &id) const
+    bool Store<T>::isDynamic(std::string_view id) const
     {
-        typename Dynamic::const_iterator dit = mDynamic.find(id);
-        return (dit != mDynamic.end());
+        return mDynamicIndex.find(id) != mDynamicIndex.end();
     }
     template<typename T>
     const T *Store<T>::searchRandom(const std::string &id) const
@@ -175,12 +173,12 @@ namespace MWWorld
         return nullptr;
     }
     template<typename T>
-    const T *Store<T>::find(const std::string &id) const
+    const T *Store<T>::find(std::string_view id) const
     {
         const T *ptr = search(id);
         if (ptr == nullptr)
         {
-            const std::string msg = T::getRecordType() + " '" + id + "' not found";
+            const std::string msg = T::getRecordType() + " '" + std::string(id) + "' not found";
             throw std::runtime_error(msg);
         }
         return ptr;
@@ -205,13 +203,37 @@ namespace MWWorld
         record.load(esm, isDeleted);
         Misc::StringUtils::lowerCaseInPlace(record.mId);
 
-        std::pair<typename Static::iterator, bool> inserted = mStatic.insert(std::make_pair(record.mId, record));
+        insertLoaded(record);
+
+        return RecordId(record.mId, isDeleted);
+    }
+    template<typename T>
+    std::unique_ptr<StoreBase::DecodedRecord> Store<T>::decode(ESM::ESMReader &esm) const
+    {
+        auto result = std::make_unique<Decoded>();
+        result->mRecord.load(esm, result->mIsDeleted);
+        Misc::StringUtils::lowerCaseInPlace(result->mRecord.mId);
+        return result;
+    }
+    template<typename T>
+    RecordId Store<T>::apply(DecodedRecord &record)
+    {
+        Decoded& decoded = static_cast<Decoded&>(record);
+        RecordId result(decoded.mRecord.mId, decoded.mIsDeleted);
+        insertLoaded(std::move(decoded.mRecord));
+        return result;
+    }
+    template<typename T>
+    void Store<T>::insertLoaded(T record)
+    {
+        std::pair<typename Static::iterator, bool> inserted = mStatic.try_emplace(record.mId, std::move(record));
         if (inserted.second)
+        {
             mShared.push_back(&inserted.first->second);
+            mStaticIndex.emplace(inserted.first->first, &inserted.first->second);
+        }
         else
-            inserted.first->second = record;
-
-        return RecordId(record.mId, isDeleted);
+            inserted.first->second = std::move(record);
     }
     template<typename T>
     void Store<T>::setUp()
@@ -258,6 +280,7 @@ namespace MWWorld
         T *ptr = &result.first->second;
         if (result.second) {
             mShared.push_back(ptr);
+            mDynamicIndex.emplace(result.first->first, ptr);
         } else {
             *ptr = item;
         }
@@ -272,6 +295,7 @@ namespace MWWorld
         T *ptr = &result.first->second;
         if (result.second) {
             mShared.push_back(ptr);
+            mStaticIndex.emplace(result.first->first, ptr);
         } else {
             *ptr = item;
         }
@@ -296,6 +320,7 @@ namespace MWWorld
                 }
                 ++sharedIter;
             }
+            mStaticIndex.erase(it->first);
             mStatic.erase(it);
         }
 
@@ -310,6 +335,7 @@ namespace MWWorld
         if (it == mDynamic.end()) {
             return false;
         }
+        mDynamicIndex.erase(it->first);
         mDynamic.erase(it);
 
         // have to reinit the whole shared part
@@ -1108,7 +1134,8 @@ namespace MWWorld
         if (found == mStatic.end())
         {
             dialogue.loadData(esm, isDeleted);
-            mStatic.insert(std::make_pair(idLower, dialogue));
+            const auto inserted = mStatic.insert(std::make_pair(idLower, dialogue)).first;
+            mStaticIndex.emplace(inserted->first, &inserted->second);
         }
         else
         {
@@ -1119,13 +1146,23 @@ namespace MWWorld
         return RecordId(dialogue.mId, isDeleted);
     }
 
+    template<>
+    std::unique_ptr<StoreBase::DecodedRecord> Store<ESM::Dialogue>::decode(ESM::ESMReader &esm) const
+    {
+        // INFO records following a dialogue are added to it, so dialogues have to be loaded in order
+        return nullptr;
+    }
+
     template<>
     bool Store<ESM::Dialogue>::eraseStatic(const std::string &id)
     {
         auto it = mStatic.find(Misc::StringUtils::lowerCase(id));
 
         if (it != mStatic.end())
+        {
+            mStaticIndex.erase(it->first);
             mStatic.erase(it);
+        }
 
         return true;
     }
@@ -1,7 +1,10 @@
 #ifndef OPENMW_MWWORLD_STORE_H
 #define OPENMW_MWWORLD_STORE_H
 
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
@@ -41,6 +44,21 @@ namespace MWWorld
         virtual int getDynamicSize() const { return 0; }
         virtual RecordId load(ESM::ESMReader &esm) = 0;
 
+        /// Record read by decode()
+        class DecodedRecord
+        {
+        public:
+            virtual ~DecodedRecord() = default;
+        };
+
+        /// Read the current record without modifying the store, so records can be read by multiple threads
+        /// with different readers. The result is added to the store by apply().
+        /// @return nullptr if loading depends on the state of the store, then the record has to be loaded by load()
+        virtual std::unique_ptr<DecodedRecord> decode(ESM::ESMReader &esm) const { return nullptr; }
+
+        /// Add a record returned by decode() of this store, same as load() would do
+        virtual RecordId apply(DecodedRecord &record) { return RecordId(); }
+
         virtual bool eraseStatic(const std::string &id) {return false;}
         virtual void clearDynamic() {}
 
@@ -154,6 +172,12 @@ namespace MWWorld
         typedef std::map<std::string, T> Dynamic;
         typedef std::map<std::string, T> Static;
 
+        // Case insensitive hash indices over the keys of mStatic and mDynamic, so lookups don't need
+        // to make a lower case copy of the ID and walk the tree. Must be updated with the maps.
+        typedef std::unordered_map<std::string_view, T*, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> Index;
+        Index mStaticIndex;
+        Index mDynamicIndex;
+
         friend class ESMStore;
 
     public:
@@ -166,18 +190,18 @@ namespace MWWorld
         void clearDynamic() override;
         void setUp() override;
 
-        const T *search(const std::string &id) const;
-        const T *searchStatic(const std::string &id) const;
+        const T *search(std::string_view id) const;
+        const T *searchStatic(std::string_view id) const;
 
         /**
          * Does the record with this ID come from the dynamic store?
          */
-        bool isDynamic(const std::string &id) const;
+        bool isDynamic(std::string_view id) const;
 
         /** Returns a random record that starts with the named ID, or nullptr if not found. */
         const T *searchRandom(const std::string &id) const;
 
-        const T *find(const std::string &id) const;
+        const T *find(std::string_view id) const;
 
         /** Returns a random record that starts with the named ID. An exception is thrown if none
          * are found. */
@@ -200,8 +224,19 @@ namespace MWWorld
         bool erase(const T &item);
 
         RecordId load(ESM::ESMReader &esm) override;
+        std::unique_ptr<DecodedRecord> decode(ESM::ESMReader &esm) const override;
+        RecordId apply(DecodedRecord &record) override;
         void write(ESM::ESMWriter& writer, Loading::Listener& progress) const override;
         RecordId read(ESM::ESMReader& reader) override;
+
+    private:
+        struct Decoded : DecodedRecord
+        {
+            T mRecord;
+            bool mIsDeleted = false;
+        };
+
+        void insertLoaded(T record);
     };
 
     template <>
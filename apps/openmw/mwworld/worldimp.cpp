@@ -118,6 +118,12 @@ namespace MWWorld
             }
         }
 
+        void finish() override
+        {
+            for (const auto& loader : mLoaders)
+                loader.second->finish();
+        }
+
         private:
           typedef std::map<std::string, ContentLoader*> LoadersContainer;
           LoadersContainer mLoaders;
@@ -189,6 +195,7 @@ namespace MWWorld
             navigatorSettings->mMaxClimb = MWPhysics::sStepSizeUp;
             navigatorSettings->mMaxSlope = MWPhysics::sMaxSlope;
             navigatorSettings->mSwimHeightScale = mSwimHeightScale;
+            navigatorSettings->mNavMeshDiskCachePath = (boost::filesystem::path(mUserDataPath) / "navmesh").string();
             DetourNavigator::RecastGlobalAllocator::init();
             mNavigator.reset(new DetourNavigator::NavigatorImpl(*navigatorSettings));
         }
@@ -197,7 +204,10 @@ namespace MWWorld
             mNavigator.reset(new DetourNavigator::NavigatorStub());
         }
 
-        mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, *mNavigator));
+        std::vector<std::string> contentFilePaths;
+        for (const ESM::ESMReader& reader : mEsm)
+            contentFilePaths.push_back(reader.getName());
+        mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, mUserDataPath, *mNavigator, contentFilePaths));
         mProjectileManager.reset(new ProjectileManager(mRendering->getLightRoot(), resourceSystem, mRendering.get(), mPhysics.get()));
         mRendering->preloadCommonAssets();
 
@@ -1220,6 +1230,8 @@ namespace MWWorld
             }
         }
 
+        MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr);
+
         if (isPlayer)
             mWorldScene->playerMoved(vec);
         else
@@ -2959,6 +2971,7 @@ namespace MWWorld
             }
             idx++;
         }
+        contentLoader.finish();
     }
 
     bool World::startSpellCast(const Ptr &actor)
@@ -0,0 +1,151 @@
+#include <components/bsa/bsa_file.hpp>
+#include <components/files/mappedfile.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+
+    struct BsaFileTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_bsa_%%%%%%%%");
+        const std::vector<std::pair<std::string, std::string>> mFiles {
+            {"meshes\\a.nif", "first file content"},
+            {"textures\\b.dds", "second"},
+            {"c.txt", ""},
+        };
+
+        BsaFileTest()
+        {
+            boost::filesystem::create_directories(mPath);
+        }
+
+        ~BsaFileTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        static void writeInt(std::string& out, std::uint32_t value)
+        {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        /// Write TES3 archive, see Bsa::BSAFile::readHeader for the layout
+        std::string writeArchive() const
+        {
+            std::string names;
+            std::string data;
+            std::string sizesAndOffsets;
+            std::string nameOffsets;
+            for (const auto& file : mFiles)
+            {
+                writeInt(sizesAndOffsets, static_cast<std::uint32_t>(file.second.size()));
+                writeInt(sizesAndOffsets, static_cast<std::uint32_t>(data.size()));
+                writeInt(nameOffsets, static_cast<std::uint32_t>(names.size()));
+                names += file.first;
+                names += '\0';
+                data += file.second;
+            }
+
+            std::string archive;
+            writeInt(archive, 0x100);
+            writeInt(archive, static_cast<std::uint32_t>(sizesAndOffsets.size() + nameOffsets.size() + names.size()));
+            writeInt(archive, static_cast<std::uint32_t>(mFiles.size()));
+            archive += sizesAndOffsets;
+            archive += nameOffsets;
+            archive += names;
+            archive += std::string(8 * mFiles.size(), '\0');
+            archive += data;
+
+            const std::string path = (mPath / "test.bsa").string();
+            boost::filesystem::ofstream file(path, std::ios::binary);
+            file << archive;
+            return path;
+        }
+
+        static std::string read(std::istream& stream)
+        {
+            return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+    };
+
+    TEST_F(BsaFileTest, getFile_should_return_stream_with_file_content)
+    {
+        Bsa::BSAFile bsa;
+        bsa.open(writeArchive());
+        ASSERT_EQ(bsa.getList().size(), mFiles.size());
+        for (const auto& file : mFiles)
+        {
+            EXPECT_TRUE(bsa.exists(file.first.c_str())) << file.first;
+            const Files::IStreamPtr stream = bsa.getFile(file.first.c_str());
+            EXPECT_EQ(read(*stream), file.second) << file.first;
+        }
+    }
+
+    TEST_F(BsaFileTest, getFile_should_ignore_name_case)
+    {
+        Bsa::BSAFile bsa;
+        bsa.open(writeArchive());
+        EXPECT_EQ(read(*bsa.getFile("MESHES\\A.NIF")), "first file content");
+    }
+
+    TEST_F(BsaFileTest, getFile_for_missing_file_should_throw_exception)
+    {
+        Bsa::BSAFile bsa;
+        bsa.open(writeArchive());
+        EXPECT_FALSE(bsa.exists("missing.nif"));
+        EXPECT_THROW(bsa.getFile("missing.nif"), std::runtime_error);
+    }
+
+    TEST_F(BsaFileTest, stream_should_be_readable_after_archive_is_destroyed)
+    {
+        Files::IStreamPtr stream;
+        {
+            Bsa::BSAFile bsa;
+            bsa.open(writeArchive());
+            stream = bsa.getFile("textures\\b.dds");
+        }
+        EXPECT_EQ(read(*stream), "second");
+    }
+
+    TEST_F(BsaFileTest, stream_should_be_limited_to_file_region)
+    {
+        Bsa::BSAFile bsa;
+        bsa.open(writeArchive());
+        const Files::IStreamPtr stream = bsa.getFile("textures\\b.dds");
+        stream->seekg(0, std::ios_base::end);
+        EXPECT_EQ(stream->tellg(), std::streampos(6));
+        stream->seekg(2);
+        EXPECT_EQ(read(*stream), "cond");
+        stream->clear();
+        stream->seekg(7);
+        EXPECT_TRUE(stream->fail());
+    }
+
+    TEST_F(BsaFileTest, mapped_file_stream_should_be_bounded_by_file_size)
+    {
+        const auto mapped = Files::mapFile(writeArchive());
+        ASSERT_NE(mapped, nullptr);
+        const Files::IStreamPtr stream = Files::openMappedFileStream(mapped, mapped->size() - 6);
+        EXPECT_EQ(read(*stream), "second");
+        EXPECT_THROW(Files::openMappedFileStream(mapped, mapped->size() + 1), std::runtime_error);
+    }
+
+    TEST_F(BsaFileTest, mapFile_for_missing_file_should_return_nullptr)
+    {
+        EXPECT_EQ(Files::mapFile((mPath / "missing.bsa").string()), nullptr);
+    }
+}
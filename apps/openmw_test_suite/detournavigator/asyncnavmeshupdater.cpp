@@ -0,0 +1,85 @@
+#include "operators.hpp"
+
+#include <components/detournavigator/asyncnavmeshupdater.hpp>
+#include <components/detournavigator/settings.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorAsyncNavMeshUpdaterTest : Test
+    {
+        Settings mSettings;
+        const osg::Vec3f mAgentHalfExtents {29, 29, 66};
+        const TilePosition mPlayerTile {0, 0};
+        // Jobs for expired nav mesh are processed without building tiles, only the order matters here
+        const SharedNavMeshCacheItem mNavMeshCacheItem;
+
+        DetourNavigatorAsyncNavMeshUpdaterTest()
+        {
+            mSettings.mEnableWriteRecastMeshToFile = false;
+            mSettings.mEnableWriteNavMeshToFile = false;
+            mSettings.mEnableNavMeshDiskCache = false;
+            mSettings.mTrianglesPerChunk = 256;
+            mSettings.mMaxNavMeshTilesCacheSize = 1024 * 1024;
+            // Jobs are processed by the test thread
+            mSettings.mAsyncNavMeshUpdaterThreads = 0;
+            mSettings.mMinUpdateInterval = std::chrono::milliseconds(100);
+        }
+
+        /// Process the next job as soon as there is one ready or return nullopt when there is none within timeout
+        std::optional<TilePosition> waitAndProcessNextJob(AsyncNavMeshUpdater& updater)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + 10 * mSettings.mMinUpdateInterval;
+            while (true)
+            {
+                // Blocks for a short time waiting for a ready job
+                const auto result = updater.processNextJob();
+                if (result || std::chrono::steady_clock::now() >= deadline)
+                    return result;
+            }
+        }
+    };
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, demanded_job_should_be_processed_before_other_ready_jobs)
+    {
+        TileCachedRecastMeshManager recastMeshManager(mSettings);
+        OffMeshConnectionsManager offMeshConnectionsManager(mSettings);
+        AsyncNavMeshUpdater updater(mSettings, recastMeshManager, offMeshConnectionsManager);
+        const std::map<TilePosition, ChangeType> changedTiles {
+            {TilePosition(0, 0), ChangeType::add},
+            {TilePosition(1, 0), ChangeType::add},
+            {TilePosition(5, 5), ChangeType::update},
+        };
+        updater.post(mAgentHalfExtents, mNavMeshCacheItem, mPlayerTile, changedTiles);
+        updater.demand(mAgentHalfExtents, {TilePosition(5, 5)});
+        EXPECT_EQ(updater.processNextJob(), std::optional<TilePosition>(TilePosition(5, 5)));
+        EXPECT_EQ(updater.processNextJob(), std::optional<TilePosition>(TilePosition(0, 0)));
+        EXPECT_EQ(updater.processNextJob(), std::optional<TilePosition>(TilePosition(1, 0)));
+        EXPECT_EQ(updater.processNextJob(), std::nullopt);
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, demanded_job_should_be_processed_after_its_process_time)
+    {
+        TileCachedRecastMeshManager recastMeshManager(mSettings);
+        OffMeshConnectionsManager offMeshConnectionsManager(mSettings);
+        AsyncNavMeshUpdater updater(mSettings, recastMeshManager, offMeshConnectionsManager);
+        updater.post(mAgentHalfExtents, mNavMeshCacheItem, mPlayerTile, {{TilePosition(0, 0), ChangeType::update}});
+        EXPECT_EQ(updater.processNextJob(), std::optional<TilePosition>(TilePosition(0, 0)));
+        const std::map<TilePosition, ChangeType> changedTiles {
+            {TilePosition(0, 0), ChangeType::update},
+            {TilePosition(1, 0), ChangeType::add},
+        };
+        updater.post(mAgentHalfExtents, mNavMeshCacheItem, mPlayerTile, changedTiles);
+        updater.demand(mAgentHalfExtents, {TilePosition(0, 0)});
+        EXPECT_EQ(updater.processNextJob(), std::optional<TilePosition>(TilePosition(1, 0)));
+        EXPECT_EQ(waitAndProcessNextJob(updater), std::optional<TilePosition>(TilePosition(0, 0)));
+        EXPECT_EQ(updater.processNextJob(), std::nullopt);
+    }
+}
@@ -65,6 +65,7 @@ namespace
             mSettings.mRegionMinSize = 8;
             mSettings.mTileSize = 64;
             mSettings.mAsyncNavMeshUpdaterThreads = 1;
+            mSettings.mAsyncPathFinderThreads = 1;
             mSettings.mMaxNavMeshTilesCacheSize = 1024 * 1024;
             mSettings.mMaxPolygonPathSize = 1024;
             mSettings.mMaxSmoothPathSize = 1024;
@@ -74,6 +75,18 @@ namespace
             mSettings.mMinUpdateInterval = std::chrono::milliseconds(50);
             mNavigator.reset(new NavigatorImpl(mSettings));
         }
+
+        PathQuery makePathQuery() const
+        {
+            PathQuery result;
+            result.mAgentHalfExtents = mAgentHalfExtents;
+            result.mStepSize = mStepSize;
+            result.mStart = mStart;
+            result.mEnd = mEnd;
+            result.mIncludeFlags = Flag_walk;
+            result.mAreaCosts = mAreaCosts;
+            return result;
+        }
     };
 
     TEST_F(DetourNavigatorNavigatorTest, find_path_for_empty_should_return_empty)
@@ -699,6 +712,80 @@ namespace
         EXPECT_FLOAT_EQ(distance, 85.260780334472656);
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, submit_path_query_for_empty_should_return_nav_mesh_not_found)
+    {
+        const auto query = mNavigator->submitPathQuery(makePathQuery());
+        ASSERT_NE(query->poll(), nullptr);
+        EXPECT_EQ(query->poll()->mStatus, Status::NavMeshNotFound);
+        EXPECT_EQ(query->poll()->mPath, std::vector<osg::Vec3f>());
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, async_path_finder_should_find_same_path_as_find_path)
+    {
+        const std::array<btScalar, 5 * 5> heightfieldData {{
+            0,   0,    0,    0,    0,
+            0, -25,  -25,  -25,  -25,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+        }};
+        btHeightfieldTerrainShape shape(5, 5, heightfieldData.data(), 1, 0, 0, 2, PHY_FLOAT, false);
+        shape.setLocalScaling(btVector3(128, 128, 1));
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addObject(ObjectId(&shape), shape, btTransform::getIdentity());
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait();
+
+        ASSERT_EQ(mNavigator->findPath(mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mOut), Status::Success);
+        const std::vector<osg::Vec3f> expected(mPath.begin(), mPath.end());
+
+        for (const std::size_t threads : {0, 1, 3})
+        {
+            AsyncPathFinder pathFinder(mSettings, threads);
+            std::vector<SharedPendingPathQuery> queries;
+            for (int i = 0; i < 8; ++i)
+                queries.push_back(pathFinder.submit(mNavigator->getNavMesh(mAgentHalfExtents), makePathQuery()));
+            pathFinder.wait();
+            EXPECT_EQ(pathFinder.getPendingQueriesCount(), 0u) << threads;
+            for (const auto& query : queries)
+            {
+                ASSERT_NE(query->poll(), nullptr) << threads;
+                EXPECT_EQ(query->poll()->mStatus, Status::Success) << threads;
+                EXPECT_EQ(query->poll()->mPath, expected) << threads;
+            }
+        }
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, async_path_finder_should_process_queries_kept_after_others_are_released)
+    {
+        const std::array<btScalar, 5 * 5> heightfieldData {{
+            0,   0,    0,    0,    0,
+            0, -25,  -25,  -25,  -25,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+        }};
+        btHeightfieldTerrainShape shape(5, 5, heightfieldData.data(), 1, 0, 0, 2, PHY_FLOAT, false);
+        shape.setLocalScaling(btVector3(128, 128, 1));
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addObject(ObjectId(&shape), shape, btTransform::getIdentity());
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait();
+
+        AsyncPathFinder pathFinder(mSettings, 1);
+        const auto navMesh = mNavigator->getNavMesh(mAgentHalfExtents);
+        for (int i = 0; i < 8; ++i)
+            pathFinder.submit(navMesh, makePathQuery());
+        const auto kept = pathFinder.submit(navMesh, makePathQuery());
+        pathFinder.wait();
+
+        ASSERT_NE(kept->poll(), nullptr);
+        EXPECT_EQ(kept->poll()->mStatus, Status::Success);
+        EXPECT_FALSE(kept->poll()->mPath.empty());
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, multiple_threads_should_lock_tiles)
     {
         mSettings.mAsyncNavMeshUpdaterThreads = 2;
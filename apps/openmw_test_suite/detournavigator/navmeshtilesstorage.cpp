@@ -0,0 +1,130 @@
+#include <components/detournavigator/navmeshtilesstorage.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/settings.hpp>
+
+#include <LinearMath/btTransform.h>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorNavMeshTilesStorageTest : Test
+    {
+        const osg::Vec3f mAgentHalfExtents {1, 2, 3};
+        const TilePosition mTilePosition {0, 0};
+        const std::vector<unsigned char> mNavMeshKey {{1, 2, 3, 4}};
+        unsigned char mData[3] = {5, 6, 7};
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_navmesh_%%%%%%%%");
+        Settings mSettings;
+
+        DetourNavigatorNavMeshTilesStorageTest()
+        {
+            mSettings.mMaxNavMeshDiskCacheSize = 1024 * 1024;
+        }
+
+        ~DetourNavigatorNavMeshTilesStorageTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+    };
+
+    /// Construct the value in memory filled by given byte, so its padding bytes have this value, and copy it
+    template <class T>
+    std::vector<T> makeInFilledMemory(unsigned char filler, const T& value)
+    {
+        alignas(T) unsigned char buffer[sizeof(T)];
+        std::memset(buffer, filler, sizeof(buffer));
+        const T* const ptr = new (buffer) T(value);
+        std::vector<T> result(ptr, ptr + 1);
+        ptr->~T();
+        return result;
+    }
+
+    std::vector<unsigned char> makePersistentKeyInFilledMemory(unsigned char filler, float waterLevel)
+    {
+        const RecastMesh recastMesh(0, 0, {0, 1, 2}, {0, 0, 0, 1, 0, 0, 1, 1, 0}, {AreaType_ground},
+            makeInFilledMemory(filler, RecastMesh::Water {8192, btTransform(btMatrix3x3::getIdentity(), btVector3(0, 0, waterLevel))}), 1);
+        const auto offMeshConnections = makeInFilledMemory(filler,
+            OffMeshConnection {osg::Vec3f(1, 2, 3), osg::Vec3f(4, 5, 6), AreaType_door});
+        return makePersistentNavMeshKey(recastMesh, offMeshConnections);
+    }
+
+    TEST(DetourNavigatorMakePersistentNavMeshKeyTest, should_not_depend_on_padding_bytes)
+    {
+        EXPECT_EQ(makePersistentKeyInFilledMemory(0x00, 1), makePersistentKeyInFilledMemory(0xFF, 1));
+    }
+
+    TEST(DetourNavigatorMakePersistentNavMeshKeyTest, should_depend_on_water_level)
+    {
+        EXPECT_NE(makePersistentKeyInFilledMemory(0x00, 1), makePersistentKeyInFilledMemory(0x00, 2));
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, load_for_empty_storage_should_return_null)
+    {
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        EXPECT_EQ(storage.load(mAgentHalfExtents, mTilePosition, mNavMeshKey).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, load_should_return_saved_value)
+    {
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        const auto result = storage.load(mAgentHalfExtents, mTilePosition, mNavMeshKey);
+        ASSERT_NE(result.mValue, nullptr);
+        ASSERT_EQ(result.mSize, 3);
+        EXPECT_EQ(std::memcmp(result.mValue.get(), mData, 3), 0);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, load_by_different_key_should_return_null)
+    {
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        const std::vector<unsigned char> otherKey {{1, 2, 3}};
+        EXPECT_EQ(storage.load(mAgentHalfExtents, mTilePosition, otherKey).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, load_for_different_tile_should_return_null)
+    {
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        EXPECT_EQ(storage.load(mAgentHalfExtents, TilePosition {1, 0}, mNavMeshKey).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, load_with_different_settings_should_return_null)
+    {
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        mSettings.mCellSize = 1;
+        const NavMeshTilesStorage otherStorage(mSettings, mPath.string());
+        EXPECT_EQ(otherStorage.load(mAgentHalfExtents, mTilePosition, mNavMeshKey).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, save_over_size_limit_should_remove_least_recently_used_tiles)
+    {
+        mSettings.mMaxNavMeshDiskCacheSize = 1;
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        EXPECT_EQ(storage.load(mAgentHalfExtents, mTilePosition, mNavMeshKey).mValue, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesStorageTest, tiles_over_size_limit_should_be_removed_on_construction)
+    {
+        {
+            const NavMeshTilesStorage storage(mSettings, mPath.string());
+            storage.save(mAgentHalfExtents, mTilePosition, mNavMeshKey, NavMeshDataRef {mData, 3});
+        }
+        mSettings.mMaxNavMeshDiskCacheSize = 0;
+        const NavMeshTilesStorage storage(mSettings, mPath.string());
+        EXPECT_EQ(storage.load(mAgentHalfExtents, mTilePosition, mNavMeshKey).mValue, nullptr);
+    }
+}
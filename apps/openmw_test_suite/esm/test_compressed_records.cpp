@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <components/esm/compressedrecords.hpp>
+#include <components/esm/defs.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    template <class F>
+    std::unique_ptr<std::stringstream> write(F&& f)
+    {
+        ESM::ESMWriter writer;
+        auto stream = std::make_unique<std::stringstream>();
+        writer.setFormat(16);
+        writer.save(*stream);
+        writer.startRecord(ESM::REC_CMPR);
+        f(writer);
+        writer.endRecord(ESM::REC_CMPR);
+        return stream;
+    }
+
+    std::string writeAndRead(const std::string& data)
+    {
+        auto stream = write([&] (ESM::ESMWriter& writer)
+        {
+            ESM::CompressedRecords written;
+            written.mData = data;
+            written.save(writer);
+        });
+
+        ESM::ESMReader reader;
+        reader.open(Files::IStreamPtr(stream.release()), "filename");
+        EXPECT_TRUE(reader.hasMoreRecs());
+        EXPECT_EQ(reader.getRecName().intval, ESM::REC_CMPR);
+        reader.getRecHeader();
+
+        ESM::CompressedRecords read;
+        read.load(reader);
+        EXPECT_FALSE(reader.hasMoreRecs());
+        return read.mData;
+    }
+
+    TEST(EsmCompressedRecordsTest, save_and_load_should_restore_data)
+    {
+        std::string data;
+        for (int i = 0; i < 10000; ++i)
+            data += "record " + std::to_string(i % 100) + '\0';
+        EXPECT_EQ(writeAndRead(data), data);
+    }
+
+    TEST(EsmCompressedRecordsTest, save_and_load_should_support_empty_data)
+    {
+        EXPECT_EQ(writeAndRead(std::string()), std::string());
+    }
+
+    TEST(EsmCompressedRecordsTest, load_should_throw_exception_for_too_large_uncompressed_size)
+    {
+        auto stream = write([&] (ESM::ESMWriter& writer)
+        {
+            writer.writeHNT("SIZE", ESM::CompressedRecords::sMaxSize + 1);
+            // Large enough to be not rejected by compression ratio
+            const std::string compressed(ESM::CompressedRecords::sMaxSize / 255 + 1, '\0');
+            writer.startSubRecord("DATA");
+            writer.write(compressed.data(), compressed.size());
+            writer.endRecord("DATA");
+        });
+
+        ESM::ESMReader reader;
+        reader.open(Files::IStreamPtr(stream.release()), "filename");
+        reader.getRecName();
+        reader.getRecHeader();
+
+        ESM::CompressedRecords read;
+        EXPECT_THROW(read.load(reader), std::runtime_error);
+        EXPECT_TRUE(read.mData.empty());
+    }
+
+    TEST(EsmCompressedRecordsTest, load_should_throw_exception_for_uncompressed_size_not_matching_compressed_size)
+    {
+        auto stream = write([&] (ESM::ESMWriter& writer)
+        {
+            writer.writeHNT("SIZE", std::uint64_t(1024 * 1024));
+            writer.startSubRecord("DATA");
+            writer.write("data", 4);
+            writer.endRecord("DATA");
+        });
+
+        ESM::ESMReader reader;
+        reader.open(Files::IStreamPtr(stream.release()), "filename");
+        reader.getRecName();
+        reader.getRecHeader();
+
+        ESM::CompressedRecords read;
+        EXPECT_THROW(read.load(reader), std::runtime_error);
+        EXPECT_TRUE(read.mData.empty());
+    }
+
+    TEST(EsmCompressedRecordsTest, save_with_cache_should_reuse_compressed_data_for_same_data)
+    {
+        ESM::CompressedRecordsCache cache;
+        ESM::CompressedRecords records;
+        records.mData = "data";
+        write([&] (ESM::ESMWriter& writer) { records.save(writer, cache); });
+        EXPECT_EQ(cache.mData, records.mData);
+        ASSERT_FALSE(cache.mCompressed.empty());
+        const char* const compressed = cache.mCompressed.data();
+        write([&] (ESM::ESMWriter& writer) { records.save(writer, cache); });
+        EXPECT_EQ(cache.mCompressed.data(), compressed);
+    }
+
+    TEST(EsmCompressedRecordsTest, save_with_cache_should_update_cache_for_changed_data)
+    {
+        ESM::CompressedRecordsCache cache;
+        ESM::CompressedRecords records;
+        records.mData = "data";
+        write([&] (ESM::ESMWriter& writer) { records.save(writer, cache); });
+        const std::string compressed = cache.mCompressed;
+        records.mData = "other data";
+        auto stream = write([&] (ESM::ESMWriter& writer) { records.save(writer, cache); });
+        EXPECT_EQ(cache.mData, records.mData);
+        EXPECT_NE(cache.mCompressed, compressed);
+
+        ESM::ESMReader reader;
+        reader.open(Files::IStreamPtr(stream.release()), "filename");
+        reader.getRecName();
+        reader.getRecHeader();
+        ESM::CompressedRecords read;
+        read.load(reader);
+        EXPECT_EQ(read.mData, records.mData);
+    }
+}
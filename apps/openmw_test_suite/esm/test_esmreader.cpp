@@ -0,0 +1,81 @@
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+
+    struct EsmReaderTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_esm_%%%%%%%%.esp");
+        ToUTF8::Utf8Encoder mEncoder {ToUTF8::WINDOWS_1252};
+
+        EsmReaderTest()
+        {
+            boost::filesystem::ofstream stream(mPath, std::ios::binary);
+            ESM::ESMWriter writer;
+            writer.setFormat(0);
+            writer.save(stream);
+            writer.startRecord("TEST");
+            // String sub-records are written without terminating zero
+            writer.writeHNString("NAME", "abc");
+            writer.writeHNString("TEXT", "defgh");
+            writer.endRecord("TEST");
+            writer.close();
+        }
+
+        ~EsmReaderTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(mPath, ec);
+        }
+
+        std::vector<std::string> read(ESM::ESMReader& reader)
+        {
+            std::vector<std::string> result;
+            EXPECT_TRUE(reader.hasMoreRecs());
+            EXPECT_EQ(reader.getRecName(), "TEST");
+            reader.getRecHeader();
+            result.push_back(reader.getHNString("NAME"));
+            result.push_back(reader.getHNString("TEXT"));
+            EXPECT_FALSE(reader.hasMoreRecs());
+            return result;
+        }
+    };
+
+    TEST_F(EsmReaderTest, open_should_read_not_zero_terminated_strings)
+    {
+        ESM::ESMReader reader;
+        reader.open(mPath.string());
+        EXPECT_EQ(read(reader), std::vector<std::string>({"abc", "defgh"}));
+    }
+
+    TEST_F(EsmReaderTest, open_mapped_should_read_same_strings_as_open)
+    {
+        ESM::ESMReader streamReader;
+        streamReader.open(mPath.string());
+        ESM::ESMReader mappedReader;
+        mappedReader.openMapped(mPath.string());
+        EXPECT_EQ(read(mappedReader), read(streamReader));
+    }
+
+    TEST_F(EsmReaderTest, open_mapped_with_encoder_should_read_same_strings_as_open)
+    {
+        ESM::ESMReader streamReader;
+        streamReader.setEncoder(&mEncoder);
+        streamReader.open(mPath.string());
+        ESM::ESMReader mappedReader;
+        mappedReader.setEncoder(&mEncoder);
+        mappedReader.openMapped(mPath.string());
+        const std::vector<std::string> expected({"abc", "defgh"});
+        EXPECT_EQ(read(streamReader), expected);
+        EXPECT_EQ(read(mappedReader), expected);
+    }
+}
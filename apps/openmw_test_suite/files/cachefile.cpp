@@ -0,0 +1,106 @@
+#include <components/files/cachefile.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+
+    struct FilesCacheFileTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_cache_%%%%%%%%");
+        const std::uint32_t mMagic = 42;
+        const std::uint32_t mVersion = 1;
+        const std::string mKey = "key";
+
+        ~FilesCacheFileTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        void write(const boost::filesystem::path& path, const std::string& content)
+        {
+            Files::writeCacheFile(path, mMagic, mVersion, mKey,
+                [&] (std::ostream& stream) { Files::writeString(stream, content); });
+        }
+    };
+
+    TEST_F(FilesCacheFileTest, open_should_return_false_when_there_is_no_file)
+    {
+        boost::filesystem::ifstream file;
+        EXPECT_FALSE(Files::openCacheFile(file, mPath / "file", mMagic, mVersion, mKey));
+    }
+
+    TEST_F(FilesCacheFileTest, open_should_read_header_of_written_file)
+    {
+        write(mPath / "file", "content");
+        boost::filesystem::ifstream file;
+        ASSERT_TRUE(Files::openCacheFile(file, mPath / "file", mMagic, mVersion, mKey));
+        EXPECT_EQ(Files::readString(file), "content");
+    }
+
+    TEST_F(FilesCacheFileTest, open_should_return_false_for_different_key)
+    {
+        write(mPath / "file", "content");
+        boost::filesystem::ifstream file;
+        EXPECT_FALSE(Files::openCacheFile(file, mPath / "file", mMagic, mVersion, "other"));
+    }
+
+    TEST_F(FilesCacheFileTest, open_should_return_false_for_different_version)
+    {
+        write(mPath / "file", "content");
+        boost::filesystem::ifstream file;
+        EXPECT_FALSE(Files::openCacheFile(file, mPath / "file", mMagic, mVersion + 1, mKey));
+    }
+
+    TEST_F(FilesCacheFileTest, write_should_replace_existing_file)
+    {
+        write(mPath / "file", "content");
+        write(mPath / "file", "other");
+        boost::filesystem::ifstream file;
+        ASSERT_TRUE(Files::openCacheFile(file, mPath / "file", mMagic, mVersion, mKey));
+        EXPECT_EQ(Files::readString(file), "other");
+        EXPECT_EQ(std::distance(boost::filesystem::directory_iterator(mPath), boost::filesystem::directory_iterator()), 1);
+    }
+
+    TEST_F(FilesCacheFileTest, trim_should_remove_least_recently_used_files)
+    {
+        write(mPath / "a" / "first", "content");
+        write(mPath / "second", "content");
+        write(mPath / "third", "content");
+        const auto fileSize = boost::filesystem::file_size(mPath / "second");
+        boost::filesystem::last_write_time(mPath / "a" / "first", 1000);
+        boost::filesystem::last_write_time(mPath / "second", 3000);
+        boost::filesystem::last_write_time(mPath / "third", 2000);
+        Files::touchCacheFile(mPath / "a" / "first");
+
+        EXPECT_EQ(Files::trimCache(mPath, 2 * fileSize), 2 * fileSize);
+        EXPECT_TRUE(boost::filesystem::exists(mPath / "a" / "first"));
+        EXPECT_TRUE(boost::filesystem::exists(mPath / "second"));
+        EXPECT_FALSE(boost::filesystem::exists(mPath / "third"));
+    }
+
+    TEST_F(FilesCacheFileTest, file_stamp_should_change_with_file_modification_time)
+    {
+        write(mPath / "file", "content");
+        boost::filesystem::last_write_time(mPath / "file", 1000);
+        std::ostringstream before;
+        Files::writeFileStamp(before, mPath / "file");
+        boost::filesystem::last_write_time(mPath / "file", 2000);
+        std::ostringstream after;
+        Files::writeFileStamp(after, mPath / "file");
+        EXPECT_NE(before.str(), after.str());
+    }
+
+    TEST_F(FilesCacheFileTest, file_stamp_should_throw_when_there_is_no_file)
+    {
+        std::ostringstream stream;
+        EXPECT_THROW(Files::writeFileStamp(stream, mPath / "file"), std::exception);
+    }
+}
@@ -0,0 +1,250 @@
+#include <components/compiler/generator.hpp>
+#include <components/compiler/locals.hpp>
+#include <components/compiler/output.hpp>
+#include <components/interpreter/context.hpp>
+#include <components/interpreter/installopcodes.hpp>
+#include <components/interpreter/interpreter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+
+    struct TestContext : Interpreter::Context
+    {
+        std::vector<int> mShorts = std::vector<int>(2, 0);
+        std::vector<int> mLongs = std::vector<int>(2, 0);
+        std::vector<float> mFloats = std::vector<float>(2, 0);
+
+        int getLocalShort (int index) const override { return mShorts.at(index); }
+
+        int getLocalLong (int index) const override { return mLongs.at(index); }
+
+        float getLocalFloat (int index) const override { return mFloats.at(index); }
+
+        void setLocalShort (int index, int value) override { mShorts.at(index) = value; }
+
+        void setLocalLong (int index, int value) override { mLongs.at(index) = value; }
+
+        void setLocalFloat (int index, float value) override { mFloats.at(index) = value; }
+
+        void messageBox (const std::string&, const std::vector<std::string>&) override {}
+
+        void report (const std::string&) override {}
+
+        int getGlobalShort (const std::string&) const override { return 0; }
+
+        int getGlobalLong (const std::string&) const override { return 0; }
+
+        float getGlobalFloat (const std::string&) const override { return 0; }
+
+        void setGlobalShort (const std::string&, int) override {}
+
+        void setGlobalLong (const std::string&, int) override {}
+
+        void setGlobalFloat (const std::string&, float) override {}
+
+        std::vector<std::string> getGlobals () const override { return {}; }
+
+        char getGlobalType (const std::string&) const override { return ' '; }
+
+        std::string getActionBinding(const std::string&) const override { return {}; }
+
+        std::string getActorName() const override { return {}; }
+
+        std::string getNPCRace() const override { return {}; }
+
+        std::string getNPCClass() const override { return {}; }
+
+        std::string getNPCFaction() const override { return {}; }
+
+        std::string getNPCRank() const override { return {}; }
+
+        std::string getPCName() const override { return {}; }
+
+        std::string getPCRace() const override { return {}; }
+
+        std::string getPCClass() const override { return {}; }
+
+        std::string getPCRank() const override { return {}; }
+
+        std::string getPCNextRank() const override { return {}; }
+
+        int getPCBounty() const override { return 0; }
+
+        std::string getCurrentCellName() const override { return {}; }
+
+        int getMemberShort (const std::string&, const std::string&, bool) const override { return 0; }
+
+        int getMemberLong (const std::string&, const std::string&, bool) const override { return 0; }
+
+        float getMemberFloat (const std::string&, const std::string&, bool) const override { return 0; }
+
+        void setMemberShort (const std::string&, const std::string&, int, bool) override {}
+
+        void setMemberLong (const std::string&, const std::string&, int, bool) override {}
+
+        void setMemberFloat (const std::string&, const std::string&, float, bool) override {}
+    };
+
+    struct InterpreterTest : Test
+    {
+        Interpreter::Interpreter mInterpreter;
+        Compiler::Locals mLocals;
+        Compiler::Output mOutput {mLocals};
+
+        InterpreterTest()
+        {
+            Interpreter::installOpcodes (mInterpreter);
+        }
+
+        std::vector<Interpreter::Type_Code> getCode() const
+        {
+            std::vector<Interpreter::Type_Code> code;
+            mOutput.getCode (code);
+            return code;
+        }
+
+        void runRaw (const std::vector<Interpreter::Type_Code>& code, TestContext& context)
+        {
+            mInterpreter.run (code.data(), static_cast<int> (code.size()), context);
+        }
+
+        void runDecoded (const std::vector<Interpreter::Type_Code>& code, TestContext& context)
+        {
+            const auto decoded = mInterpreter.decode (code.data(), static_cast<int> (code.size()));
+            mInterpreter.run (code.data(), static_cast<int> (code.size()), decoded, context);
+        }
+
+        /// short counter, long sum, float ratio
+        /// while counter < 10: sum = sum + counter * 3, counter = counter + 1
+        /// ratio = sum / 4.0
+        void generateLoop()
+        {
+            using namespace Compiler::Generator;
+
+            auto& code = mOutput.getCode();
+            auto& literals = mOutput.getLiterals();
+
+            std::vector<Interpreter::Type_Code> value;
+            pushInt (value, literals, 0);
+            assignToLocal (code, 's', 0, value, 'l');
+            assignToLocal (code, 'l', 0, value, 'l');
+
+            const int loopBegin = static_cast<int> (code.size());
+
+            fetchLocal (code, 's', 0);
+            pushInt (code, literals, 10);
+            compare (code, 'l', 'l', 'l');
+
+            std::vector<Interpreter::Type_Code> body;
+            value.clear();
+            fetchLocal (value, 'l', 0);
+            fetchLocal (value, 's', 0);
+            pushInt (value, literals, 3);
+            mul (value, 'l', 'l');
+            add (value, 'l', 'l');
+            assignToLocal (body, 'l', 0, value, 'l');
+            value.clear();
+            fetchLocal (value, 's', 0);
+            pushInt (value, literals, 1);
+            add (value, 'l', 'l');
+            assignToLocal (body, 's', 0, value, 'l');
+
+            // skip the body and the jump back
+            jumpOnZero (code, static_cast<int> (body.size()) + 2);
+            code.insert (code.end(), body.begin(), body.end());
+            jump (code, loopBegin - static_cast<int> (code.size()));
+
+            value.clear();
+            fetchLocal (value, 'l', 0);
+            pushFloat (value, literals, 4);
+            div (value, 'l', 'f');
+            assignToLocal (code, 'f', 0, value, 'f');
+        }
+    };
+
+    TEST_F(InterpreterTest, decoded_and_raw_run_should_give_same_result)
+    {
+        generateLoop();
+        const auto code = getCode();
+
+        TestContext raw;
+        runRaw (code, raw);
+        EXPECT_EQ(raw.mShorts[0], 10);
+        EXPECT_EQ(raw.mLongs[0], 135);
+        EXPECT_FLOAT_EQ(raw.mFloats[0], 33.75f);
+
+        TestContext decoded;
+        runDecoded (code, decoded);
+        EXPECT_EQ(decoded.mShorts, raw.mShorts);
+        EXPECT_EQ(decoded.mLongs, raw.mLongs);
+        EXPECT_EQ(decoded.mFloats, raw.mFloats);
+    }
+
+    TEST_F(InterpreterTest, decoded_code_should_be_reusable)
+    {
+        generateLoop();
+        const auto code = getCode();
+        const auto decoded = mInterpreter.decode (code.data(), static_cast<int> (code.size()));
+
+        for (int i = 0; i < 2; ++i)
+        {
+            TestContext context;
+            mInterpreter.run (code.data(), static_cast<int> (code.size()), decoded, context);
+            EXPECT_EQ(context.mLongs[0], 135);
+        }
+    }
+
+    TEST_F(InterpreterTest, unknown_opcode_should_not_fail_until_executed)
+    {
+        using namespace Compiler::Generator;
+
+        auto& code = mOutput.getCode();
+        exit (code);
+        code.push_back (segment5 (1000));
+        const auto script = getCode();
+
+        TestContext raw;
+        EXPECT_NO_THROW(runRaw (script, raw));
+
+        TestContext decoded;
+        EXPECT_NO_THROW(runDecoded (script, decoded));
+    }
+
+    TEST_F(InterpreterTest, decoded_and_raw_run_should_fail_with_same_error_for_unknown_opcode)
+    {
+        mOutput.getCode().push_back (Compiler::Generator::segment5 (1000));
+        const auto code = getCode();
+
+        std::string rawError;
+        try
+        {
+            TestContext context;
+            runRaw (code, context);
+        }
+        catch (const std::runtime_error& e)
+        {
+            rawError = e.what();
+        }
+
+        std::string decodedError;
+        try
+        {
+            TestContext context;
+            runDecoded (code, context);
+        }
+        catch (const std::runtime_error& e)
+        {
+            decodedError = e.what();
+        }
+
+        EXPECT_EQ(rawError, "unknown opcode 1000 in segment 5");
+        EXPECT_EQ(decodedError, rawError);
+    }
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwmechanics/actorsgrid.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    struct ActorsGridTest : Test
+    {
+        // Grid only copies and compares pointers, so they don't have to point to real objects
+        char mRefs[3] = {};
+        char mCells[2] = {};
+        ActorsGrid mGrid {512.f};
+        std::map<MWWorld::Ptr, osg::Vec3f> mPositions;
+
+        MWWorld::Ptr makePtr(int ref, int cell)
+        {
+            return MWWorld::Ptr(reinterpret_cast<MWWorld::LiveCellRefBase*>(&mRefs[ref]),
+                                reinterpret_cast<MWWorld::CellStore*>(&mCells[cell]));
+        }
+
+        /// Same as Actors does when the grid is marked dirty
+        void rebuild()
+        {
+            mGrid.clear();
+            for (const auto& actor : mPositions)
+                mGrid.add(actor.first, actor.second);
+            mGrid.build();
+        }
+
+        /// Same as Actors does to find neighbours, candidates are filtered by the actual distance
+        std::vector<MWWorld::Ptr> findInRange(const osg::Vec3f& position, float radius) const
+        {
+            std::vector<MWWorld::Ptr> result;
+            mGrid.forEachCandidate(position, radius, [&] (const MWWorld::Ptr& ptr)
+            {
+                if ((mPositions.at(ptr) - position).length2() <= radius * radius)
+                    result.push_back(ptr);
+            });
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+    };
+
+    TEST_F(ActorsGridTest, empty_grid_should_have_no_candidates)
+    {
+        mGrid.build();
+        EXPECT_EQ(mGrid.size(), 0);
+        EXPECT_TRUE(findInRange(osg::Vec3f(0, 0, 0), 1000).empty());
+    }
+
+    TEST_F(ActorsGridTest, should_find_only_actors_in_range)
+    {
+        const MWWorld::Ptr near = makePtr(0, 0);
+        const MWWorld::Ptr far = makePtr(1, 0);
+        mPositions[near] = osg::Vec3f(100, 100, 0);
+        mPositions[far] = osg::Vec3f(5000, 5000, 0);
+        rebuild();
+        EXPECT_EQ(findInRange(osg::Vec3f(0, 0, 0), 500), std::vector<MWWorld::Ptr>({near}));
+    }
+
+    TEST_F(ActorsGridTest, should_find_actors_in_neighbour_grid_cells)
+    {
+        const MWWorld::Ptr left = makePtr(0, 0);
+        const MWWorld::Ptr right = makePtr(1, 0);
+        mPositions[left] = osg::Vec3f(-10, 0, 0);
+        mPositions[right] = osg::Vec3f(10, 0, 0);
+        rebuild();
+        EXPECT_EQ(findInRange(osg::Vec3f(0, 0, 0), 100), std::vector<MWWorld::Ptr>({left, right}));
+    }
+
+    TEST_F(ActorsGridTest, large_radius_should_find_actors_in_all_cells)
+    {
+        std::vector<MWWorld::Ptr> expected;
+        for (int i = 0; i < 3; ++i)
+        {
+            expected.push_back(makePtr(i, 0));
+            mPositions[expected.back()] = osg::Vec3f(i * 3000.f, -i * 3000.f, 0);
+        }
+        rebuild();
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(findInRange(osg::Vec3f(0, 0, 0), 1e5f), expected);
+    }
+
+    TEST_F(ActorsGridTest, actor_moved_within_game_cell_should_be_found_at_new_position_after_rebuild)
+    {
+        const MWWorld::Ptr actor = makePtr(0, 0);
+        const MWWorld::Ptr other = makePtr(1, 0);
+        mPositions[actor] = osg::Vec3f(0, 0, 0);
+        mPositions[other] = osg::Vec3f(2000, 0, 0);
+        rebuild();
+        EXPECT_EQ(findInRange(osg::Vec3f(2000, 0, 0), 300), std::vector<MWWorld::Ptr>({other}));
+
+        // Actor is moved to another grid cell, e.g. by SetPos, game cell is the same
+        mPositions[actor] = osg::Vec3f(1900, 0, 0);
+        rebuild();
+        EXPECT_EQ(findInRange(osg::Vec3f(2000, 0, 0), 300), std::vector<MWWorld::Ptr>({actor, other}));
+        EXPECT_TRUE(findInRange(osg::Vec3f(0, 0, 0), 300).empty());
+    }
+
+    TEST_F(ActorsGridTest, actor_moved_within_grid_cell_should_be_filtered_by_new_position)
+    {
+        const MWWorld::Ptr actor = makePtr(0, 0);
+        mPositions[actor] = osg::Vec3f(10, 10, 0);
+        rebuild();
+        EXPECT_EQ(findInRange(osg::Vec3f(0, 0, 0), 100), std::vector<MWWorld::Ptr>({actor}));
+
+        mPositions[actor] = osg::Vec3f(400, 400, 0);
+        rebuild();
+        EXPECT_TRUE(findInRange(osg::Vec3f(0, 0, 0), 100).empty());
+        EXPECT_EQ(findInRange(osg::Vec3f(400, 400, 0), 100), std::vector<MWWorld::Ptr>({actor}));
+    }
+
+    TEST_F(ActorsGridTest, actor_moved_to_another_game_cell_should_be_found_with_new_ptr)
+    {
+        const MWWorld::Ptr actor = makePtr(0, 0);
+        mPositions[actor] = osg::Vec3f(0, 0, 0);
+        rebuild();
+
+        // Moving to another cell gives a new Ptr for the same reference, Actors replaces the old one
+        const MWWorld::Ptr moved = makePtr(0, 1);
+        mPositions.erase(actor);
+        mPositions[moved] = osg::Vec3f(8192, 0, 0);
+        rebuild();
+
+        EXPECT_TRUE(findInRange(osg::Vec3f(0, 0, 0), 300).empty());
+        const std::vector<MWWorld::Ptr> found = findInRange(osg::Vec3f(8192, 0, 0), 300);
+        ASSERT_EQ(found.size(), 1);
+        EXPECT_EQ(found.front().mCell, moved.mCell);
+    }
+
+    TEST_F(ActorsGridTest, rebuild_should_not_keep_removed_actors)
+    {
+        const MWWorld::Ptr actor = makePtr(0, 0);
+        mPositions[actor] = osg::Vec3f(0, 0, 0);
+        rebuild();
+        mPositions.clear();
+        rebuild();
+        EXPECT_EQ(mGrid.size(), 0);
+        EXPECT_TRUE(findInRange(osg::Vec3f(0, 0, 0), 300).empty());
+    }
+}
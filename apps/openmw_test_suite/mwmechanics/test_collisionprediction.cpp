@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwmechanics/collisionprediction.hpp"
+#include "apps/openmw/mwmechanics/taskscheduler.hpp"
+
+#include <osg/Math>
+
+#include <tuple>
+
+namespace MWMechanics
+{
+    static bool operator==(const PredictedCollision& lhs, const PredictedCollision& rhs)
+    {
+        return std::tie(lhs.mOther, lhs.mTime, lhs.mAngle, lhs.mMovementCorrection)
+            == std::tie(rhs.mOther, rhs.mTime, rhs.mAngle, rhs.mMovementCorrection);
+    }
+}
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    CollisionPredictionActor makeActor(const osg::Vec3f& position, float rotZ, const osg::Vec3f& movement)
+    {
+        CollisionPredictionActor result;
+        result.mPosition = position;
+        result.mRotZ = rotZ;
+        result.mHalfExtents = osg::Vec3f(30, 30, 60);
+        result.mMovement = movement;
+        result.mMaxSpeed = 100;
+        result.mShouldAvoidCollision = true;
+        return result;
+    }
+
+    struct MWMechanicsCollisionPredictionTest : Test
+    {
+        std::vector<CollisionPredictionActor> mActors;
+
+        FindActorsInRange makeFindActorsInRange() const
+        {
+            return [this] (const osg::Vec3f& position, float radius, std::vector<std::size_t>& out)
+            {
+                for (std::size_t i = 0; i < mActors.size(); ++i)
+                    if ((mActors[i].mPosition - position).length2() <= radius * radius)
+                        out.push_back(i);
+            };
+        }
+
+        std::vector<std::vector<PredictedCollision>> predict(int numThreads) const
+        {
+            TaskScheduler taskScheduler(numThreads);
+            return predictCollisions(mActors, makeFindActorsInRange(), taskScheduler);
+        }
+    };
+
+    TEST_F(MWMechanicsCollisionPredictionTest, actors_moving_towards_each_other_should_predict_collision)
+    {
+        mActors.push_back(makeActor(osg::Vec3f(0, 0, 0), 0, osg::Vec3f(0, 1, 0)));
+        mActors.push_back(makeActor(osg::Vec3f(0, 150, 0), osg::PI, osg::Vec3f(0, 1, 0)));
+        const auto result = predict(0);
+        ASSERT_EQ(result.size(), 2u);
+        ASSERT_EQ(result[0].size(), 1u);
+        EXPECT_EQ(result[0][0].mOther, 1u);
+        ASSERT_EQ(result[1].size(), 1u);
+        EXPECT_EQ(result[1][0].mOther, 0u);
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, actor_should_not_predict_collision_with_its_target)
+    {
+        mActors.push_back(makeActor(osg::Vec3f(0, 0, 0), 0, osg::Vec3f(0, 1, 0)));
+        mActors.push_back(makeActor(osg::Vec3f(0, 150, 0), osg::PI, osg::Vec3f(0, 1, 0)));
+        mActors[0].mCurrentTarget = 1;
+        const auto result = predict(0);
+        ASSERT_EQ(result.size(), 2u);
+        EXPECT_TRUE(result[0].empty());
+        EXPECT_EQ(result[1].size(), 1u);
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, result_should_not_depend_on_number_of_threads)
+    {
+        // Crowd of actors walking in different directions
+        for (int x = 0; x < 16; ++x)
+        {
+            for (int y = 0; y < 16; ++y)
+            {
+                const float rotZ = static_cast<float>((x * 7 + y * 13) % 16) * osg::PI / 8;
+                const osg::Vec3f movement((x + y) % 3 == 0 ? 0.5f : 0, (x * y) % 4 == 0 ? 0 : 1, 0);
+                mActors.push_back(makeActor(osg::Vec3f(x * 70.f, y * 70.f, (x % 2) * 10.f), rotZ, movement));
+                mActors.back().mIsDead = (x + y) % 11 == 0;
+                mActors.back().mShouldAvoidCollision = (x + y) % 5 != 0;
+            }
+        }
+        const auto expected = predict(0);
+        std::size_t collisions = 0;
+        for (const auto& actorCollisions : expected)
+            collisions += actorCollisions.size();
+        ASSERT_GT(collisions, 0u);
+        EXPECT_EQ(predict(1), expected);
+        EXPECT_EQ(predict(4), expected);
+    }
+}
@@ -0,0 +1,132 @@
+#include "apps/openmw/mwrender/chunkstorage.hpp"
+
+#include <components/resource/resourcesystem.hpp>
+#include <components/sceneutil/workqueue.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <osg/Geometry>
+#include <osg/Group>
+#include <osgDB/Registry>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWRender;
+
+    struct MWRenderChunkStorageTest : Test
+    {
+        const osg::Vec2f mCenter {0.5f, 0.5f};
+        const float mSize = 1;
+        const std::vector<unsigned char> mKey {{1, 2, 3, 4}};
+        const std::string mEnvironment = "environment";
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_chunks_%%%%%%%%");
+        VFS::Manager mVFS {false};
+        Resource::ResourceSystem mResourceSystem {&mVFS};
+
+        void SetUp() override
+        {
+            if (osgDB::Registry::instance()->getReaderWriterForExtension("osgb") == nullptr)
+                GTEST_SKIP() << "osgb plugin is not available";
+        }
+
+        ~MWRenderChunkStorageTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        std::unique_ptr<ChunkStorage> makeStorage(const std::string& environment, std::uintmax_t maxSize = 1024 * 1024)
+        {
+            return std::make_unique<ChunkStorage>(mResourceSystem.getSceneManager(), mPath.string(), environment, maxSize);
+        }
+
+        static osg::ref_ptr<osg::Node> makeChunk()
+        {
+            osg::ref_ptr<osg::Vec3Array> vertices(new osg::Vec3Array);
+            vertices->push_back(osg::Vec3f(0, 0, 0));
+            vertices->push_back(osg::Vec3f(1, 0, 0));
+            vertices->push_back(osg::Vec3f(0, 1, 0));
+            osg::ref_ptr<osg::Geometry> geometry(new osg::Geometry);
+            geometry->setVertexArray(vertices);
+            geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, 3));
+            osg::ref_ptr<osg::Group> group(new osg::Group);
+            group->addChild(geometry);
+            return group;
+        }
+
+        static void save(ChunkStorage& storage, const osg::Vec2f& center, float size, std::vector<unsigned char> key,
+            osg::ref_ptr<osg::Node> node)
+        {
+            const osg::ref_ptr<SceneUtil::WorkItem> item = storage.save(center, size, std::move(key), std::move(node));
+            ASSERT_NE(item, nullptr);
+            item->waitTillDone();
+        }
+    };
+
+    TEST_F(MWRenderChunkStorageTest, load_for_empty_storage_should_return_null)
+    {
+        const auto storage = makeStorage(mEnvironment);
+        EXPECT_EQ(storage->load(mCenter, mSize, mKey), nullptr);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, load_should_return_saved_chunk)
+    {
+        const auto storage = makeStorage(mEnvironment);
+        save(*storage, mCenter, mSize, mKey, makeChunk());
+        const osg::ref_ptr<osg::Node> result = storage->load(mCenter, mSize, mKey);
+        ASSERT_NE(result, nullptr);
+        const osg::Group* group = result->asGroup();
+        ASSERT_NE(group, nullptr);
+        ASSERT_EQ(group->getNumChildren(), 1u);
+        const osg::Geometry* geometry = group->getChild(0)->asGeometry();
+        ASSERT_NE(geometry, nullptr);
+        ASSERT_NE(geometry->getVertexArray(), nullptr);
+        EXPECT_EQ(geometry->getVertexArray()->getNumElements(), 3u);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, load_by_different_key_should_return_null)
+    {
+        const auto storage = makeStorage(mEnvironment);
+        save(*storage, mCenter, mSize, mKey, makeChunk());
+        EXPECT_EQ(storage->load(mCenter, mSize, {1, 2, 3}), nullptr);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, load_by_different_position_should_return_null)
+    {
+        const auto storage = makeStorage(mEnvironment);
+        save(*storage, mCenter, mSize, mKey, makeChunk());
+        EXPECT_EQ(storage->load(osg::Vec2f(1.5f, 0.5f), mSize, mKey), nullptr);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, load_in_different_environment_should_return_null)
+    {
+        save(*makeStorage(mEnvironment), mCenter, mSize, mKey, makeChunk());
+        EXPECT_EQ(makeStorage("other")->load(mCenter, mSize, mKey), nullptr);
+        EXPECT_NE(makeStorage(mEnvironment)->load(mCenter, mSize, mKey), nullptr);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, chunk_with_callback_should_not_be_saved)
+    {
+        const auto storage = makeStorage(mEnvironment);
+        const osg::ref_ptr<osg::Node> chunk = makeChunk();
+        chunk->addCullCallback(new osg::NodeCallback);
+        save(*storage, mCenter, mSize, mKey, chunk);
+        EXPECT_EQ(storage->load(mCenter, mSize, mKey), nullptr);
+    }
+
+    TEST_F(MWRenderChunkStorageTest, save_should_remove_least_recently_used_chunks_over_size_limit)
+    {
+        const auto storage = makeStorage(mEnvironment, 1);
+        save(*storage, mCenter, mSize, mKey, makeChunk());
+        save(*storage, osg::Vec2f(1.5f, 0.5f), mSize, mKey, makeChunk());
+        EXPECT_EQ(storage->load(mCenter, mSize, mKey), nullptr);
+        EXPECT_EQ(storage->load(osg::Vec2f(1.5f, 0.5f), mSize, mKey), nullptr);
+    }
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <components/compiler/extensions.hpp>
+
+#include "apps/openmw/mwscript/scriptcache.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWScript;
+
+    struct ScriptCacheTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_scripts_%%%%%%%%");
+        const std::string mText = "begin test\nshort value\nfloat ratio\nend\n";
+        const std::vector<Interpreter::Type_Code> mCode {1, 2, 3};
+        Compiler::Locals mLocals;
+        Compiler::Extensions mExtensions;
+        std::vector<std::string> mContentFiles;
+
+        ScriptCacheTest()
+        {
+            mLocals.declare('s', "value");
+            mLocals.declare('f', "ratio");
+            boost::filesystem::create_directories(mPath);
+            mContentFiles.push_back((mPath / "test.esp").string());
+            boost::filesystem::ofstream(mContentFiles.back()) << "content";
+        }
+
+        ~ScriptCacheTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        ScriptCache makeCache(std::uintmax_t maxSize = 1024 * 1024) const
+        {
+            return ScriptCache((mPath / "cache").string(), mExtensions, mContentFiles, maxSize);
+        }
+
+        std::vector<boost::filesystem::path> getCacheFiles() const
+        {
+            std::vector<boost::filesystem::path> result;
+            for (boost::filesystem::directory_iterator it(mPath / "cache"), end; it != end; ++it)
+                result.push_back(it->path());
+            return result;
+        }
+    };
+
+    TEST_F(ScriptCacheTest, get_for_empty_cache_should_return_false)
+    {
+        const ScriptCache cache = makeCache();
+        std::vector<Interpreter::Type_Code> code;
+        Compiler::Locals locals;
+        EXPECT_FALSE(cache.get("test", mText, code, locals));
+    }
+
+    TEST_F(ScriptCacheTest, get_should_return_saved_script_after_load)
+    {
+        {
+            ScriptCache cache = makeCache();
+            cache.add("Test", mText, mCode, mLocals);
+            cache.save();
+        }
+        const ScriptCache cache = makeCache();
+        std::vector<Interpreter::Type_Code> code;
+        Compiler::Locals locals;
+        ASSERT_TRUE(cache.get("test", mText, code, locals));
+        EXPECT_EQ(code, mCode);
+        EXPECT_EQ(locals.getType("value"), 's');
+        EXPECT_EQ(locals.getType("ratio"), 'f');
+    }
+
+    TEST_F(ScriptCacheTest, get_for_different_text_should_return_false)
+    {
+        {
+            ScriptCache cache = makeCache();
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        const ScriptCache cache = makeCache();
+        std::vector<Interpreter::Type_Code> code;
+        Compiler::Locals locals;
+        EXPECT_FALSE(cache.get("test", mText + "\n", code, locals));
+    }
+
+    TEST_F(ScriptCacheTest, get_after_content_file_change_should_return_false)
+    {
+        {
+            ScriptCache cache = makeCache();
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        boost::filesystem::ofstream(mContentFiles.back(), std::ios::app) << "changed";
+        const ScriptCache cache = makeCache();
+        std::vector<Interpreter::Type_Code> code;
+        Compiler::Locals locals;
+        EXPECT_FALSE(cache.get("test", mText, code, locals));
+    }
+
+    TEST_F(ScriptCacheTest, save_should_remove_cache_of_other_content_files_over_max_size)
+    {
+        {
+            ScriptCache cache = makeCache();
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        const auto oldFiles = getCacheFiles();
+        ASSERT_EQ(oldFiles.size(), 1);
+        const std::uintmax_t fileSize = boost::filesystem::file_size(oldFiles.front());
+        // Make sure the old file is the least recently used one
+        boost::filesystem::last_write_time(oldFiles.front(), boost::filesystem::last_write_time(oldFiles.front()) - 60);
+
+        boost::filesystem::ofstream(mContentFiles.back(), std::ios::app) << "changed";
+        {
+            ScriptCache cache = makeCache(fileSize + fileSize / 2);
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        const auto newFiles = getCacheFiles();
+        ASSERT_EQ(newFiles.size(), 1);
+        EXPECT_NE(newFiles.front(), oldFiles.front());
+
+        const ScriptCache cache = makeCache();
+        std::vector<Interpreter::Type_Code> code;
+        Compiler::Locals locals;
+        EXPECT_TRUE(cache.get("test", mText, code, locals));
+    }
+
+    TEST_F(ScriptCacheTest, save_should_keep_cache_of_other_content_files_within_max_size)
+    {
+        {
+            ScriptCache cache = makeCache();
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        boost::filesystem::ofstream(mContentFiles.back(), std::ios::app) << "changed";
+        {
+            ScriptCache cache = makeCache();
+            cache.add("test", mText, mCode, mLocals);
+            cache.save();
+        }
+        EXPECT_EQ(getCacheFiles().size(), 2);
+    }
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwsound/decodedsoundcache.hpp"
+#include "apps/openmw/mwsound/sound_decoder.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWSound;
+
+    std::shared_ptr<const DecodedSound> makeSound(std::size_t size)
+    {
+        auto result = std::make_shared<DecodedSound>();
+        result->mData.resize(size);
+        return result;
+    }
+
+    TEST(DecodedSoundCacheTest, get_for_empty_cache_should_return_null)
+    {
+        DecodedSoundCache cache(1024);
+        EXPECT_EQ(cache.get("sound"), nullptr);
+        EXPECT_FALSE(cache.contains("sound"));
+    }
+
+    TEST(DecodedSoundCacheTest, get_should_return_added_sound)
+    {
+        DecodedSoundCache cache(1024);
+        const auto sound = makeSound(16);
+        cache.add("sound", sound);
+        EXPECT_TRUE(cache.contains("sound"));
+        EXPECT_EQ(cache.get("sound"), sound);
+    }
+
+    TEST(DecodedSoundCacheTest, add_should_not_replace_cached_sound)
+    {
+        DecodedSoundCache cache(1024);
+        const auto sound = makeSound(16);
+        cache.add("sound", sound);
+        cache.add("sound", makeSound(16));
+        EXPECT_EQ(cache.get("sound"), sound);
+    }
+
+    TEST(DecodedSoundCacheTest, add_sound_larger_than_max_size_should_not_cache_it)
+    {
+        DecodedSoundCache cache(16);
+        cache.add("first", makeSound(8));
+        cache.add("sound", makeSound(17));
+        EXPECT_FALSE(cache.contains("sound"));
+        EXPECT_TRUE(cache.contains("first"));
+    }
+
+    TEST(DecodedSoundCacheTest, add_over_max_size_should_remove_least_recently_used_sounds)
+    {
+        DecodedSoundCache cache(32);
+        cache.add("first", makeSound(16));
+        cache.add("second", makeSound(16));
+        cache.add("third", makeSound(16));
+        EXPECT_FALSE(cache.contains("first"));
+        EXPECT_TRUE(cache.contains("second"));
+        EXPECT_TRUE(cache.contains("third"));
+    }
+
+    TEST(DecodedSoundCacheTest, get_should_make_sound_most_recently_used)
+    {
+        DecodedSoundCache cache(32);
+        cache.add("first", makeSound(16));
+        cache.add("second", makeSound(16));
+        EXPECT_NE(cache.get("first"), nullptr);
+        cache.add("third", makeSound(16));
+        EXPECT_TRUE(cache.contains("first"));
+        EXPECT_FALSE(cache.contains("second"));
+        EXPECT_TRUE(cache.contains("third"));
+    }
+
+    TEST(DecodedSoundCacheTest, add_should_remove_as_many_sounds_as_needed_to_fit_max_size)
+    {
+        DecodedSoundCache cache(32);
+        cache.add("first", makeSound(8));
+        cache.add("second", makeSound(8));
+        cache.add("third", makeSound(16));
+        cache.add("fourth", makeSound(24));
+        EXPECT_FALSE(cache.contains("first"));
+        EXPECT_FALSE(cache.contains("second"));
+        EXPECT_FALSE(cache.contains("third"));
+        EXPECT_TRUE(cache.contains("fourth"));
+    }
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwstate/savewriter.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWState;
+
+    struct SaveWriterTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_save_%%%%%%%%");
+
+        SaveWriterTest()
+        {
+            boost::filesystem::create_directories(mPath);
+        }
+
+        ~SaveWriterTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        static std::string read(const boost::filesystem::path& path)
+        {
+            boost::filesystem::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    };
+
+    TEST_F(SaveWriterTest, wait_without_write_should_return_no_error)
+    {
+        SaveWriter writer;
+        EXPECT_FALSE(writer.isWriting());
+        EXPECT_TRUE(writer.isDone());
+        EXPECT_EQ(writer.wait(), std::string());
+    }
+
+    TEST_F(SaveWriterTest, write_should_complete_with_data_in_file)
+    {
+        SaveWriter writer;
+        writer.write(mPath / "file.omwsave", "data");
+        EXPECT_TRUE(writer.isWriting());
+        EXPECT_EQ(writer.wait(), std::string());
+        EXPECT_FALSE(writer.isWriting());
+        EXPECT_EQ(read(mPath / "file.omwsave"), "data");
+    }
+
+    TEST_F(SaveWriterTest, write_should_replace_existing_file)
+    {
+        SaveWriter writer;
+        writer.write(mPath / "file.omwsave", "data");
+        EXPECT_EQ(writer.wait(), std::string());
+        writer.write(mPath / "file.omwsave", "other data");
+        EXPECT_EQ(writer.wait(), std::string());
+        EXPECT_EQ(read(mPath / "file.omwsave"), "other data");
+    }
+
+    TEST_F(SaveWriterTest, wait_should_block_until_write_is_done)
+    {
+        const std::string data(16 * 1024 * 1024, 'a');
+        SaveWriter writer;
+        writer.write(mPath / "file.omwsave", data);
+        EXPECT_EQ(writer.wait(), std::string());
+        EXPECT_TRUE(writer.isDone());
+        EXPECT_EQ(boost::filesystem::file_size(mPath / "file.omwsave"), data.size());
+    }
+
+    TEST_F(SaveWriterTest, write_error_should_be_returned_by_wait)
+    {
+        SaveWriter writer;
+        writer.write(mPath / "missing" / "file.omwsave", "data");
+        EXPECT_NE(writer.wait(), std::string());
+        EXPECT_FALSE(writer.isWriting());
+        EXPECT_FALSE(boost::filesystem::exists(mPath / "missing" / "file.omwsave"));
+    }
+
+    TEST_F(SaveWriterTest, write_error_should_not_be_returned_for_next_write)
+    {
+        SaveWriter writer;
+        writer.write(mPath / "missing" / "file.omwsave", "data");
+        EXPECT_NE(writer.wait(), std::string());
+        writer.write(mPath / "file.omwsave", "data");
+        EXPECT_EQ(writer.wait(), std::string());
+    }
+
+    TEST_F(SaveWriterTest, write_before_wait_should_throw_exception)
+    {
+        SaveWriter writer;
+        writer.write(mPath / "file.omwsave", "data");
+        EXPECT_THROW(writer.write(mPath / "other.omwsave", "data"), std::logic_error);
+        EXPECT_EQ(writer.wait(), std::string());
+    }
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwworld/cellrefindex.hpp"
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/esm/loadcell.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWWorld;
+
+    struct TestRef
+    {
+        unsigned mIndex;
+        std::string mId;
+        bool mDeleted;
+    };
+
+    struct LoadedRef
+    {
+        unsigned mIndex;
+        std::string mId;
+        bool mDeleted;
+
+        bool operator==(const LoadedRef& other) const
+        {
+            return std::tie(mIndex, mId, mDeleted) == std::tie(other.mIndex, other.mId, other.mDeleted);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const LoadedRef& value)
+    {
+        return stream << "{" << value.mIndex << ", " << value.mId << ", " << value.mDeleted << "}";
+    }
+
+    struct CellRefIndexTest : Test
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_test_cellrefindex_%%%%%%%%");
+        const std::string mFile = (mPath / "test.esm").string();
+        ESM::ESMReader mReader;
+        std::vector<ESM::Cell> mCells;
+
+        CellRefIndexTest()
+        {
+            boost::filesystem::create_directories(mPath);
+        }
+
+        ~CellRefIndexTest()
+        {
+            mReader.close();
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        static void writeCell(ESM::ESMWriter& writer, const std::string& name, const std::vector<TestRef>& refs)
+        {
+            ESM::Cell cell;
+            cell.blank();
+            cell.mName = name;
+            cell.mData.mFlags = ESM::Cell::Interior;
+            cell.mData.mX = 0;
+            cell.mData.mY = 0;
+            cell.mWater = 0;
+            cell.mWaterInt = false;
+
+            writer.startRecord(ESM::Cell::sRecordId);
+            cell.save(writer);
+            for (const TestRef& value : refs)
+            {
+                ESM::CellRef ref;
+                ref.blank();
+                ref.mRefNum.mIndex = value.mIndex;
+                ref.mRefNum.mContentFile = 0;
+                ref.mRefID = value.mId;
+                ref.save(writer, false, false, value.mDeleted);
+            }
+            writer.endRecord(ESM::Cell::sRecordId);
+        }
+
+        /// Write cells and load their records the same way ESMStore does
+        void writeAndLoad(const std::vector<std::vector<TestRef>>& cells)
+        {
+            {
+                boost::filesystem::ofstream stream(mFile, std::ios::binary);
+                ESM::ESMWriter writer;
+                writer.setFormat(0);
+                writer.save(stream);
+                for (std::size_t i = 0; i < cells.size(); ++i)
+                    writeCell(writer, "Cell " + std::to_string(i), cells[i]);
+                writer.close();
+            }
+
+            mReader.setIndex(0);
+            mReader.open(mFile);
+            while (mReader.hasMoreRecs())
+            {
+                mReader.getRecName();
+                mReader.getRecHeader();
+                bool isDeleted = false;
+                mCells.emplace_back();
+                mCells.back().load(mReader, isDeleted);
+            }
+        }
+
+        void setMoved(ESM::Cell& cell, unsigned index)
+        {
+            ESM::MovedCellRef moved;
+            moved.mRefNum.mIndex = index;
+            moved.mRefNum.mContentFile = 0;
+            moved.mTarget[0] = 1;
+            moved.mTarget[1] = 1;
+            cell.mMovedRefs.push_back(moved);
+        }
+
+        CellRefFunction collect(std::vector<LoadedRef>& result)
+        {
+            return [&result] (ESM::CellRef& ref, bool deleted)
+            {
+                result.push_back(LoadedRef {ref.mRefNum.mIndex, ref.mRefID, deleted});
+            };
+        }
+    };
+
+    TEST_F(CellRefIndexTest, readCellRefs_should_index_all_references)
+    {
+        writeAndLoad({{{1, "Apparatus_A", false}, {2, "Book_B", true}, {3, "Door_C", false}}});
+
+        std::vector<LoadedRef> loaded;
+        std::vector<CellRefIndex::Ref> refs;
+        readCellRefs(mCells[0], 0, mReader, &refs, collect(loaded));
+
+        EXPECT_EQ(loaded, std::vector<LoadedRef>({{1, "Apparatus_A", false}, {2, "Book_B", true}, {3, "Door_C", false}}));
+        ASSERT_EQ(refs.size(), 3);
+        EXPECT_EQ(refs[0].mRefId, "apparatus_a");
+        EXPECT_EQ(refs[1].mRefId, "book_b");
+        EXPECT_TRUE(refs[1].mDeleted);
+        EXPECT_EQ(refs[2].mRefNum.mIndex, 3);
+        EXPECT_FALSE(refs[2].mMoved);
+    }
+
+    TEST_F(CellRefIndexTest, readCellRefs_should_skip_moved_references_but_index_them)
+    {
+        writeAndLoad({{{1, "Apparatus_A", false}, {2, "Book_B", false}, {3, "Door_C", false}}});
+        setMoved(mCells[0], 2);
+
+        std::vector<LoadedRef> loaded;
+        std::vector<CellRefIndex::Ref> refs;
+        readCellRefs(mCells[0], 0, mReader, &refs, collect(loaded));
+
+        EXPECT_EQ(loaded, std::vector<LoadedRef>({{1, "Apparatus_A", false}, {3, "Door_C", false}}));
+        ASSERT_EQ(refs.size(), 3);
+        EXPECT_TRUE(refs[1].mMoved);
+    }
+
+    TEST_F(CellRefIndexTest, readIndexedCellRefs_should_give_same_references_as_readCellRefs)
+    {
+        writeAndLoad({
+            {{1, "Apparatus_A", false}, {2, "Book_B", true}, {3, "Door_C", false}},
+            {{4, "Ingredient_D", false}, {5, "Light_E", false}},
+        });
+        setMoved(mCells[0], 1);
+
+        for (std::size_t i = 0; i < mCells.size(); ++i)
+        {
+            std::vector<LoadedRef> expected;
+            std::vector<CellRefIndex::Ref> refs;
+            readCellRefs(mCells[i], 0, mReader, &refs, collect(expected));
+
+            // Index is used for a reader at a different position
+            std::vector<LoadedRef> loaded;
+            mCells[mCells.size() - 1 - i].restore(mReader, 0);
+            readIndexedCellRefs(mCells[i], 0, mReader, refs, collect(loaded));
+            EXPECT_EQ(loaded, expected) << i;
+        }
+    }
+
+    TEST_F(CellRefIndexTest, readIndexedCellRefs_should_seek_over_moved_references)
+    {
+        writeAndLoad({{{1, "Apparatus_A", false}, {2, "Book_B", false}, {3, "Door_C", false}, {4, "Light_D", false}}});
+        setMoved(mCells[0], 1);
+        setMoved(mCells[0], 3);
+
+        std::vector<LoadedRef> expected;
+        std::vector<CellRefIndex::Ref> refs;
+        readCellRefs(mCells[0], 0, mReader, &refs, collect(expected));
+
+        std::vector<LoadedRef> loaded;
+        readIndexedCellRefs(mCells[0], 0, mReader, refs, collect(loaded));
+
+        EXPECT_EQ(expected, std::vector<LoadedRef>({{2, "Book_B", false}, {4, "Light_D", false}}));
+        EXPECT_EQ(loaded, expected);
+    }
+
+    TEST_F(CellRefIndexTest, readIndexedCellRefs_should_work_after_reader_is_reopened)
+    {
+        writeAndLoad({{{1, "Apparatus_A", false}, {2, "Book_B", false}}});
+        setMoved(mCells[0], 1);
+
+        std::vector<LoadedRef> expected;
+        std::vector<CellRefIndex::Ref> refs;
+        readCellRefs(mCells[0], 0, mReader, &refs, collect(expected));
+
+        mReader.close();
+        mReader.open(mFile);
+
+        std::vector<LoadedRef> loaded;
+        readIndexedCellRefs(mCells[0], 0, mReader, refs, collect(loaded));
+        EXPECT_EQ(loaded, expected);
+    }
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
 
 #include <components/files/configurationmanager.hpp>
 #include <components/files/escape.hpp>
@@ -10,6 +13,7 @@
 
 #include "apps/openmw/mwworld/esmstore.hpp"
 #include "apps/openmw/mwmechanics/spelllist.hpp"
+#include "apps/openmw/mwmechanics/taskscheduler.hpp"
 
 namespace MWMechanics
 {
@@ -318,3 +322,196 @@ TEST_F(StoreTest, overwrite_test)
 
     ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
 }
+
+/// Base class for tests of ESMStore loading content files written to a temporary directory
+struct StoreContentFilesTest : public ::testing::Test
+{
+protected:
+    const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path("openmw_test_store_%%%%%%%%");
+    std::vector<boost::filesystem::path> mFiles;
+
+    StoreContentFilesTest()
+    {
+        boost::filesystem::create_directories(mPath);
+    }
+
+    ~StoreContentFilesTest()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(mPath, ec);
+    }
+
+    template <typename Function>
+    void writeFile(const std::string& name, Function&& writeRecords)
+    {
+        boost::filesystem::ofstream stream(mPath / name, std::ios::binary);
+        ESM::ESMWriter writer;
+        writer.setFormat(0);
+        writer.save(stream);
+        writeRecords(writer);
+        writer.close();
+        mFiles.push_back(mPath / name);
+    }
+
+    template <typename T>
+    static void writeRecord(ESM::ESMWriter& writer, const T& record, bool deleted = false)
+    {
+        writer.startRecord(T::sRecordId);
+        record.save(writer, deleted);
+        writer.endRecord(T::sRecordId);
+    }
+
+    /// Load all files with the given number of threads, either as a whole or one by one
+    void load(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers, int threads, bool perFile)
+    {
+        MWMechanics::TaskScheduler taskScheduler(threads);
+        readers.resize(mFiles.size());
+        std::vector<ESM::ESMReader*> pending;
+
+        for (std::size_t i = 0; i < mFiles.size(); ++i)
+        {
+            ESM::ESMReader& reader = readers[i];
+            reader.setIndex(static_cast<int>(i));
+            reader.setGlobalReaderList(&readers);
+            reader.openMapped(mFiles[i].string());
+            if (perFile)
+                store.load(reader, &dummyListener, &taskScheduler);
+            else
+                pending.push_back(&reader);
+        }
+
+        if (!pending.empty())
+            store.load(pending, &dummyListener, taskScheduler);
+
+        store.setUp();
+    }
+};
+
+template <typename T, typename Function>
+std::vector<std::pair<std::string, std::string>> getRecords(const MWWorld::ESMStore& store, Function&& getValue)
+{
+    std::vector<std::pair<std::string, std::string>> result;
+    for (const T& record : store.get<T>())
+        result.emplace_back(record.mId, getValue(record));
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/// Tests that content files loaded on worker threads give the same stores as loaded by a single thread.
+TEST_F(StoreContentFilesTest, load_by_multiple_threads_should_give_same_result_as_by_single_thread)
+{
+    // More records than a single job reads to have multiple jobs per file
+    writeFile("master.esm", [] (ESM::ESMWriter& writer)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            ESM::Apparatus apparatus;
+            apparatus.blank();
+            apparatus.mId = "apparatus_" + std::to_string(i);
+            apparatus.mModel = "master_" + std::to_string(i);
+            writeRecord(writer, apparatus);
+        }
+        for (int i = 0; i < 10; ++i)
+        {
+            ESM::Book book;
+            book.blank();
+            book.mId = "book_" + std::to_string(i);
+            book.mName = "master_" + std::to_string(i);
+            writeRecord(writer, book);
+        }
+    });
+
+    writeFile("first.esp", [] (ESM::ESMWriter& writer)
+    {
+        ESM::Apparatus apparatus;
+        apparatus.blank();
+        apparatus.mId = "apparatus_1";
+        apparatus.mModel = "first";
+        writeRecord(writer, apparatus);
+        apparatus.mId = "apparatus_2";
+        writeRecord(writer, apparatus, true);
+
+        ESM::Book book;
+        book.blank();
+        book.mId = "book_0";
+        writeRecord(writer, book, true);
+        book.mId = "book_new";
+        book.mName = "first";
+        writeRecord(writer, book);
+    });
+
+    writeFile("second.esp", [] (ESM::ESMWriter& writer)
+    {
+        ESM::Apparatus apparatus;
+        apparatus.blank();
+        apparatus.mId = "Apparatus_1";
+        apparatus.mModel = "second";
+        writeRecord(writer, apparatus);
+        apparatus.mId = "apparatus_2";
+        writeRecord(writer, apparatus);
+    });
+
+    const auto getModel = [] (const ESM::Apparatus& record) { return record.mModel; };
+    const auto getName = [] (const ESM::Book& record) { return record.mName; };
+
+    MWWorld::ESMStore expected;
+    std::vector<ESM::ESMReader> expectedReaders;
+    load(expected, expectedReaders, 0, true);
+
+    const auto expectedApparatus = getRecords<ESM::Apparatus>(expected, getModel);
+    const auto expectedBooks = getRecords<ESM::Book>(expected, getName);
+    ASSERT_EQ(expectedApparatus.size(), 3000);
+    EXPECT_EQ(expected.get<ESM::Apparatus>().find("apparatus_1")->mModel, "second");
+    EXPECT_EQ(expected.get<ESM::Apparatus>().find("apparatus_2")->mModel, "second");
+    EXPECT_EQ(expected.get<ESM::Book>().search("book_0"), nullptr);
+    EXPECT_EQ(expectedBooks.size(), 10);
+
+    for (const int threads : {1, 3})
+    {
+        for (const bool perFile : {false, true})
+        {
+            MWWorld::ESMStore actual;
+            std::vector<ESM::ESMReader> actualReaders;
+            load(actual, actualReaders, threads, perFile);
+
+            EXPECT_EQ(getRecords<ESM::Apparatus>(actual, getModel), expectedApparatus)
+                << "threads=" << threads << " perFile=" << perFile;
+            EXPECT_EQ(getRecords<ESM::Book>(actual, getName), expectedBooks)
+                << "threads=" << threads << " perFile=" << perFile;
+        }
+    }
+}
+
+/// Tests lookups of static and dynamic records by ID in any letter case.
+TEST_F(StoreTest, search_ignores_case_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    MWWorld::Store<RecordType> store;
+
+    RecordType record;
+    record.blank();
+    record.mId = "FooBar";
+    record.mModel = "static_model";
+    store.insertStatic(record);
+
+    ASSERT_TRUE (store.search("foobar") != nullptr);
+    EXPECT_EQ (store.search("FOOBAR")->mModel, "static_model");
+    EXPECT_FALSE (store.isDynamic("foobar"));
+    EXPECT_TRUE (store.search("foo") == nullptr);
+
+    // dynamic records take precedence over static ones with the same ID
+    record.mModel = "dynamic_model";
+    store.insert(record);
+    EXPECT_TRUE (store.isDynamic("FooBar"));
+    EXPECT_EQ (store.search("fooBAR")->mModel, "dynamic_model");
+    EXPECT_EQ (store.searchStatic("fooBAR")->mModel, "static_model");
+
+    store.erase("FOOBAR");
+    EXPECT_FALSE (store.isDynamic("foobar"));
+    EXPECT_EQ (store.search("foobar")->mModel, "static_model");
+
+    store.eraseStatic("foobar");
+    EXPECT_TRUE (store.search("foobar") == nullptr);
+}
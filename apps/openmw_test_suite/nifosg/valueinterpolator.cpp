@@ -0,0 +1,126 @@
+#include <components/nif/nifkey.hpp>
+#include <components/nifosg/controller.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+
+    struct NifOsgValueInterpolatorTest : Test
+    {
+        std::string mData;
+
+        void writeUInt(std::uint32_t value)
+        {
+            mData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void writeFloat(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeUInt(bits);
+        }
+
+        void writeLinearKeys(const std::vector<std::pair<float, float>>& keys)
+        {
+            writeUInt(static_cast<std::uint32_t>(keys.size()));
+            writeUInt(Nif::InterpolationType_Linear);
+            for (const auto& key : keys)
+            {
+                writeFloat(key.first);
+                writeFloat(key.second);
+            }
+        }
+
+        std::shared_ptr<Nif::FloatKeyMap> read()
+        {
+            // Key groups without morph data don't depend on the file version
+            Nif::NIFStream nif(nullptr, std::make_shared<std::istringstream>(mData));
+            auto result = std::make_shared<Nif::FloatKeyMap>();
+            result->read(&nif);
+            return result;
+        }
+
+        static std::vector<float> getValues(const Nif::FloatKeyMap& keys)
+        {
+            std::vector<float> result;
+            for (const auto& key : keys.mKeys)
+                result.push_back(key.mValue);
+            return result;
+        }
+    };
+
+    TEST_F(NifOsgValueInterpolatorTest, ordered_keys_should_be_read_as_is)
+    {
+        writeLinearKeys({{0, 1}, {1, 2}, {2, 4}});
+        const auto keys = read();
+        EXPECT_EQ(keys->mTimes, std::vector<float>({0, 1, 2}));
+        EXPECT_EQ(getValues(*keys), std::vector<float>({1, 2, 4}));
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, unordered_keys_should_be_sorted_by_time)
+    {
+        writeLinearKeys({{2, 4}, {0, 1}, {1, 2}});
+        const auto keys = read();
+        EXPECT_EQ(keys->mTimes, std::vector<float>({0, 1, 2}));
+        EXPECT_EQ(getValues(*keys), std::vector<float>({1, 2, 4}));
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, last_key_should_be_used_for_duplicate_time)
+    {
+        writeLinearKeys({{1, 2}, {0, 1}, {1, 3}, {0, 5}});
+        const auto keys = read();
+        EXPECT_EQ(keys->mTimes, std::vector<float>({0, 1}));
+        EXPECT_EQ(getValues(*keys), std::vector<float>({5, 3}));
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, no_keys_should_give_default_value)
+    {
+        writeUInt(0);
+        const NifOsg::ValueInterpolator<Nif::FloatKeyMap> interpolator(read(), 42.f);
+        EXPECT_TRUE(interpolator.empty());
+        EXPECT_EQ(interpolator.interpKey(1), 42.f);
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, time_out_of_keys_range_should_give_border_values)
+    {
+        writeLinearKeys({{1, 10}, {2, 20}});
+        const NifOsg::ValueInterpolator<Nif::FloatKeyMap> interpolator(read());
+        EXPECT_EQ(interpolator.interpKey(0), 10.f);
+        EXPECT_EQ(interpolator.interpKey(3), 20.f);
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, interpolation_should_not_depend_on_previous_time)
+    {
+        writeLinearKeys({{0, 0}, {1, 10}, {2, 30}, {3, 60}, {4, 100}});
+        const NifOsg::ValueInterpolator<Nif::FloatKeyMap> interpolator(read());
+        const std::vector<std::pair<float, float>> expected {
+            {0.5f, 5}, {1.5f, 20}, {2.5f, 45}, {3.5f, 80}, // forward, one key at a time
+            {3.75f, 90}, {0.25f, 2.5f}, {2, 30}, // backward and random jumps
+            {2.25f, 37.5f}, {3.25f, 70}, {1, 10}, {4, 100},
+        };
+        for (const auto& v : expected)
+            EXPECT_FLOAT_EQ(interpolator.interpKey(v.first), v.second) << v.first;
+    }
+
+    TEST_F(NifOsgValueInterpolatorTest, constant_keys_should_switch_after_half_of_interval)
+    {
+        writeUInt(2);
+        writeUInt(Nif::InterpolationType_Constant);
+        for (const float v : {0.f, 1.f, 1.f, 2.f})
+            writeFloat(v);
+        const NifOsg::ValueInterpolator<Nif::FloatKeyMap> interpolator(read());
+        EXPECT_EQ(interpolator.interpKey(0.25f), 1.f);
+        EXPECT_EQ(interpolator.interpKey(0.75f), 2.f);
+    }
+}
@@ -0,0 +1,155 @@
+#include <components/resource/objectcache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Node>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    template <class T>
+    using GenericObjectCachePtr = osg::ref_ptr<GenericObjectCache<T>>;
+
+    TEST(ResourceGenericObjectCacheTest, added_object_should_be_found_by_key)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        osg::ref_ptr<osg::Object> value(new osg::Node);
+        cache->addEntryToObjectCache("key", value.get());
+        EXPECT_EQ(cache->getRefFromObjectCache("key"), value);
+        EXPECT_EQ(cache->getRefFromObjectCache("other"), nullptr);
+        EXPECT_EQ(cache->getCacheSize(), 1u);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, adding_object_with_existing_key_should_replace_it)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        osg::ref_ptr<osg::Object> first(new osg::Node);
+        osg::ref_ptr<osg::Object> second(new osg::Node);
+        cache->addEntryToObjectCache("key", first.get());
+        cache->addEntryToObjectCache("key", second.get());
+        EXPECT_EQ(cache->getRefFromObjectCache("key"), second);
+        EXPECT_EQ(cache->getCacheSize(), 1u);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, objects_should_be_counted_and_visited_over_all_shards)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        std::vector<std::string> keys;
+        for (int i = 0; i < 100; ++i)
+        {
+            keys.push_back("key" + std::to_string(i));
+            cache->addEntryToObjectCache(keys.back(), new osg::Node);
+        }
+        EXPECT_EQ(cache->getCacheSize(), 100u);
+
+        std::vector<std::string> visited;
+        auto collect = [&] (const std::string& key, osg::Object*) { visited.push_back(key); };
+        cache->call(collect);
+        std::sort(keys.begin(), keys.end());
+        std::sort(visited.begin(), visited.end());
+        EXPECT_EQ(visited, keys);
+
+        cache->clear();
+        EXPECT_EQ(cache->getCacheSize(), 0u);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, removed_object_should_not_be_found)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        cache->addEntryToObjectCache("key", new osg::Node);
+        cache->addEntryToObjectCache("other", new osg::Node);
+        cache->removeFromObjectCache("key");
+        EXPECT_EQ(cache->getRefFromObjectCache("key"), nullptr);
+        EXPECT_NE(cache->getRefFromObjectCache("other"), nullptr);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, checkInObjectCache_should_update_time_stamp)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        cache->addEntryToObjectCache("key", new osg::Node, 1);
+        EXPECT_TRUE(cache->checkInObjectCache("key", 10));
+        EXPECT_FALSE(cache->checkInObjectCache("other", 10));
+        cache->removeExpiredObjectsInCache(5);
+        EXPECT_NE(cache->getRefFromObjectCache("key"), nullptr);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, expired_objects_should_be_removed)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        cache->addEntryToObjectCache("old", new osg::Node, 1);
+        cache->addEntryToObjectCache("expiry", new osg::Node, 5);
+        cache->addEntryToObjectCache("new", new osg::Node, 10);
+        cache->removeExpiredObjectsInCache(5);
+        EXPECT_EQ(cache->getRefFromObjectCache("old"), nullptr);
+        EXPECT_EQ(cache->getRefFromObjectCache("expiry"), nullptr);
+        EXPECT_NE(cache->getRefFromObjectCache("new"), nullptr);
+        EXPECT_EQ(cache->getCacheSize(), 1u);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, externally_referenced_objects_should_not_expire)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        osg::ref_ptr<osg::Object> referenced(new osg::Node);
+        cache->addEntryToObjectCache("referenced", referenced.get(), 1);
+        cache->addEntryToObjectCache("unreferenced", new osg::Node, 1);
+        cache->updateTimeStampOfObjectsInCacheWithExternalReferences(10);
+        cache->removeExpiredObjectsInCache(5);
+        EXPECT_EQ(cache->getRefFromObjectCache("referenced"), referenced);
+        EXPECT_EQ(cache->getRefFromObjectCache("unreferenced"), nullptr);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, objects_without_time_stamp_should_get_it_on_update)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        cache->addEntryToObjectCache("key", new osg::Node);
+        cache->updateTimeStampOfObjectsInCacheWithExternalReferences(10);
+        cache->removeExpiredObjectsInCache(5);
+        EXPECT_NE(cache->getRefFromObjectCache("key"), nullptr);
+        cache->removeExpiredObjectsInCache(10);
+        EXPECT_EQ(cache->getRefFromObjectCache("key"), nullptr);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, should_support_compound_keys)
+    {
+        GenericObjectCachePtr<std::pair<int, int>> pairCache(new GenericObjectCache<std::pair<int, int>>);
+        pairCache->addEntryToObjectCache(std::make_pair(1, 2), new osg::Node);
+        EXPECT_NE(pairCache->getRefFromObjectCache(std::make_pair(1, 2)), nullptr);
+        EXPECT_EQ(pairCache->getRefFromObjectCache(std::make_pair(2, 1)), nullptr);
+
+        using ChunkKey = std::tuple<osg::Vec2f, float, unsigned int>;
+        GenericObjectCachePtr<ChunkKey> tupleCache(new GenericObjectCache<ChunkKey>);
+        tupleCache->addEntryToObjectCache(ChunkKey(osg::Vec2f(1, 2), 0.5f, 3), new osg::Node);
+        EXPECT_NE(tupleCache->getRefFromObjectCache(ChunkKey(osg::Vec2f(1, 2), 0.5f, 3)), nullptr);
+        EXPECT_EQ(tupleCache->getRefFromObjectCache(ChunkKey(osg::Vec2f(2, 1), 0.5f, 3)), nullptr);
+    }
+
+    TEST(ResourceGenericObjectCacheTest, concurrent_access_should_keep_all_objects)
+    {
+        osg::ref_ptr<ObjectCache> cache(new ObjectCache);
+        const int threadsNumber = 4;
+        const int objectsPerThread = 250;
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < threadsNumber; ++thread)
+            threads.emplace_back([&, thread] {
+                for (int i = 0; i < objectsPerThread; ++i)
+                {
+                    const std::string key = std::to_string(thread) + "_" + std::to_string(i);
+                    cache->addEntryToObjectCache(key, new osg::Node, 1);
+                    EXPECT_NE(cache->getRefFromObjectCache(key), nullptr);
+                    EXPECT_TRUE(cache->checkInObjectCache(key, 2));
+                }
+            });
+        for (std::thread& thread : threads)
+            thread.join();
+        EXPECT_EQ(cache->getCacheSize(), static_cast<unsigned>(threadsNumber * objectsPerThread));
+    }
+}
@@ -0,0 +1,74 @@
+#include <components/sceneutil/morphing.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct SceneUtilMorphingTest : Test
+    {
+        std::vector<float> makeValues(std::size_t count, float base) const
+        {
+            std::vector<float> result(count);
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = base + static_cast<float>(i) * 0.5f;
+            return result;
+        }
+    };
+
+    TEST_F(SceneUtilMorphingTest, no_targets_should_copy_source)
+    {
+        const std::vector<float> src = makeValues(9, 1);
+        std::vector<float> dst(src.size(), 42);
+        applyMorphTargets(src.data(), {}, dst.data(), dst.size());
+        EXPECT_EQ(dst, src);
+    }
+
+    TEST_F(SceneUtilMorphingTest, should_add_weighted_offsets_of_all_targets)
+    {
+        // Size is not a multiple of 4 to cover the tail after the vectorized part
+        const std::size_t count = 3 * 7;
+        const std::vector<float> src = makeValues(count, 1);
+        const std::vector<float> first = makeValues(count, -2);
+        const std::vector<float> second = makeValues(count, 3);
+        std::vector<float> dst(count);
+
+        applyMorphTargets(src.data(), {{first.data(), 0.5f}, {second.data(), -0.25f}}, dst.data(), count);
+
+        for (std::size_t i = 0; i < count; ++i)
+            EXPECT_FLOAT_EQ(dst[i], src[i] + first[i] * 0.5f + second[i] * -0.25f) << i;
+    }
+
+    TEST_F(SceneUtilMorphingTest, should_write_only_given_number_of_values)
+    {
+        const std::vector<float> src = makeValues(6, 1);
+        const std::vector<float> offsets(6, 1);
+        std::vector<float> dst(8, 42);
+
+        applyMorphTargets(src.data(), {{offsets.data(), 2}}, dst.data(), 5);
+
+        for (std::size_t i = 0; i < 5; ++i)
+            EXPECT_FLOAT_EQ(dst[i], src[i] + 2) << i;
+        EXPECT_EQ(dst[5], 42);
+        EXPECT_EQ(dst[6], 42);
+        EXPECT_EQ(dst[7], 42);
+    }
+
+    TEST_F(SceneUtilMorphingTest, should_support_unaligned_data)
+    {
+        const std::vector<float> src = makeValues(13, 1);
+        const std::vector<float> offsets = makeValues(13, -1);
+        std::vector<float> dst(13, 42);
+
+        applyMorphTargets(src.data() + 1, {{offsets.data() + 1, 1}}, dst.data() + 1, 12);
+
+        EXPECT_EQ(dst[0], 42);
+        for (std::size_t i = 1; i < dst.size(); ++i)
+            EXPECT_FLOAT_EQ(dst[i], src[i] + offsets[i]) << i;
+    }
+}
@@ -0,0 +1,114 @@
+#include <components/sceneutil/skinning.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    osg::Matrixf makeAffineMatrix(float base)
+    {
+        osg::Matrixf result;
+        float* ptr = result.ptr();
+        for (int i = 0; i < 16; ++i)
+            ptr[i] = base + i * 0.25f - (i % 3) * 1.5f;
+        ptr[3] = ptr[7] = ptr[11] = 0;
+        ptr[15] = 1;
+        return result;
+    }
+
+    void expectNear(const osg::Vec3f& actual, const osg::Vec3f& expected)
+    {
+        for (int i = 0; i < 3; ++i)
+            EXPECT_NEAR(actual[i], expected[i], 1e-4f * (1 + std::abs(expected[i]))) << i;
+    }
+
+    struct SceneUtilSkinningTest : Test
+    {
+        const osg::Matrixf mMatrix = makeAffineMatrix(0.5f);
+        const std::vector<osg::Vec3f> mPositions {{1, 2, 3}, {-4, 5, -6}, {0.5f, -0.25f, 7}, {-1, -1, -1}};
+        const std::vector<osg::Vec3f> mNormals {{0, 0, 1}, {0, 1, 0}, {1, 0, 0}, {0.6f, 0.8f, 0}};
+        const std::vector<osg::Vec4f> mTangents {{1, 0, 0, 1}, {0, 0, 1, -1}, {0, 1, 0, 1}, {0.8f, 0, 0.6f, -1}};
+        const osg::Vec3f mUnchanged {42, 42, 42};
+    };
+
+    TEST_F(SceneUtilSkinningTest, accumulateSkinningMatrix_should_add_weighted_product)
+    {
+        const osg::Matrixf invBind = makeAffineMatrix(1);
+        const osg::Matrixf bone = makeAffineMatrix(-2);
+        osg::Matrixf result = makeAffineMatrix(3);
+        const osg::Matrixf initial = result;
+
+        accumulateSkinningMatrix(invBind, bone, 0.25f, result);
+
+        const osg::Matrixf product = invBind * bone;
+        for (int row = 0; row < 4; ++row)
+            for (int column = 0; column < 3; ++column)
+            {
+                const int i = row * 4 + column;
+                const float expected = initial.ptr()[i] + product.ptr()[i] * 0.25f;
+                EXPECT_NEAR(result.ptr()[i], expected, 1e-4f * (1 + std::abs(expected))) << i;
+            }
+    }
+
+    TEST_F(SceneUtilSkinningTest, accumulateSkinningMatrix_should_not_change_last_column)
+    {
+        osg::Matrixf result = makeAffineMatrix(3);
+        result.ptr()[3] = 13;
+        result.ptr()[7] = 17;
+        result.ptr()[11] = 19;
+        result.ptr()[15] = 23;
+
+        accumulateSkinningMatrix(makeAffineMatrix(1), makeAffineMatrix(-2), 1, result);
+
+        EXPECT_EQ(result.ptr()[3], 13);
+        EXPECT_EQ(result.ptr()[7], 17);
+        EXPECT_EQ(result.ptr()[11], 19);
+        EXPECT_EQ(result.ptr()[15], 23);
+    }
+
+    TEST_F(SceneUtilSkinningTest, skinVertices_should_transform_listed_vertices_only)
+    {
+        const std::vector<unsigned short> vertices {2, 0};
+        std::vector<osg::Vec3f> positions(mPositions.size(), mUnchanged);
+        std::vector<osg::Vec3f> normals(mNormals.size(), mUnchanged);
+        std::vector<osg::Vec4f> tangents(mTangents.size(), osg::Vec4f(mUnchanged, 42));
+
+        skinVertices(mMatrix, vertices.data(), vertices.size(), mPositions.data(), positions.data(),
+                     mNormals.data(), normals.data(), mTangents.data(), tangents.data());
+
+        for (const unsigned short vertex : vertices)
+        {
+            expectNear(positions[vertex], mMatrix.preMult(mPositions[vertex]));
+            expectNear(normals[vertex], osg::Matrixf::transform3x3(mNormals[vertex], mMatrix));
+            const osg::Vec4f& tangent = mTangents[vertex];
+            const osg::Vec3f expected = osg::Matrixf::transform3x3(osg::Vec3f(tangent.x(), tangent.y(), tangent.z()), mMatrix);
+            expectNear(osg::Vec3f(tangents[vertex].x(), tangents[vertex].y(), tangents[vertex].z()), expected);
+            EXPECT_EQ(tangents[vertex].w(), tangent.w());
+        }
+
+        // Vertices are stored tightly, writing one must not touch its neighbours
+        for (const unsigned short vertex : {1, 3})
+        {
+            EXPECT_EQ(positions[vertex], mUnchanged) << vertex;
+            EXPECT_EQ(normals[vertex], mUnchanged) << vertex;
+            EXPECT_EQ(tangents[vertex], osg::Vec4f(mUnchanged, 42)) << vertex;
+        }
+    }
+
+    TEST_F(SceneUtilSkinningTest, skinVertices_should_support_missing_normals_and_tangents)
+    {
+        const std::vector<unsigned short> vertices {0, 1, 2, 3};
+        std::vector<osg::Vec3f> positions(mPositions.size());
+
+        skinVertices(mMatrix, vertices.data(), vertices.size(), mPositions.data(), positions.data(),
+                     nullptr, nullptr, nullptr, nullptr);
+
+        for (const unsigned short vertex : vertices)
+            expectNear(positions[vertex], mMatrix.preMult(mPositions[vertex]));
+    }
+}
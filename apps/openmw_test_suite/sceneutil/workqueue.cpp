@@ -0,0 +1,137 @@
+#include <components/sceneutil/workqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct FunctionWorkItem : WorkItem
+    {
+        std::function<void ()> mFunction;
+
+        explicit FunctionWorkItem(std::function<void ()> function)
+            : mFunction(std::move(function))
+        {}
+
+        void doWork() override
+        {
+            mFunction();
+        }
+    };
+
+    struct Gate
+    {
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        bool mOpen = false;
+
+        void open()
+        {
+            {
+                const std::lock_guard<std::mutex> lock(mMutex);
+                mOpen = true;
+            }
+            mCondition.notify_all();
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [&] { return mOpen; });
+        }
+    };
+
+    struct SceneUtilWorkQueueTest : Test
+    {
+        std::mutex mMutex;
+        std::vector<std::string> mDone;
+
+        osg::ref_ptr<FunctionWorkItem> makeItem(const std::string& name, Gate* gate = nullptr)
+        {
+            return new FunctionWorkItem([this, name, gate] {
+                if (gate != nullptr)
+                    gate->wait();
+                const std::lock_guard<std::mutex> lock(mMutex);
+                mDone.push_back(name);
+            });
+        }
+    };
+
+    TEST_F(SceneUtilWorkQueueTest, added_item_should_be_done)
+    {
+        osg::ref_ptr<WorkQueue> queue = new WorkQueue(1);
+        const auto item = makeItem("item");
+        queue->addWorkItem(item);
+        item->waitTillDone();
+        EXPECT_FALSE(item->isCancelled());
+        EXPECT_EQ(mDone, std::vector<std::string>({"item"}));
+    }
+
+    TEST_F(SceneUtilWorkQueueTest, cancelled_item_should_not_be_run)
+    {
+        osg::ref_ptr<WorkQueue> queue = new WorkQueue(1);
+        Gate gate;
+        const auto blocking = makeItem("blocking", &gate);
+        const auto cancelled = makeItem("cancelled");
+        queue->addWorkItem(blocking);
+        queue->addWorkItem(cancelled);
+        cancelled->cancel();
+        gate.open();
+        cancelled->waitTillDone();
+        blocking->waitTillDone();
+        EXPECT_TRUE(cancelled->isDone());
+        EXPECT_TRUE(cancelled->isCancelled());
+        EXPECT_EQ(mDone, std::vector<std::string>({"blocking"}));
+    }
+
+    TEST_F(SceneUtilWorkQueueTest, dependent_item_should_be_run_after_dependency)
+    {
+        osg::ref_ptr<WorkQueue> queue = new WorkQueue(2);
+        Gate gate;
+        const auto dependency = makeItem("dependency", &gate);
+        const auto dependent = makeItem("dependent");
+        dependent->addDependency(dependency);
+        queue->addWorkItem(dependent);
+        queue->addWorkItem(dependency);
+        EXPECT_FALSE(dependent->isDone());
+        gate.open();
+        dependent->waitTillDone();
+        EXPECT_TRUE(dependency->isDone());
+        EXPECT_EQ(mDone, std::vector<std::string>({"dependency", "dependent"}));
+    }
+
+    TEST_F(SceneUtilWorkQueueTest, item_with_done_dependency_should_be_run)
+    {
+        osg::ref_ptr<WorkQueue> queue = new WorkQueue(1);
+        const auto dependency = makeItem("dependency");
+        queue->addWorkItem(dependency);
+        dependency->waitTillDone();
+        const auto dependent = makeItem("dependent");
+        dependent->addDependency(dependency);
+        queue->addWorkItem(dependent);
+        dependent->waitTillDone();
+        EXPECT_EQ(mDone, std::vector<std::string>({"dependency", "dependent"}));
+    }
+
+    TEST_F(SceneUtilWorkQueueTest, dependent_item_should_be_done_when_queue_is_destroyed)
+    {
+        osg::ref_ptr<WorkQueue> queue = new WorkQueue(1);
+        const auto dependency = makeItem("dependency");
+        const auto dependent = makeItem("dependent");
+        dependent->addDependency(dependency);
+        queue->addWorkItem(dependent);
+        queue->addWorkItem(dependency);
+        queue = nullptr;
+        dependency->waitTillDone();
+        dependent->waitTillDone();
+        EXPECT_TRUE(dependent->isDone());
+    }
+}
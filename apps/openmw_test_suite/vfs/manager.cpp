@@ -0,0 +1,99 @@
+#include <components/vfs/archive.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+
+    struct TestFile : VFS::File
+    {
+        std::string mContent;
+
+        explicit TestFile(const std::string& content) : mContent(content) {}
+
+        Files::IStreamPtr open() override
+        {
+            return std::make_shared<std::istringstream>(mContent);
+        }
+    };
+
+    struct TestArchive : VFS::Archive
+    {
+        std::map<std::string, TestFile> mFiles;
+
+        void listResources(std::map<std::string, VFS::File*>& out, char (*normalize_function) (char)) override
+        {
+            for (auto& file : mFiles)
+            {
+                std::string name = file.first;
+                std::transform(name.begin(), name.end(), name.begin(), normalize_function);
+                out[name] = &file.second;
+            }
+        }
+    };
+
+    std::string read(const Files::IStreamPtr& stream)
+    {
+        std::string result;
+        std::getline(*stream, result);
+        return result;
+    }
+
+    struct VFSManagerTest : Test
+    {
+        VFS::Manager mManager {false};
+
+        VFSManagerTest()
+        {
+            auto first = new TestArchive;
+            first->mFiles.emplace("Meshes\\Foo.NIF", TestFile("first"));
+            first->mFiles.emplace("textures\\bar.dds", TestFile("bar"));
+            mManager.addArchive(first);
+            auto second = new TestArchive;
+            second->mFiles.emplace("meshes/foo.nif", TestFile("second"));
+            mManager.addArchive(second);
+            mManager.buildIndex();
+        }
+    };
+
+    TEST_F(VFSManagerTest, exists_should_normalize_name)
+    {
+        EXPECT_TRUE(mManager.exists("meshes/foo.nif"));
+        EXPECT_TRUE(mManager.exists("MESHES\\FOO.NIF"));
+        EXPECT_TRUE(mManager.exists("Textures/Bar.dds"));
+        EXPECT_FALSE(mManager.exists("meshes/foo.ni"));
+        EXPECT_FALSE(mManager.exists("meshes/foo.nif2"));
+        EXPECT_FALSE(mManager.exists(""));
+    }
+
+    TEST_F(VFSManagerTest, exists_normalized_should_not_normalize_name)
+    {
+        EXPECT_TRUE(mManager.existsNormalized("meshes/foo.nif"));
+        EXPECT_FALSE(mManager.existsNormalized("Meshes/foo.nif"));
+        EXPECT_FALSE(mManager.existsNormalized("meshes\\foo.nif"));
+    }
+
+    TEST_F(VFSManagerTest, get_should_return_file_from_last_added_archive)
+    {
+        EXPECT_EQ(read(mManager.get("Meshes\\Foo.nif")), "second");
+        EXPECT_EQ(read(mManager.getNormalized("textures/bar.dds")), "bar");
+    }
+
+    TEST_F(VFSManagerTest, get_should_throw_for_missing_file)
+    {
+        EXPECT_THROW(mManager.get("meshes/bar.nif"), std::runtime_error);
+        EXPECT_THROW(mManager.getNormalized("Textures/bar.dds"), std::runtime_error);
+    }
+
+    TEST_F(VFSManagerTest, reset_should_clear_index)
+    {
+        mManager.reset();
+        EXPECT_FALSE(mManager.exists("meshes/foo.nif"));
+        EXPECT_TRUE(mManager.getIndex().empty());
+    }
+}
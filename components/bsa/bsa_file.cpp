@@ -163,6 +163,7 @@ int BSAFile::getIndex(const char *str) const
 void BSAFile::open(const string &file)
 {
     mFilename = file;
+    mMappedFile = Files::mapFile(file);
     readHeader();
 }
 
@@ -175,10 +176,17 @@ Files::IStreamPtr BSAFile::getFile(const char *file)
 
     const FileStruct &fs = mFiles[i];
 
-    return Files::openConstrainedFileStream (mFilename.c_str (), fs.offset, fs.fileSize);
+    return openStream(fs.offset, fs.fileSize);
 }
 
 Files::IStreamPtr BSAFile::getFile(const FileStruct *file)
 {
-    return Files::openConstrainedFileStream (mFilename.c_str (), file->offset, file->fileSize);
+    return openStream(file->offset, file->fileSize);
+}
+
+Files::IStreamPtr BSAFile::openStream(size_t offset, size_t size) const
+{
+    if (mMappedFile)
+        return Files::openMappedFileStream(mMappedFile, offset, size);
+    return Files::openConstrainedFileStream(mFilename.c_str(), offset, size);
 }
@@ -32,6 +32,7 @@
 #include <components/misc/stringops.hpp>
 
 #include <components/files/constrainedfilestream.hpp>
+#include <components/files/mappedfile.hpp>
 
 
 namespace Bsa
@@ -69,6 +70,9 @@ protected:
     /// Used for error messages
     std::string mFilename;
 
+    /// Whole archive mapped into memory, nullptr when mapping failed
+    std::shared_ptr<const Files::MappedFile> mMappedFile;
+
     /// Case insensitive string comparison
     struct iltstr
     {
@@ -89,8 +93,9 @@ protected:
     /// Read header information from the input source
     virtual void readHeader();
 
-    /// Read header information from the input source
-
+    /// Open a stream over the given region of the archive
+    /// @note Thread safe.
+    Files::IStreamPtr openStream(size_t offset, size_t size) const;
 
     /// Get the index of a given file name, or -1 if not found
     /// @note Thread safe.
@@ -341,7 +341,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
     size_t size = fileRecord.getSizeWithoutCompressionFlag();
     size_t uncompressedSize = size;
     bool compressed = fileRecord.isCompressed(mCompressedByDefault);
-    Files::IStreamPtr streamPtr = Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, size);
+    Files::IStreamPtr streamPtr = openStream(fileRecord.offset, size);
     std::istream* fileStream = streamPtr.get();
     if (mEmbeddedFileNames)
     {
@@ -351,6 +351,9 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
         fileStream->ignore(length);
         size -= length + sizeof(char);
     }
+    // Uncompressed data can be read directly from the mapped archive
+    if (!compressed && mMappedFile)
+        return openStream(fileRecord.offset + (fileRecord.getSizeWithoutCompressionFlag() - size), size);
     if (compressed)
     {
         fileStream->read(reinterpret_cast<char*>(&uncompressedSize), sizeof(uint32_t));
@@ -442,7 +445,7 @@ void CompressedBSAFile::convertCompressedSizesToUncompressed()
             continue;
         }
 
-        Files::IStreamPtr dataBegin = Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
+        Files::IStreamPtr dataBegin = openStream(fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
 
         if (mEmbeddedFileNames)
         {
@@ -3,6 +3,8 @@
 #include <cassert>
 #include <stdexcept>
 
+#include <components/misc/hash.hpp>
+
 #include "generator.hpp"
 #include "literals.hpp"
 
@@ -207,4 +209,26 @@ namespace Compiler
         for (const auto & mKeyword : mKeywords)
             keywords.push_back (mKeyword.first);
     }
+
+    std::uint64_t Extensions::getHash() const
+    {
+        Misc::Fnv1aHash hash;
+
+        for (const auto& keyword : mKeywords)
+            hash.add (keyword.first).addValue ('\0').addValue (keyword.second);
+
+        for (const auto& function : mFunctions)
+            hash.addValue (function.first).addValue (function.second.mReturn)
+                .add (function.second.mArguments).addValue ('\0')
+                .addValue (function.second.mCode).addValue (function.second.mCodeExplicit)
+                .addValue (function.second.mSegment);
+
+        for (const auto& instruction : mInstructions)
+            hash.addValue (instruction.first)
+                .add (instruction.second.mArguments).addValue ('\0')
+                .addValue (instruction.second.mCode).addValue (instruction.second.mCodeExplicit)
+                .addValue (instruction.second.mSegment);
+
+        return hash.getValue();
+    }
 }
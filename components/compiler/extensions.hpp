@@ -1,6 +1,7 @@
 #ifndef COMPILER_EXTENSIONS_H_INCLUDED
 #define COMPILER_EXTENSIONS_H_INCLUDED
 
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
@@ -109,6 +110,10 @@ namespace Compiler
 
             void listKeywords (std::vector<std::string>& keywords) const;
             ///< Append all known keywords to \a kaywords.
+
+            std::uint64_t getHash() const;
+            ///< Return hash of all registered keywords with their arguments and opcodes. The value is stable
+            /// between runs, it changes only when the extensions change.
     };
 }
 
@@ -18,6 +18,9 @@ namespace
     {
         return std::abs(lhs.x() - rhs.x()) + std::abs(lhs.y() - rhs.y());
     }
+
+    // Path queries are repeated while actor is waiting for a path, so demand not followed by a job is dropped soon
+    constexpr std::chrono::seconds demandTimeout(1);
 }
 
 namespace DetourNavigator
@@ -56,6 +59,8 @@ namespace DetourNavigator
         , mShouldStop()
         , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
     {
+        if (mSettings.get().mEnableNavMeshDiskCache && !mSettings.get().mNavMeshDiskCachePath.empty())
+            mNavMeshTilesStorage = std::make_unique<NavMeshTilesStorage>(settings, settings.mNavMeshDiskCachePath);
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
             mThreads.emplace_back([&] { process(); });
     }
@@ -65,6 +70,7 @@ namespace DetourNavigator
         mShouldStop = true;
         std::unique_lock<std::mutex> lock(mMutex);
         mJobs = decltype(mJobs)();
+        mDelayedJobs = decltype(mDelayedJobs)();
         mHasJob.notify_all();
         lock.unlock();
         for (auto& thread : mThreads)
@@ -80,6 +86,8 @@ namespace DetourNavigator
         if (changedTiles.empty())
             return;
 
+        const auto now = std::chrono::steady_clock::now();
+
         const std::lock_guard<std::mutex> lock(mMutex);
 
         for (const auto& changedTile : changedTiles)
@@ -92,6 +100,7 @@ namespace DetourNavigator
                 job.mNavMeshCacheItem = navMeshCacheItem;
                 job.mChangedTile = changedTile.first;
                 job.mTryNumber = 0;
+                job.mDemanded = isDemandedUnsafe(agentHalfExtents, changedTile.first);
                 job.mChangeType = changedTile.second;
                 job.mDistanceToPlayer = getManhattanDistance(changedTile.first, playerTile);
                 job.mDistanceToOrigin = getManhattanDistance(changedTile.first, TilePosition {0, 0});
@@ -99,21 +108,56 @@ namespace DetourNavigator
                     ? mLastUpdates[job.mAgentHalfExtents][job.mChangedTile] + mSettings.get().mMinUpdateInterval
                     : std::chrono::steady_clock::time_point();
 
-                mJobs.push(std::move(job));
+                pushJobUnsafe(std::move(job), now);
             }
         }
 
-        Log(Debug::Debug) << "Posted " << mJobs.size() << " navigator jobs";
+        Log(Debug::Debug) << "Posted " << mJobs.size() + mDelayedJobs.size() << " navigator jobs";
 
-        if (!mJobs.empty())
+        if (!mJobs.empty() || !mDelayedJobs.empty())
             mHasJob.notify_all();
     }
 
+    void AsyncNavMeshUpdater::demand(const osg::Vec3f& agentHalfExtents, const std::vector<TilePosition>& tiles)
+    {
+        if (tiles.empty())
+            return;
+
+        const auto now = std::chrono::steady_clock::now();
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        auto& demandedTiles = mDemandedTiles[agentHalfExtents];
+        bool changed = false;
+
+        for (const auto& tile : tiles)
+        {
+            const auto inserted = demandedTiles.emplace(tile, now);
+            if (inserted.second)
+                changed = true;
+            else
+                inserted.first->second = now;
+        }
+
+        // Reordering is required only when there are pending jobs for newly demanded tiles.
+        // Delayed jobs get demanded flag when they are ready.
+        if (!changed)
+            return;
+
+        const auto updateDemanded = [&] (Job& job)
+        {
+            if (job.mAgentHalfExtents == agentHalfExtents)
+                job.mDemanded = demandedTiles.count(job.mChangedTile) > 0;
+        };
+
+        updateDemandedUnsafe(updateDemanded);
+    }
+
     void AsyncNavMeshUpdater::wait()
     {
         {
             std::unique_lock<std::mutex> lock(mMutex);
-            mDone.wait(lock, [&] { return mJobs.empty() && getTotalThreadJobsUnsafe() == 0; });
+            mDone.wait(lock, [&] { return mJobs.empty() && mDelayedJobs.empty() && getTotalThreadJobsUnsafe() == 0; });
         }
         mProcessingTiles.wait(mProcessed, [] (const auto& v) { return v.empty(); });
     }
@@ -124,7 +168,7 @@ namespace DetourNavigator
 
         {
             const std::lock_guard<std::mutex> lock(mMutex);
-            jobs = mJobs.size() + getTotalThreadJobsUnsafe();
+            jobs = mJobs.size() + mDelayedJobs.size() + getTotalThreadJobsUnsafe();
         }
 
         stats.setAttribute(frameNumber, "NavMesh UpdateJobs", jobs);
@@ -139,14 +183,7 @@ namespace DetourNavigator
         {
             try
             {
-                if (auto job = getNextJob())
-                {
-                    const auto processed = processJob(*job);
-                    unlockTile(job->mAgentHalfExtents, job->mChangedTile);
-                    if (!processed)
-                        repost(std::move(*job));
-                }
-                else
+                if (!processNextJob())
                     cleanupLastUpdates();
             }
             catch (const std::exception& e)
@@ -157,6 +194,19 @@ namespace DetourNavigator
         Log(Debug::Debug) << "Stop navigator jobs processing by thread=" << std::this_thread::get_id();
     }
 
+    std::optional<TilePosition> AsyncNavMeshUpdater::processNextJob()
+    {
+        auto job = getNextJob();
+        if (!job)
+            return std::nullopt;
+        const TilePosition changedTile = job->mChangedTile;
+        const auto processed = processJob(*job);
+        unlockTile(job->mAgentHalfExtents, changedTile);
+        if (!processed)
+            repost(std::move(*job));
+        return changedTile;
+    }
+
     bool AsyncNavMeshUpdater::processJob(const Job& job)
     {
         Log(Debug::Debug) << "Process job for agent=(" << std::fixed << std::setprecision(2) << job.mAgentHalfExtents << ")"
@@ -176,7 +226,7 @@ namespace DetourNavigator
         const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
 
         const auto status = updateNavMesh(job.mAgentHalfExtents, recastMesh.get(), job.mChangedTile, playerTile,
-            offMeshConnections, mSettings, navMeshCacheItem, mNavMeshTilesCache);
+            offMeshConnections, mSettings, navMeshCacheItem, mNavMeshTilesCache, mNavMeshTilesStorage.get());
 
         const auto finish = std::chrono::steady_clock::now();
 
@@ -208,18 +258,23 @@ namespace DetourNavigator
         while (true)
         {
             const auto hasJob = [&] {
-                return (!mJobs.empty() && mJobs.top().mProcessTime <= std::chrono::steady_clock::now())
-                    || !threadQueue.mJobs.empty();
+                return !mJobs.empty() || !threadQueue.mJobs.empty()
+                    || (!mDelayedJobs.empty() && mDelayedJobs.top().mProcessTime <= std::chrono::steady_clock::now());
             };
 
             if (!mHasJob.wait_for(lock, std::chrono::milliseconds(10), hasJob))
             {
                 mFirstStart.lock()->reset();
-                if (mJobs.empty() && getTotalThreadJobsUnsafe() == 0)
+                if (mJobs.empty() && mDelayedJobs.empty() && getTotalThreadJobsUnsafe() == 0)
                     mDone.notify_all();
                 return std::nullopt;
             }
 
+            const auto now = std::chrono::steady_clock::now();
+
+            expireDemandsUnsafe(now);
+            moveReadyJobsUnsafe(now);
+
             Log(Debug::Debug) << "Got " << mJobs.size() << " navigator jobs and "
                 << threadQueue.mJobs.size() << " thread jobs by thread=" << std::this_thread::get_id();
 
@@ -241,17 +296,24 @@ namespace DetourNavigator
 
     std::optional<AsyncNavMeshUpdater::Job> AsyncNavMeshUpdater::getJob(Jobs& jobs, Pushed& pushed, bool changeLastUpdate)
     {
-        const auto now = std::chrono::steady_clock::now();
-
-        if (jobs.top().mProcessTime > now)
+        if (jobs.empty())
             return {};
 
+        const auto now = std::chrono::steady_clock::now();
+
         Job job = std::move(jobs.top());
         jobs.pop();
 
         if (changeLastUpdate && job.mChangeType == ChangeType::update)
             mLastUpdates[job.mAgentHalfExtents][job.mChangedTile] = now;
 
+        if (job.mDemanded)
+        {
+            const auto demanded = mDemandedTiles.find(job.mAgentHalfExtents);
+            if (demanded != mDemandedTiles.end())
+                demanded->second.erase(job.mChangedTile);
+        }
+
         const auto it = pushed.find(job.mAgentHalfExtents);
         it->second.erase(job.mChangedTile);
         if (it->second.empty())
@@ -301,7 +363,7 @@ namespace DetourNavigator
         if (mPushed[job.mAgentHalfExtents].insert(job.mChangedTile).second)
         {
             ++job.mTryNumber;
-            mJobs.push(std::move(job));
+            pushJobUnsafe(std::move(job), std::chrono::steady_clock::now());
             mHasJob.notify_all();
         }
     }
@@ -315,6 +377,25 @@ namespace DetourNavigator
         }
     }
 
+    void AsyncNavMeshUpdater::pushJobUnsafe(Job&& job, const std::chrono::steady_clock::time_point& now)
+    {
+        if (job.mProcessTime > now)
+            mDelayedJobs.push(std::move(job));
+        else
+            mJobs.push(std::move(job));
+    }
+
+    void AsyncNavMeshUpdater::moveReadyJobsUnsafe(const std::chrono::steady_clock::time_point& now)
+    {
+        while (!mDelayedJobs.empty() && mDelayedJobs.top().mProcessTime <= now)
+        {
+            Job job = std::move(mDelayedJobs.top());
+            mDelayedJobs.pop();
+            job.mDemanded = isDemandedUnsafe(job.mAgentHalfExtents, job.mChangedTile);
+            mJobs.push(std::move(job));
+        }
+    }
+
     std::thread::id AsyncNavMeshUpdater::lockTile(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile)
     {
         if (mSettings.get().mAsyncNavMeshUpdaterThreads <= 1)
@@ -371,6 +452,12 @@ namespace DetourNavigator
             [] (auto r, const auto& v) { return r + v.second.mJobs.size(); });
     }
 
+    bool AsyncNavMeshUpdater::isDemandedUnsafe(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile) const
+    {
+        const auto demanded = mDemandedTiles.find(agentHalfExtents);
+        return demanded != mDemandedTiles.end() && demanded->second.count(changedTile) > 0;
+    }
+
     void AsyncNavMeshUpdater::cleanupLastUpdates()
     {
         const auto now = std::chrono::steady_clock::now();
@@ -392,5 +479,41 @@ namespace DetourNavigator
             else
                 ++agent;
         }
+
+        expireDemandsUnsafe(now);
+    }
+
+    void AsyncNavMeshUpdater::expireDemandsUnsafe(const std::chrono::steady_clock::time_point& now)
+    {
+        bool expired = false;
+
+        for (auto agent = mDemandedTiles.begin(); agent != mDemandedTiles.end();)
+        {
+            for (auto tile = agent->second.begin(); tile != agent->second.end();)
+            {
+                if (now - tile->second > demandTimeout)
+                {
+                    tile = agent->second.erase(tile);
+                    expired = true;
+                }
+                else
+                    ++tile;
+            }
+
+            if (agent->second.empty())
+                agent = mDemandedTiles.erase(agent);
+            else
+                ++agent;
+        }
+
+        if (!expired)
+            return;
+
+        // Jobs for tiles nobody waits for anymore should not be processed before older ones
+        updateDemandedUnsafe([&] (Job& job)
+        {
+            if (job.mDemanded)
+                job.mDemanded = isDemandedUnsafe(job.mAgentHalfExtents, job.mChangedTile);
+        });
     }
 }
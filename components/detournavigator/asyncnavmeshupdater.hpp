@@ -6,17 +6,21 @@
 #include "tilecachedrecastmeshmanager.hpp"
 #include "tileposition.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshtilesstorage.hpp"
 
 #include <osg/Vec3f>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <set>
 #include <thread>
+#include <vector>
 
 class dtNavMesh;
 
@@ -55,8 +59,16 @@ namespace DetourNavigator
         void post(const osg::Vec3f& agentHalfExtents, const SharedNavMeshCacheItem& mNavMeshCacheItem,
             const TilePosition& playerTile, const std::map<TilePosition, ChangeType>& changedTiles);
 
+        /// Process pending jobs for given tiles before other jobs which process time has come.
+        /// Tiles stay demanded until they are processed or for a short time if there are no jobs for them.
+        void demand(const osg::Vec3f& agentHalfExtents, const std::vector<TilePosition>& tiles);
+
         void wait();
 
+        /// Process the next job by the calling thread. Worker threads do this in a loop.
+        /// @return changed tile of the processed job or nullopt if there was no job to process
+        std::optional<TilePosition> processNextJob();
+
         void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
 
     private:
@@ -66,14 +78,15 @@ namespace DetourNavigator
             std::weak_ptr<GuardedNavMeshCacheItem> mNavMeshCacheItem;
             TilePosition mChangedTile;
             unsigned mTryNumber;
+            bool mDemanded;
             ChangeType mChangeType;
             int mDistanceToPlayer;
             int mDistanceToOrigin;
             std::chrono::steady_clock::time_point mProcessTime;
 
-            std::tuple<std::chrono::steady_clock::time_point, unsigned, ChangeType, int, int> getPriority() const
+            std::tuple<bool, unsigned, ChangeType, int, int> getPriority() const
             {
-                return std::make_tuple(mProcessTime, mTryNumber, mChangeType, mDistanceToPlayer, mDistanceToOrigin);
+                return std::make_tuple(!mDemanded, mTryNumber, mChangeType, mDistanceToPlayer, mDistanceToOrigin);
             }
 
             friend inline bool operator <(const Job& lhs, const Job& rhs)
@@ -82,7 +95,29 @@ namespace DetourNavigator
             }
         };
 
-        using Jobs = std::priority_queue<Job, std::deque<Job>>;
+        struct LaterProcessTime
+        {
+            bool operator()(const Job& lhs, const Job& rhs) const
+            {
+                return lhs.mProcessTime > rhs.mProcessTime;
+            }
+        };
+
+        /// Jobs which process time has not come yet, they are moved to the ready jobs in order of the process time
+        using DelayedJobs = std::priority_queue<Job, std::deque<Job>, LaterProcessTime>;
+
+        struct Jobs : std::priority_queue<Job, std::deque<Job>>
+        {
+            /// Apply function to each job and restore the order
+            template <class Function>
+            void update(Function&& function)
+            {
+                for (auto& job : c)
+                    function(job);
+                std::make_heap(c.begin(), c.end(), comp);
+            }
+        };
+
         using Pushed = std::map<osg::Vec3f, std::set<TilePosition>>;
 
         struct Queue
@@ -102,12 +137,15 @@ namespace DetourNavigator
         std::condition_variable mDone;
         std::condition_variable mProcessed;
         Jobs mJobs;
+        DelayedJobs mDelayedJobs;
         std::map<osg::Vec3f, std::set<TilePosition>> mPushed;
         Misc::ScopeGuarded<TilePosition> mPlayerTile;
         Misc::ScopeGuarded<std::optional<std::chrono::steady_clock::time_point>> mFirstStart;
         NavMeshTilesCache mNavMeshTilesCache;
+        std::unique_ptr<NavMeshTilesStorage> mNavMeshTilesStorage;
         Misc::ScopeGuarded<std::map<osg::Vec3f, std::map<TilePosition, std::thread::id>>> mProcessingTiles;
         std::map<osg::Vec3f, std::map<TilePosition, std::chrono::steady_clock::time_point>> mLastUpdates;
+        std::map<osg::Vec3f, std::map<TilePosition, std::chrono::steady_clock::time_point>> mDemandedTiles;
         std::map<std::thread::id, Queue> mThreadsQueues;
         std::vector<std::thread> mThreads;
 
@@ -121,6 +159,10 @@ namespace DetourNavigator
 
         void postThreadJob(Job&& job, Queue& queue);
 
+        void pushJobUnsafe(Job&& job, const std::chrono::steady_clock::time_point& now);
+
+        void moveReadyJobsUnsafe(const std::chrono::steady_clock::time_point& now);
+
         void writeDebugFiles(const Job& job, const RecastMesh* recastMesh) const;
 
         std::chrono::steady_clock::time_point setFirstStart(const std::chrono::steady_clock::time_point& value);
@@ -133,7 +175,20 @@ namespace DetourNavigator
 
         inline std::size_t getTotalThreadJobsUnsafe() const;
 
+        bool isDemandedUnsafe(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile) const;
+
         void cleanupLastUpdates();
+
+        /// Drop demands which are not renewed for a while
+        void expireDemandsUnsafe(const std::chrono::steady_clock::time_point& now);
+
+        template <class Function>
+        void updateDemandedUnsafe(Function&& function)
+        {
+            mJobs.update(function);
+            for (auto& queue : mThreadsQueues)
+                queue.second.mJobs.update(function);
+        }
     };
 }
 
@@ -0,0 +1,156 @@
+#include "asyncpathfinder.hpp"
+#include "findsmoothpath.hpp"
+#include "settingsutils.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        PathQueryResult findPath(const dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh,
+            const PathQuery& query, const Settings& settings)
+        {
+            PathQueryResult result;
+            auto out = std::back_inserter(result.mPath);
+            result.mStatus = findSmoothPath(navMeshQuery, navMesh,
+                toNavMeshCoordinates(settings, query.mAgentHalfExtents),
+                toNavMeshCoordinates(settings, query.mStepSize), toNavMeshCoordinates(settings, query.mStart),
+                toNavMeshCoordinates(settings, query.mEnd), query.mIncludeFlags, query.mAreaCosts, settings, out);
+            return result;
+        }
+
+        bool isCancelled(const SharedPendingPathQuery& query)
+        {
+            return query.use_count() == 1;
+        }
+    }
+
+    SharedPendingPathQuery makeReadyPathQuery(const PathQuery& query, Status status)
+    {
+        auto result = std::make_shared<PendingPathQuery>(query);
+        PathQueryResult queryResult;
+        queryResult.mStatus = status;
+        result->setResult(std::move(queryResult));
+        return result;
+    }
+
+    AsyncPathFinder::AsyncPathFinder(const Settings& settings, std::size_t threadsNumber)
+        : mSettings(settings)
+        , mShouldStop(false)
+        , mProcessing(0)
+    {
+        for (std::size_t i = 0; i < threadsNumber; ++i)
+            mThreads.emplace_back([&] { process(); });
+    }
+
+    AsyncPathFinder::~AsyncPathFinder()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mShouldStop = true;
+        mJobs.clear();
+        mHasJob.notify_all();
+        lock.unlock();
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    SharedPendingPathQuery AsyncPathFinder::submit(const SharedNavMeshCacheItem& navMeshCacheItem,
+        const PathQuery& query)
+    {
+        auto pendingQuery = std::make_shared<PendingPathQuery>(query);
+
+        if (mThreads.empty())
+        {
+            const auto locked = navMeshCacheItem->lockConst();
+            const dtNavMesh& navMesh = locked->getImpl();
+            dtNavMeshQuery* const navMeshQuery = getNavMeshQuery(navMesh, mSettings.get().mMaxNavMeshQueryNodes);
+            if (navMeshQuery == nullptr)
+                return makeReadyPathQuery(query, Status::InitNavMeshQueryFailed);
+            pendingQuery->setResult(findPath(*navMeshQuery, navMesh, query, mSettings));
+            return pendingQuery;
+        }
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(Job {navMeshCacheItem, pendingQuery});
+        mHasJob.notify_one();
+
+        return pendingQuery;
+    }
+
+    void AsyncPathFinder::wait()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [&] { return mJobs.empty() && mProcessing == 0; });
+    }
+
+    std::size_t AsyncPathFinder::getPendingQueriesCount() const
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        return mJobs.size() + mProcessing;
+    }
+
+    void AsyncPathFinder::process() noexcept
+    {
+        Log(Debug::Debug) << "Start process path queries by thread=" << std::this_thread::get_id();
+        dtNavMeshQuery navMeshQuery;
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasJob.wait(lock, [&] { return mShouldStop || !mJobs.empty(); });
+            if (mShouldStop)
+                break;
+            const std::vector<Job> batch = getNextBatch();
+            mProcessing += batch.size();
+            lock.unlock();
+            try
+            {
+                processBatch(navMeshQuery, batch);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "AsyncPathFinder::process exception: " << e.what();
+                for (const Job& job : batch)
+                    if (job.mQuery->poll() == nullptr)
+                        job.mQuery->setResult(PathQueryResult {Status::FindPathOverPolygonsFailed, {}});
+            }
+            lock.lock();
+            mProcessing -= batch.size();
+            if (mJobs.empty() && mProcessing == 0)
+                mDone.notify_all();
+        }
+        Log(Debug::Debug) << "Stop path queries processing by thread=" << std::this_thread::get_id();
+    }
+
+    std::vector<AsyncPathFinder::Job> AsyncPathFinder::getNextBatch()
+    {
+        std::vector<Job> result;
+        const SharedNavMeshCacheItem navMeshCacheItem = mJobs.front().mNavMeshCacheItem;
+        const auto end = std::stable_partition(mJobs.begin(), mJobs.end(),
+            [&] (const Job& job) { return job.mNavMeshCacheItem != navMeshCacheItem; });
+        std::move(end, mJobs.end(), std::back_inserter(result));
+        mJobs.erase(end, mJobs.end());
+        return result;
+    }
+
+    void AsyncPathFinder::processBatch(dtNavMeshQuery& navMeshQuery, const std::vector<Job>& batch) const
+    {
+        const auto locked = batch.front().mNavMeshCacheItem->lockConst();
+        const dtNavMesh& navMesh = locked->getImpl();
+        const bool initialized = initNavMeshQuery(navMeshQuery, navMesh, mSettings.get().mMaxNavMeshQueryNodes);
+        for (const Job& job : batch)
+        {
+            if (isCancelled(job.mQuery))
+                continue;
+            if (!initialized)
+            {
+                job.mQuery->setResult(PathQueryResult {Status::InitNavMeshQueryFailed, {}});
+                continue;
+            }
+            job.mQuery->setResult(findPath(navMeshQuery, navMesh, job.mQuery->getQuery(), mSettings));
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+
+#include "areatype.hpp"
+#include "flags.hpp"
+#include "navmeshcacheitem.hpp"
+#include "settings.hpp"
+#include "status.hpp"
+
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class dtNavMeshQuery;
+
+namespace DetourNavigator
+{
+    struct PathQuery
+    {
+        osg::Vec3f mAgentHalfExtents;
+        float mStepSize = 0;
+        osg::Vec3f mStart;
+        osg::Vec3f mEnd;
+        Flags mIncludeFlags = Flag_none;
+        AreaCosts mAreaCosts;
+    };
+
+    struct PathQueryResult
+    {
+        Status mStatus = Status::Success;
+        std::vector<osg::Vec3f> mPath;
+    };
+
+    /// Shared state of submitted path query. Query is cancelled when all owners except AsyncPathFinder release it.
+    class PendingPathQuery
+    {
+    public:
+        explicit PendingPathQuery(const PathQuery& query)
+            : mQuery(query), mReady(false)
+        {}
+
+        /// @return result when query is processed or nullptr if it is still pending.
+        const PathQueryResult* poll() const
+        {
+            return mReady.load(std::memory_order_acquire) ? &mResult : nullptr;
+        }
+
+        const PathQuery& getQuery() const
+        {
+            return mQuery;
+        }
+
+        void setResult(PathQueryResult&& result)
+        {
+            mResult = std::move(result);
+            mReady.store(true, std::memory_order_release);
+        }
+
+    private:
+        PathQuery mQuery;
+        PathQueryResult mResult;
+        std::atomic_bool mReady;
+    };
+
+    using SharedPendingPathQuery = std::shared_ptr<PendingPathQuery>;
+
+    SharedPendingPathQuery makeReadyPathQuery(const PathQuery& query, Status status);
+
+    /// Finds paths in background threads. Each thread owns dtNavMeshQuery and takes all queued queries for the same
+    /// navmesh to process them under a single navmesh lock. With zero threads queries are processed by submit.
+    class AsyncPathFinder
+    {
+    public:
+        AsyncPathFinder(const Settings& settings, std::size_t threadsNumber);
+        ~AsyncPathFinder();
+
+        SharedPendingPathQuery submit(const SharedNavMeshCacheItem& navMeshCacheItem, const PathQuery& query);
+
+        void wait();
+
+        std::size_t getPendingQueriesCount() const;
+
+    private:
+        struct Job
+        {
+            SharedNavMeshCacheItem mNavMeshCacheItem;
+            SharedPendingPathQuery mQuery;
+        };
+
+        std::reference_wrapper<const Settings> mSettings;
+        bool mShouldStop;
+        mutable std::mutex mMutex;
+        std::condition_variable mHasJob;
+        std::condition_variable mDone;
+        std::deque<Job> mJobs;
+        std::size_t mProcessing;
+        std::vector<std::thread> mThreads;
+
+        void process() noexcept;
+
+        std::vector<Job> getNextBatch();
+
+        void processBatch(dtNavMeshQuery& navMeshQuery, const std::vector<Job>& batch) const;
+    };
+}
+
+#endif
@@ -103,6 +103,18 @@ namespace DetourNavigator
         return dtStatusSucceed(status);
     }
 
+    /// @brief Returns query initialized for given navmesh or nullptr on failure.
+    /// Query is reused by all calls from the same thread, dtNavMeshQuery::init allocates node pool and open list only
+    /// when they don't have enough capacity and clears them otherwise. Result is valid until the next call.
+    /// This only removes per query allocations, queries are still executed by the caller one at a time.
+    inline dtNavMeshQuery* getNavMeshQuery(const dtNavMesh& navMesh, const int maxNodes)
+    {
+        thread_local dtNavMeshQuery navMeshQuery;
+        if (!initNavMeshQuery(navMeshQuery, navMesh, maxNodes))
+            return nullptr;
+        return &navMeshQuery;
+    }
+
     struct MoveAlongSurfaceResult
     {
         osg::Vec3f mResultPos;
@@ -266,15 +278,12 @@ namespace DetourNavigator
         return Status::Success;
     }
 
+    /// @param navMeshQuery must be initialized for navMesh, see initNavMeshQuery.
     template <class OutputIterator>
-    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
-            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
-            const Settings& settings, OutputIterator& out)
+    Status findSmoothPath(const dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh, const osg::Vec3f& halfExtents,
+            const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts, const Settings& settings, OutputIterator& out)
     {
-        dtNavMeshQuery navMeshQuery;
-        if (!initNavMeshQuery(navMeshQuery, navMesh, settings.mMaxNavMeshQueryNodes))
-            return Status::InitNavMeshQueryFailed;
-
         dtQueryFilter queryFilter;
         queryFilter.setIncludeFlags(includeFlags);
         queryFilter.setAreaCost(AreaType_water, areaCosts.mWater);
@@ -321,6 +330,18 @@ namespace DetourNavigator
         return makeSmoothPath(navMesh, navMeshQuery, queryFilter, start, end, stepSize, std::move(*polygonPath),
             settings.mMaxSmoothPathSize, outTransform);
     }
+
+    template <class OutputIterator>
+    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
+            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
+            const Settings& settings, OutputIterator& out)
+    {
+        dtNavMeshQuery* const navMeshQuery = getNavMeshQuery(navMesh, settings.mMaxNavMeshQueryNodes);
+        if (navMeshQuery == nullptr)
+            return Status::InitNavMeshQueryFailed;
+        return findSmoothPath(*navMeshQuery, navMesh, halfExtents, stepSize, start, end, includeFlags, areaCosts,
+            settings, out);
+    }
 }
 
 #endif
@@ -9,6 +9,7 @@
 #include "sharednavmesh.hpp"
 #include "flags.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshtilesstorage.hpp"
 
 #include <components/misc/convert.hpp>
 
@@ -517,7 +518,8 @@ namespace DetourNavigator
     UpdateNavMeshStatus updateNavMesh(const osg::Vec3f& agentHalfExtents, const RecastMesh* recastMesh,
         const TilePosition& changedTile, const TilePosition& playerTile,
         const std::vector<OffMeshConnection>& offMeshConnections, const Settings& settings,
-        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache)
+        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache,
+        const NavMeshTilesStorage* navMeshTilesStorage)
     {
         Log(Debug::Debug) << std::fixed << std::setprecision(2) <<
             "Update NavMesh with multiple tiles:" <<
@@ -563,23 +565,42 @@ namespace DetourNavigator
 
         if (!cachedNavMeshData)
         {
-            const auto tileBounds = makeTileBounds(settings, changedTile);
-            const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
-            const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+            auto navMeshKey = makeNavMeshKey(*recastMesh, offMeshConnections);
+            NavMeshData navMeshData;
 
-            auto navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
-                tileBorderMin, tileBorderMax, settings);
+            std::vector<unsigned char> persistentNavMeshKey;
+
+            if (navMeshTilesStorage)
+            {
+                persistentNavMeshKey = makePersistentNavMeshKey(*recastMesh, offMeshConnections);
+                navMeshData = navMeshTilesStorage->load(agentHalfExtents, changedTile, persistentNavMeshKey);
+                cached = static_cast<bool>(navMeshData.mValue);
+            }
 
             if (!navMeshData.mValue)
             {
-                Log(Debug::Debug) << "Ignore add tile: NavMeshData is null";
-                return navMeshCacheItem->lock()->removeTile(changedTile);
+                const auto tileBounds = makeTileBounds(settings, changedTile);
+                const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
+                const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+
+                navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
+                    tileBorderMin, tileBorderMax, settings);
+
+                if (!navMeshData.mValue)
+                {
+                    Log(Debug::Debug) << "Ignore add tile: NavMeshData is null";
+                    return navMeshCacheItem->lock()->removeTile(changedTile);
+                }
+
+                if (navMeshTilesStorage)
+                    navMeshTilesStorage->save(agentHalfExtents, changedTile, persistentNavMeshKey,
+                        NavMeshDataRef {navMeshData.mValue.get(), navMeshData.mSize});
             }
 
             try
             {
-                cachedNavMeshData = navMeshTilesCache.set(agentHalfExtents, changedTile, *recastMesh,
-                                                          offMeshConnections, std::move(navMeshData));
+                cachedNavMeshData = navMeshTilesCache.set(agentHalfExtents, changedTile, std::move(navMeshKey),
+                                                          std::move(navMeshData));
             }
             catch (const InvalidArgument&)
             {
@@ -1,6 +1,7 @@
 ﻿#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVIGATOR_H
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVIGATOR_H
 
+#include "asyncpathfinder.hpp"
 #include "findsmoothpath.hpp"
 #include "flags.hpp"
 #include "settings.hpp"
@@ -165,8 +166,18 @@ namespace DetourNavigator
          */
         virtual void wait() = 0;
 
+        /**
+         * @brief demandPath makes pending updates of tiles between start and end to be processed first.
+         * Should be called for path queries that depend on the navmesh around them, e.g. before findPath for actor.
+         * @param agentHalfExtents allows to find navmesh for given actor.
+         * @param start path from given point.
+         * @param end path at given point.
+         */
+        virtual void demandPath(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end) = 0;
+
         /**
          * @brief findPath fills output iterator with points of scene surfaces to be used for actor to walk through.
+         * Path is found by the calling thread, use submitPathQuery to find it in background.
          * @param agentHalfExtents allows to find navmesh for given actor.
          * @param start path from given point.
          * @param end path at given point.
@@ -196,6 +207,14 @@ namespace DetourNavigator
                 toNavMeshCoordinates(settings, end), includeFlags, areaCosts, settings, out);
         }
 
+        /**
+         * @brief submitPathQuery starts to find path in background threads.
+         * @param query defines agent, path ends, allowed surfaces and area costs same way as for findPath.
+         * @return pending query to poll for result. Query is cancelled when it is released before it is processed.
+         * Result has NavMeshNotFound status right away if there is no navmesh for given agent.
+         */
+        virtual SharedPendingPathQuery submitPathQuery(const PathQuery& query) = 0;
+
         /**
          * @brief getNavMesh returns navmesh for specific agent half extents
          * @return navmesh
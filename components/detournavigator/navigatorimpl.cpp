@@ -12,6 +12,7 @@ namespace DetourNavigator
     NavigatorImpl::NavigatorImpl(const Settings& settings)
         : mSettings(settings)
         , mNavMeshManager(mSettings)
+        , mAsyncPathFinder(mSettings, mSettings.mAsyncPathFinderThreads)
         , mUpdatesEnabled(true)
     {
     }
@@ -156,6 +157,21 @@ namespace DetourNavigator
         mNavMeshManager.wait();
     }
 
+    void NavigatorImpl::demandPath(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end)
+    {
+        if (!mUpdatesEnabled)
+            return;
+        mNavMeshManager.demandPath(agentHalfExtents, start, end);
+    }
+
+    SharedPendingPathQuery NavigatorImpl::submitPathQuery(const PathQuery& query)
+    {
+        const auto navMesh = mNavMeshManager.getNavMesh(query.mAgentHalfExtents);
+        if (!navMesh)
+            return makeReadyPathQuery(query, Status::NavMeshNotFound);
+        return mAsyncPathFinder.submit(navMesh, query);
+    }
+
     SharedNavMeshCacheItem NavigatorImpl::getNavMesh(const osg::Vec3f& agentHalfExtents) const
     {
         return mNavMeshManager.getNavMesh(agentHalfExtents);
@@ -70,6 +70,14 @@ namespace DetourNavigator
 
         void wait() override {}
 
+        void demandPath(const osg::Vec3f& /*agentHalfExtents*/, const osg::Vec3f& /*start*/,
+            const osg::Vec3f& /*end*/) override {}
+
+        SharedPendingPathQuery submitPathQuery(const PathQuery& query) override
+        {
+            return makeReadyPathQuery(query, Status::NavMeshNotFound);
+        }
+
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& /*agentHalfExtents*/) const override
         {
             return mEmptyNavMeshCacheItem;
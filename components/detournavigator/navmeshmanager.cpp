@@ -193,6 +193,28 @@ namespace DetourNavigator
         mAsyncNavMeshUpdater.wait();
     }
 
+    void NavMeshManager::demandPath(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end)
+    {
+        const auto navMeshStart = toNavMeshCoordinates(mSettings, start);
+        const auto navMeshEnd = toNavMeshCoordinates(mSettings, end);
+        const auto startTile = getTilePosition(mSettings, navMeshStart);
+        const auto endTile = getTilePosition(mSettings, navMeshEnd);
+        const auto distance = std::max(std::abs(endTile.x() - startTile.x()), std::abs(endTile.y() - startTile.y()));
+        // Path can't go through more tiles than navmesh has
+        const auto steps = std::min(2 * distance, mSettings.mMaxTilesNumber);
+        std::vector<TilePosition> tiles;
+        tiles.push_back(startTile);
+        for (int i = 1; i <= steps; ++i)
+        {
+            const auto tile = getTilePosition(mSettings, navMeshStart + (navMeshEnd - navMeshStart) * (float(i) / steps));
+            if (tile != tiles.back())
+                tiles.push_back(tile);
+        }
+        if (tiles.back() != endTile)
+            tiles.push_back(endTile);
+        mAsyncNavMeshUpdater.demand(agentHalfExtents, tiles);
+    }
+
     SharedNavMeshCacheItem NavMeshManager::getNavMesh(const osg::Vec3f& agentHalfExtents) const
     {
         return getCached(agentHalfExtents);
@@ -47,6 +47,8 @@ namespace DetourNavigator
 
         void wait();
 
+        void demandPath(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end);
+
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& agentHalfExtents) const;
 
         std::map<osg::Vec3f, SharedNavMeshCacheItem> getNavMeshes() const;
@@ -7,36 +7,33 @@
 
 namespace DetourNavigator
 {
-    namespace
+    std::vector<unsigned char> makeNavMeshKey(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections)
     {
-        inline std::vector<unsigned char> makeNavMeshKey(const RecastMesh& recastMesh,
-            const std::vector<OffMeshConnection>& offMeshConnections)
-        {
-            const std::size_t indicesSize = recastMesh.getIndices().size() * sizeof(int);
-            const std::size_t verticesSize = recastMesh.getVertices().size() * sizeof(float);
-            const std::size_t areaTypesSize = recastMesh.getAreaTypes().size() * sizeof(AreaType);
-            const std::size_t waterSize = recastMesh.getWater().size() * sizeof(RecastMesh::Water);
-            const std::size_t offMeshConnectionsSize = offMeshConnections.size() * sizeof(OffMeshConnection);
+        const std::size_t indicesSize = recastMesh.getIndices().size() * sizeof(int);
+        const std::size_t verticesSize = recastMesh.getVertices().size() * sizeof(float);
+        const std::size_t areaTypesSize = recastMesh.getAreaTypes().size() * sizeof(AreaType);
+        const std::size_t waterSize = recastMesh.getWater().size() * sizeof(RecastMesh::Water);
+        const std::size_t offMeshConnectionsSize = offMeshConnections.size() * sizeof(OffMeshConnection);
 
-            std::vector<unsigned char> result(indicesSize + verticesSize + areaTypesSize + waterSize + offMeshConnectionsSize);
-            unsigned char* dst = result.data();
+        std::vector<unsigned char> result(indicesSize + verticesSize + areaTypesSize + waterSize + offMeshConnectionsSize);
+        unsigned char* dst = result.data();
 
-            std::memcpy(dst, recastMesh.getIndices().data(), indicesSize);
-            dst += indicesSize;
+        std::memcpy(dst, recastMesh.getIndices().data(), indicesSize);
+        dst += indicesSize;
 
-            std::memcpy(dst, recastMesh.getVertices().data(), verticesSize);
-            dst += verticesSize;
+        std::memcpy(dst, recastMesh.getVertices().data(), verticesSize);
+        dst += verticesSize;
 
-            std::memcpy(dst, recastMesh.getAreaTypes().data(), areaTypesSize);
-            dst += areaTypesSize;
+        std::memcpy(dst, recastMesh.getAreaTypes().data(), areaTypesSize);
+        dst += areaTypesSize;
 
-            std::memcpy(dst, recastMesh.getWater().data(), waterSize);
-            dst += waterSize;
+        std::memcpy(dst, recastMesh.getWater().data(), waterSize);
+        dst += waterSize;
 
-            std::memcpy(dst, offMeshConnections.data(), offMeshConnectionsSize);
+        std::memcpy(dst, offMeshConnections.data(), offMeshConnectionsSize);
 
-            return result;
-        }
+        return result;
     }
 
     NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
@@ -67,6 +64,12 @@ namespace DetourNavigator
     NavMeshTilesCache::Value NavMeshTilesCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
         const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
         NavMeshData&& value)
+    {
+        return set(agentHalfExtents, changedTile, makeNavMeshKey(recastMesh, offMeshConnections), std::move(value));
+    }
+
+    NavMeshTilesCache::Value NavMeshTilesCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        std::vector<unsigned char>&& navMeshKey, NavMeshData&& value)
     {
         const auto navMeshSize = static_cast<std::size_t>(value.mSize);
 
@@ -78,7 +81,6 @@ namespace DetourNavigator
         if (navMeshSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
 
-        auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
         const auto itemSize = navMeshSize + 2 * navMeshKey.size();
 
         if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
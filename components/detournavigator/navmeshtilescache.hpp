@@ -27,6 +27,9 @@ namespace DetourNavigator
         int mSize;
     };
 
+    std::vector<unsigned char> makeNavMeshKey(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections);
+
     class NavMeshTilesCache
     {
     public:
@@ -112,6 +115,10 @@ namespace DetourNavigator
             const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
             NavMeshData&& value);
 
+        /// @param navMeshKey result of makeNavMeshKey for the recast mesh and off mesh connections of the tile
+        Value set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            std::vector<unsigned char>&& navMeshKey, NavMeshData&& value);
+
         void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
 
     private:
@@ -0,0 +1,241 @@
+#include "navmeshtilesstorage.hpp"
+#include "recastmesh.hpp"
+#include "settings.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/cachefile.hpp>
+#include <components/misc/hash.hpp>
+
+#include <DetourAlloc.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr std::uint32_t navMeshTileMagic = 'O' << 24 | 'N' << 16 | 'M' << 8 | 'T'; //'ONMT';
+    constexpr std::uint32_t navMeshTileVersion = 3;
+
+    // Remove more than required when the limit is exceeded to not scan the storage on each new tile
+    constexpr double trimFactor = 0.75;
+
+    std::uint64_t getSettingsHash(const Settings& settings)
+    {
+        return Misc::Fnv1aHash()
+            .addValue(navMeshTileVersion)
+            .addValue(settings.mCellHeight)
+            .addValue(settings.mCellSize)
+            .addValue(settings.mDetailSampleDist)
+            .addValue(settings.mDetailSampleMaxError)
+            .addValue(settings.mMaxClimb)
+            .addValue(settings.mMaxSimplificationError)
+            .addValue(settings.mMaxSlope)
+            .addValue(settings.mRecastScaleFactor)
+            .addValue(settings.mSwimHeightScale)
+            .addValue(settings.mBorderSize)
+            .addValue(settings.mMaxEdgeLen)
+            .addValue(settings.mMaxPolys)
+            .addValue(settings.mMaxVertsPerPoly)
+            .addValue(settings.mRegionMergeSize)
+            .addValue(settings.mRegionMinSize)
+            .addValue(settings.mTileSize)
+            .getValue();
+    }
+
+    // Key values are written in little endian order independent of the platform
+    void writeKeyValue(std::vector<unsigned char>& key, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            key.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, std::uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            key.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, std::int32_t value)
+    {
+        writeKeyValue(key, static_cast<std::uint32_t>(value));
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeKeyValue(key, bits);
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeKeyValue(key, bits);
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, AreaType value)
+    {
+        key.push_back(static_cast<unsigned char>(value));
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, const osg::Vec3f& value)
+    {
+        writeKeyValue(key, value.x());
+        writeKeyValue(key, value.y());
+        writeKeyValue(key, value.z());
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, const btVector3& value)
+    {
+        // btScalar may be float or double depending on the Bullet build
+        writeKeyValue(key, static_cast<double>(value.x()));
+        writeKeyValue(key, static_cast<double>(value.y()));
+        writeKeyValue(key, static_cast<double>(value.z()));
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, const RecastMesh::Water& value)
+    {
+        writeKeyValue(key, static_cast<std::int32_t>(value.mCellSize));
+        for (int i = 0; i < 3; ++i)
+            writeKeyValue(key, value.mTransform.getBasis()[i]);
+        // Origin includes the water level
+        writeKeyValue(key, value.mTransform.getOrigin());
+    }
+
+    void writeKeyValue(std::vector<unsigned char>& key, const OffMeshConnection& value)
+    {
+        writeKeyValue(key, value.mStart);
+        writeKeyValue(key, value.mEnd);
+        writeKeyValue(key, value.mAreaType);
+    }
+
+    template <class T>
+    void writeKeyValues(std::vector<unsigned char>& key, const std::vector<T>& values)
+    {
+        writeKeyValue(key, static_cast<std::uint64_t>(values.size()));
+        for (const T& value : values)
+            writeKeyValue(key, value);
+    }
+}
+
+namespace DetourNavigator
+{
+    std::vector<unsigned char> makePersistentNavMeshKey(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        std::vector<unsigned char> result;
+        writeKeyValues(result, recastMesh.getIndices());
+        writeKeyValues(result, recastMesh.getVertices());
+        writeKeyValues(result, recastMesh.getAreaTypes());
+        writeKeyValues(result, recastMesh.getWater());
+        writeKeyValues(result, offMeshConnections);
+        return result;
+    }
+
+    NavMeshTilesStorage::NavMeshTilesStorage(const Settings& settings, const std::string& path)
+        : mRootPath(path)
+        , mPath(mRootPath / Files::toHex(getSettingsHash(settings)))
+        , mMaxSize(settings.mMaxNavMeshDiskCacheSize)
+        , mSize(Files::trimCache(mRootPath, mMaxSize))
+        , mTrimming(false)
+    {
+        Log(Debug::Info) << "Using nav mesh tiles storage at " << mPath;
+    }
+
+    NavMeshData NavMeshTilesStorage::load(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const std::vector<unsigned char>& navMeshKey) const
+    {
+        const auto path = getTilePath(agentHalfExtents, changedTile, navMeshKey);
+
+        try
+        {
+            boost::filesystem::ifstream file;
+            if (!Files::openCacheFile(file, path, navMeshTileMagic, navMeshTileVersion, Files::toStringView(navMeshKey)))
+                return NavMeshData();
+
+            const auto size = Files::readValue<std::int32_t>(file);
+            if (size <= 0)
+                return NavMeshData();
+
+            const auto data = static_cast<unsigned char*>(dtAlloc(size, DT_ALLOC_PERM));
+            if (!data)
+                return NavMeshData();
+
+            NavMeshData result(data, size);
+            file.read(reinterpret_cast<char*>(data), size);
+
+            Files::touchCacheFile(path);
+
+            return result;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to load nav mesh tile from " << path << ": " << e.what();
+            return NavMeshData();
+        }
+    }
+
+    void NavMeshTilesStorage::save(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const std::vector<unsigned char>& navMeshKey, const NavMeshDataRef& navMeshData) const
+    {
+        const auto path = getTilePath(agentHalfExtents, changedTile, navMeshKey);
+
+        try
+        {
+            const auto size = Files::writeCacheFile(path, navMeshTileMagic, navMeshTileVersion,
+                Files::toStringView(navMeshKey), [&] (std::ostream& file)
+                {
+                    Files::writeValue(file, static_cast<std::int32_t>(navMeshData.mSize));
+                    file.write(reinterpret_cast<const char*>(navMeshData.mValue), navMeshData.mSize);
+                });
+
+            std::uintmax_t sizeBeforeTrim;
+            {
+                const std::lock_guard<std::mutex> lock(mMutex);
+                mSize += size;
+                if (mSize <= mMaxSize || mTrimming)
+                    return;
+                mTrimming = true;
+                sizeBeforeTrim = mSize;
+            }
+
+            // Scanning the storage takes a while, other threads can load and save tiles meanwhile
+            std::uintmax_t sizeAfterTrim = sizeBeforeTrim;
+            try
+            {
+                sizeAfterTrim = Files::trimCache(mRootPath, static_cast<std::uintmax_t>(mMaxSize * trimFactor));
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(mMutex);
+                mTrimming = false;
+                throw;
+            }
+
+            const std::lock_guard<std::mutex> lock(mMutex);
+            // Tiles saved during trimming might be counted twice, the next trim will correct it
+            mSize = sizeAfterTrim + (mSize - sizeBeforeTrim);
+            mTrimming = false;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to save nav mesh tile to " << path << ": " << e.what();
+        }
+    }
+
+    boost::filesystem::path NavMeshTilesStorage::getTilePath(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& changedTile, const std::vector<unsigned char>& navMeshKey) const
+    {
+        const auto agent = Misc::Fnv1aHash()
+            .addValue(agentHalfExtents.x())
+            .addValue(agentHalfExtents.y())
+            .addValue(agentHalfExtents.z())
+            .getValue();
+        const auto key = Misc::fnv1aHash(navMeshKey.data(), navMeshKey.size());
+        return mPath / Files::toHex(agent) / (std::to_string(changedTile.x()) + "_" + std::to_string(changedTile.y())
+            + "_" + Files::toHex(key) + ".navtile");
+    }
+}
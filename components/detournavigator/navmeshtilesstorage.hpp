@@ -0,0 +1,58 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHTILESSTORAGE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHTILESSTORAGE_H
+
+#include "navmeshdata.hpp"
+#include "navmeshtilescache.hpp"
+#include "offmeshconnection.hpp"
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class RecastMesh;
+    struct Settings;
+
+    /// @brief Make a key to identify a tile in NavMeshTilesStorage.
+    /// Unlike makeNavMeshKey, each field is written explicitly with fixed width and byte order, so the key doesn't
+    /// include padding bytes and is the same for the same recast mesh and off mesh connections in every run.
+    std::vector<unsigned char> makePersistentNavMeshKey(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections);
+
+    /// @brief Persistent storage for generated nav mesh tiles.
+    /// Tiles are stored one per file and identified by a key made by makePersistentNavMeshKey, so a tile
+    /// built from identical recast mesh and off mesh connections can be loaded instead of being rebuilt.
+    /// Files are placed into a subdirectory depending on settings that affect tile generation.
+    /// When total size of stored tiles exceeds the limit, least recently used tiles are removed.
+    class NavMeshTilesStorage
+    {
+    public:
+        NavMeshTilesStorage(const Settings& settings, const std::string& path);
+
+        /// @return tile data or NavMeshData with null value when there is no stored tile for given key
+        NavMeshData load(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const std::vector<unsigned char>& navMeshKey) const;
+
+        void save(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const std::vector<unsigned char>& navMeshKey, const NavMeshDataRef& navMeshData) const;
+
+    private:
+        const boost::filesystem::path mRootPath;
+        const boost::filesystem::path mPath;
+        const std::uintmax_t mMaxSize;
+        mutable std::mutex mMutex;
+        mutable std::uintmax_t mSize;
+        mutable bool mTrimming;
+
+        boost::filesystem::path getTilePath(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const std::vector<unsigned char>& navMeshKey) const;
+    };
+}
+
+#endif
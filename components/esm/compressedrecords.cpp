@@ -0,0 +1,107 @@
+#include "compressedrecords.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <lz4frame.h>
+
+#include "esmreader.hpp"
+#include "esmwriter.hpp"
+
+namespace
+{
+    struct DecompressionContext
+    {
+        LZ4F_decompressionContext_t mValue = nullptr;
+
+        ~DecompressionContext()
+        {
+            LZ4F_freeDecompressionContext(mValue);
+        }
+    };
+
+    // LZ4 can't compress data more than 255 times
+    constexpr std::uint64_t maxCompressionRatio = 255;
+
+    std::string compress(const std::string& data)
+    {
+        LZ4F_preferences_t preferences = {};
+        preferences.frameInfo.contentSize = data.size();
+
+        std::string result(LZ4F_compressFrameBound(data.size(), &preferences), '\0');
+        const std::size_t size = LZ4F_compressFrame(&result[0], result.size(), data.data(), data.size(),
+                                                    &preferences);
+        if (LZ4F_isError(size))
+            throw std::runtime_error(std::string("LZ4 compression error: ") + LZ4F_getErrorName(size));
+        result.resize(size);
+        return result;
+    }
+
+    void write(ESM::ESMWriter& esm, std::uint64_t size, const std::string& compressed)
+    {
+        esm.writeHNT("SIZE", size);
+        esm.startSubRecord("DATA");
+        esm.write(compressed.data(), compressed.size());
+        esm.endRecord("DATA");
+    }
+}
+
+namespace ESM
+{
+    void CompressedRecords::load (ESMReader& esm)
+    {
+        std::uint64_t size = 0;
+        esm.getHNT(size, "SIZE");
+
+        esm.getSubNameIs("DATA");
+        esm.getSubHeader();
+
+        if (size > sMaxSize || size > esm.getSubSize() * maxCompressionRatio)
+            esm.fail("Invalid uncompressed size of compressed records: " + std::to_string(size));
+
+        std::string compressed(esm.getSubSize(), '\0');
+        esm.getExact(&compressed[0], static_cast<int>(compressed.size()));
+
+        DecompressionContext context;
+        const LZ4F_errorCode_t createResult = LZ4F_createDecompressionContext(&context.mValue, LZ4F_VERSION);
+        if (LZ4F_isError(createResult))
+            esm.fail(std::string("LZ4 decompression error: ") + LZ4F_getErrorName(createResult));
+
+        mData.assign(static_cast<std::size_t>(size), '\0');
+
+        std::size_t srcOffset = 0;
+        std::size_t dstOffset = 0;
+        std::size_t result = 1;
+        while (result != 0 && srcOffset < compressed.size())
+        {
+            std::size_t srcSize = compressed.size() - srcOffset;
+            std::size_t dstSize = mData.size() - dstOffset;
+            result = LZ4F_decompress(context.mValue, &mData[0] + dstOffset, &dstSize,
+                                     compressed.data() + srcOffset, &srcSize, nullptr);
+            if (LZ4F_isError(result))
+                esm.fail(std::string("LZ4 decompression error: ") + LZ4F_getErrorName(result));
+            srcOffset += srcSize;
+            dstOffset += dstSize;
+            if (srcSize == 0 && dstSize == 0)
+                break;
+        }
+
+        if (result != 0 || dstOffset != mData.size())
+            esm.fail("Truncated compressed records");
+    }
+
+    void CompressedRecords::save (ESMWriter& esm) const
+    {
+        write(esm, mData.size(), compress(mData));
+    }
+
+    void CompressedRecords::save (ESMWriter& esm, CompressedRecordsCache& cache) const
+    {
+        if (cache.mData != mData || cache.mCompressed.empty())
+        {
+            cache.mCompressed = compress(mData);
+            cache.mData = mData;
+        }
+        write(esm, mData.size(), cache.mCompressed);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef OPENMW_COMPONENTS_ESM_COMPRESSEDRECORDS_H
+#define OPENMW_COMPONENTS_ESM_COMPRESSEDRECORDS_H
+
+#include <cstdint>
+#include <string>
+
+namespace ESM
+{
+    class ESMReader;
+    class ESMWriter;
+
+    /// @brief Uncompressed and compressed data of the last saved group of records.
+    ///
+    /// Saved games often have groups which are not changed since the previous save, e.g. journal or input.
+    /// Keeping the cache for each group between saves allows to write them without compressing again.
+    struct CompressedRecordsCache
+    {
+        std::string mData;
+        std::string mCompressed;
+    };
+
+    // format 16, saved games only
+    /// @brief Group of records stored as a single LZ4 frame.
+    ///
+    /// Compressed data is a complete ESM stream starting with a TES3 header, so it can be read with a separate
+    /// ESMReader using the same format as the enclosing file.
+    struct CompressedRecords
+    {
+        /// Larger uncompressed size is treated as broken data to not allocate memory for it.
+        static constexpr std::uint64_t sMaxSize = std::uint64_t(1) << 30;
+
+        std::string mData; ///< Uncompressed data
+
+        void load (ESMReader& esm);
+        void save (ESMWriter& esm) const;
+
+        /// Same as save but takes compressed data from the cache when it's made for the same uncompressed data.
+        /// Otherwise cache is updated.
+        void save (ESMWriter& esm, CompressedRecordsCache& cache) const;
+    };
+}
+
+#endif
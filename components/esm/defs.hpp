@@ -157,6 +157,9 @@ enum RecNameInts
     REC_STLN = FourCC<'S','T','L','N'>::value,
     REC_INPU = FourCC<'I','N','P','U'>::value,
 
+    // format 16 - saved games
+    REC_CMPR = FourCC<'C','M','P','R'>::value, ///< LZ4 compressed group of saved game records
+
     // format 1
     REC_FILT = FourCC<'F','I','L','T'>::value,
     REC_DBGP = FourCC<'D','B','G','P'>::value ///< only used in project files
@@ -1,7 +1,10 @@
 #include "esmreader.hpp"
 
+#include <cstring>
 #include <stdexcept>
 
+#include <components/files/mappedfile.hpp>
+
 namespace ESM
 {
 
@@ -15,12 +18,13 @@ using namespace Misc;
 ESM_Context ESMReader::getContext()
 {
     // Update the file position before returning
-    mCtx.filePos = mEsm->tellg();
+    mCtx.filePos = getFileOffset();
     return mCtx;
 }
 
 ESMReader::ESMReader()
-    : mRecordFlags(0)
+    : mMappedPos(0)
+    , mRecordFlags(0)
     , mBuffer(50*1024)
     , mGlobalReaderList(nullptr)
     , mEncoder(nullptr)
@@ -36,20 +40,33 @@ int ESMReader::getFormat() const
 
 void ESMReader::restoreContext(const ESM_Context &rc)
 {
-    // Reopen the file if necessary
+    // Reopen the file if necessary, the same way the current one was opened
     if (mCtx.filename != rc.filename)
-        openRaw(rc.filename);
+    {
+        std::shared_ptr<const Files::MappedFile> mappedFile;
+        if (mMappedFile)
+            mappedFile = Files::mapFile(rc.filename);
+        if (mappedFile)
+            openRaw(std::move(mappedFile), rc.filename);
+        else
+            openRaw(rc.filename);
+    }
 
     // Copy the data
     mCtx = rc;
 
     // Make sure we seek to the right place
-    mEsm->seekg(mCtx.filePos);
+    if (mMappedFile)
+        mMappedPos = mCtx.filePos;
+    else
+        mEsm->seekg(mCtx.filePos);
 }
 
 void ESMReader::close()
 {
     mEsm.reset();
+    mMappedFile.reset();
+    mMappedPos = 0;
     clearCtx();
     mHeader.blank();
 }
@@ -75,15 +92,21 @@ void ESMReader::openRaw(Files::IStreamPtr _esm, const std::string& name)
     mEsm->seekg(0, mEsm->beg);
 }
 
+void ESMReader::openRaw(std::shared_ptr<const Files::MappedFile> file, const std::string &name)
+{
+    close();
+    mMappedFile = std::move(file);
+    mCtx.filename = name;
+    mCtx.leftFile = mFileSize = mMappedFile->size();
+}
+
 void ESMReader::openRaw(const std::string& filename)
 {
     openRaw(Files::openConstrainedFileStream(filename.c_str()), filename);
 }
 
-void ESMReader::open(Files::IStreamPtr _esm, const std::string &name)
+void ESMReader::readHeader()
 {
-    openRaw(_esm, name);
-
     if (getRecName() != "TES3")
         fail("Not a valid Morrowind file");
 
@@ -92,11 +115,28 @@ void ESMReader::open(Files::IStreamPtr _esm, const std::string &name)
     mHeader.load (*this);
 }
 
+void ESMReader::open(Files::IStreamPtr _esm, const std::string &name)
+{
+    openRaw(_esm, name);
+    readHeader();
+}
+
 void ESMReader::open(const std::string &file)
 {
     open (Files::openConstrainedFileStream (file.c_str ()), file);
 }
 
+void ESMReader::openMapped(const std::string &file)
+{
+    if (std::shared_ptr<const Files::MappedFile> mappedFile = Files::mapFile(file))
+    {
+        openRaw(std::move(mappedFile), file);
+        readHeader();
+    }
+    else
+        open(file);
+}
+
 int64_t ESMReader::getHNLong(const char *name)
 {
     int64_t val;
@@ -126,7 +166,10 @@ std::string ESMReader::getHString()
     // them. For some reason, they break the rules, and contain a byte
     // (value 0) even if the header says there is no data. If
     // Morrowind accepts it, so should we.
-    if (mCtx.leftSub == 0 && !mEsm->peek())
+    const bool hasZeroByte = mMappedFile
+        ? mMappedPos < mMappedFile->size() && mMappedFile->data()[mMappedPos] == 0
+        : !mEsm->peek();
+    if (mCtx.leftSub == 0 && hasZeroByte)
     {
         // Skip the following zero byte
         mCtx.leftRec--;
@@ -321,6 +364,15 @@ void ESMReader::getRecHeader(uint32_t &flags)
 
 void ESMReader::getExact(void*x, int size)
 {
+    if (mMappedFile)
+    {
+        if (size < 0 || static_cast<size_t>(size) > mMappedFile->size() - mMappedPos)
+            fail("Read error: end of file");
+        std::memcpy(x, mMappedFile->data() + mMappedPos, size);
+        mMappedPos += size;
+        return;
+    }
+
     try
     {
         mEsm->read((char*)x, size);
@@ -333,6 +385,16 @@ void ESMReader::getExact(void*x, int size)
 
 std::string ESMReader::getString(int size)
 {
+    // The encoder needs a zero terminated string, so only strings without conversion are read straight from the mapping
+    if (mMappedFile && !mEncoder)
+    {
+        if (size < 0 || static_cast<size_t>(size) > mMappedFile->size() - mMappedPos)
+            fail("Read error: end of file");
+        const char* ptr = mMappedFile->data() + mMappedPos;
+        mMappedPos += size;
+        return std::string(ptr, strnlen(ptr, size));
+    }
+
     size_t s = size;
     if (mBuffer.size() <= s)
         // Add some extra padding to reduce the chance of having to resize
@@ -365,7 +427,9 @@ void ESMReader::fail(const std::string &msg)
     ss << "\n  File: " << mCtx.filename;
     ss << "\n  Record: " << mCtx.recName.toString();
     ss << "\n  Subrecord: " << mCtx.subName.toString();
-    if (mEsm.get())
+    if (mMappedFile)
+        ss << "\n  Offset: 0x" << hex << mMappedPos;
+    else if (mEsm.get())
         ss << "\n  Offset: 0x" << hex << mEsm->tellg();
     throw std::runtime_error(ss.str());
 }
@@ -377,11 +441,20 @@ void ESMReader::setEncoder(ToUTF8::Utf8Encoder* encoder)
 
 size_t ESMReader::getFileOffset()
 {
+    if (mMappedFile)
+        return mMappedPos;
     return mEsm->tellg();
 }
 
 void ESMReader::skip(int bytes)
 {
+    if (mMappedFile)
+    {
+        if (bytes < 0 || static_cast<size_t>(bytes) > mMappedFile->size() - mMappedPos)
+            fail("Skip error: end of file");
+        mMappedPos += bytes;
+        return;
+    }
     mEsm->seekg(getFileOffset()+bytes);
 }
 
@@ -15,6 +15,11 @@
 #include "esmcommon.hpp"
 #include "loadtes3.hpp"
 
+namespace Files
+{
+  class MappedFile;
+}
+
 namespace ESM {
 
 class ESMReader
@@ -70,8 +75,16 @@ public:
 
   void open(const std::string &file);
 
+  /// Same as open() but reads data directly from a memory mapping of the file instead of a stream.
+  /// Falls back to a stream when the file can't be mapped.
+  /// @note The mapping is kept until the reader is closed, so the file may not be replaced in the meantime on some platforms.
+  void openMapped(const std::string &file);
+
   void openRaw(const std::string &filename);
 
+  /// Raw opening of a memory mapped file.
+  void openRaw(std::shared_ptr<const Files::MappedFile> file, const std::string &name);
+
   /// Get the current position in the file. Make sure that the file has been opened!
   size_t getFileOffset();
 
@@ -264,6 +277,8 @@ public:
   /// Sets font encoder for ESM strings
   void setEncoder(ToUTF8::Utf8Encoder* encoder);
 
+  ToUTF8::Utf8Encoder* getEncoder() const { return mEncoder; }
+
   /// Get record flags of last record
   unsigned int getRecordFlags() { return mRecordFlags; }
 
@@ -272,8 +287,14 @@ public:
 private:
   void clearCtx();
 
+  void readHeader();
+
   Files::IStreamPtr mEsm;
 
+  // Set instead of mEsm when the file is memory mapped
+  std::shared_ptr<const Files::MappedFile> mMappedFile;
+  size_t mMappedPos;
+
   ESM_Context mCtx;
 
   unsigned int mRecordFlags;
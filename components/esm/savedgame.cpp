@@ -4,7 +4,8 @@
 #include "esmwriter.hpp"
 
 unsigned int ESM::SavedGame::sRecordId = ESM::REC_SAVE;
-int ESM::SavedGame::sCurrentFormat = 15;
+int ESM::SavedGame::sCurrentFormat = 16;
+int ESM::SavedGame::sUncompressedFormat = 15;
 
 void ESM::SavedGame::load (ESMReader &esm)
 {
@@ -18,6 +18,7 @@ namespace ESM
         static unsigned int sRecordId;
 
         static int sCurrentFormat;
+        static int sUncompressedFormat; ///< Last format without compressed records
 
         std::vector<std::string> mContentFiles;
         std::string mPlayerName;
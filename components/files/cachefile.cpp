@@ -0,0 +1,153 @@
+#include "cachefile.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/filesystem/operations.hpp>
+
+namespace Files
+{
+    std::string toHex(std::uint64_t value)
+    {
+        std::ostringstream stream;
+        stream << std::hex << std::setw(16) << std::setfill('0') << value;
+        return stream.str();
+    }
+
+    void writeString(std::ostream& stream, std::string_view value)
+    {
+        writeValue(stream, static_cast<std::uint64_t>(value.size()));
+        stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    std::string readString(std::istream& stream)
+    {
+        std::string value(readValue<std::uint64_t>(stream), '\0');
+        stream.read(&value[0], static_cast<std::streamsize>(value.size()));
+        return value;
+    }
+
+    void writeFileStamp(std::ostream& stream, const boost::filesystem::path& path)
+    {
+        writeString(stream, path.string());
+        writeValue(stream, static_cast<std::uint64_t>(boost::filesystem::file_size(path)));
+        writeValue(stream, static_cast<std::int64_t>(boost::filesystem::last_write_time(path)));
+    }
+
+    bool openCacheFile(boost::filesystem::ifstream& file, const boost::filesystem::path& path,
+        std::uint32_t magic, std::uint32_t version, std::string_view key)
+    {
+        file.open(path, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.exceptions(std::ios::failbit | std::ios::badbit);
+
+        if (readValue<std::uint32_t>(file) != magic || readValue<std::uint32_t>(file) != version)
+            return false;
+
+        const auto keySize = readValue<std::uint64_t>(file);
+        if (keySize != key.size())
+            return false;
+
+        std::string storedKey(key.size(), '\0');
+        file.read(&storedKey[0], static_cast<std::streamsize>(storedKey.size()));
+        return storedKey == key;
+    }
+
+    std::uintmax_t writeCacheFile(const boost::filesystem::path& path, std::uint32_t magic, std::uint32_t version,
+        std::string_view key, const std::function<void (std::ostream&)>& writeContent)
+    {
+        boost::filesystem::create_directories(path.parent_path());
+
+        // Other threads and processes may use the same cache, so file is written under unique name and then renamed
+        const auto tmpPath = path.parent_path() / boost::filesystem::unique_path("%%%%%%%%%%%%%%%%.tmp");
+
+        try
+        {
+            std::uintmax_t size = 0;
+
+            {
+                boost::filesystem::ofstream file(tmpPath, std::ios::out | std::ios::binary);
+                if (!file.is_open())
+                    throw std::runtime_error("open file failed: " + tmpPath.string());
+                file.exceptions(std::ios::failbit | std::ios::badbit);
+
+                writeValue(file, magic);
+                writeValue(file, version);
+                writeString(file, key);
+                writeContent(file);
+
+                size = static_cast<std::uintmax_t>(file.tellp());
+            }
+
+            boost::filesystem::rename(tmpPath, path);
+
+            return size;
+        }
+        catch (...)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpPath, ec);
+            throw;
+        }
+    }
+
+    void touchCacheFile(const boost::filesystem::path& path)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::last_write_time(path, std::time(nullptr), ec);
+    }
+
+    std::uintmax_t trimCache(const boost::filesystem::path& path, std::uintmax_t targetSize)
+    {
+        struct File
+        {
+            std::time_t mLastWriteTime;
+            std::uintmax_t mSize;
+            boost::filesystem::path mPath;
+        };
+
+        std::vector<File> files;
+        std::uintmax_t totalSize = 0;
+
+        boost::system::error_code ec;
+        boost::filesystem::recursive_directory_iterator it(path, ec);
+        for (const boost::filesystem::recursive_directory_iterator end; !ec && it != end; it.increment(ec))
+        {
+            // Temporary files are being written by someone else
+            if (!boost::filesystem::is_regular_file(it->status()) || it->path().extension() == ".tmp")
+                continue;
+
+            boost::system::error_code fileEc;
+            const std::time_t lastWriteTime = boost::filesystem::last_write_time(it->path(), fileEc);
+            if (fileEc)
+                continue;
+            const std::uintmax_t size = boost::filesystem::file_size(it->path(), fileEc);
+            if (fileEc)
+                continue;
+
+            files.push_back(File {lastWriteTime, size, it->path()});
+            totalSize += size;
+        }
+
+        if (totalSize <= targetSize)
+            return totalSize;
+
+        std::sort(files.begin(), files.end(),
+                  [] (const File& lhs, const File& rhs) { return lhs.mLastWriteTime < rhs.mLastWriteTime; });
+
+        for (const File& file : files)
+        {
+            if (totalSize <= targetSize)
+                break;
+            if (boost::filesystem::remove(file.mPath, ec))
+                totalSize -= file.mSize;
+        }
+
+        return totalSize;
+    }
+}
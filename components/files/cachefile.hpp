@@ -0,0 +1,74 @@
+#ifndef OPENMW_COMPONENTS_FILES_CACHEFILE_H
+#define OPENMW_COMPONENTS_FILES_CACHEFILE_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace Files
+{
+    /// @brief Helpers for files of on-disk caches.
+    ///
+    /// A cache file starts with a magic number, a format version and the full key its content was produced from.
+    /// Files are usually named by a hash of the key, the stored key tells apart different keys with the same hash.
+    /// Files are replaced atomically, so concurrent readers never see a partially written file.
+
+    /// @return fixed width hexadecimal representation of the value to use in file names
+    std::string toHex(std::uint64_t value);
+
+    template <class T>
+    void writeValue(std::ostream& stream, const T& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <class T>
+    T readValue(std::istream& stream)
+    {
+        T value;
+        stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    void writeString(std::ostream& stream, std::string_view value);
+
+    std::string readString(std::istream& stream);
+
+    /// @brief Write path, size and modification time of the file to tell when it is changed without reading it.
+    /// @throw std::exception when the file doesn't exist
+    void writeFileStamp(std::ostream& stream, const boost::filesystem::path& path);
+
+    inline std::string_view toStringView(const std::vector<unsigned char>& value)
+    {
+        return std::string_view(reinterpret_cast<const char*>(value.data()), value.size());
+    }
+
+    /// @brief Open cache file and read its header.
+    /// @return false when there is no file or it was written with different magic, version or key
+    /// @throw std::exception when the file can't be read, the stream is set to throw on further read errors
+    bool openCacheFile(boost::filesystem::ifstream& file, const boost::filesystem::path& path,
+        std::uint32_t magic, std::uint32_t version, std::string_view key);
+
+    /// @brief Write header and content to a file with unique name in the same directory and rename it to path.
+    /// @return size of written file
+    /// @throw std::exception on failure, nothing is left on disk in this case
+    std::uintmax_t writeCacheFile(const boost::filesystem::path& path, std::uint32_t magic, std::uint32_t version,
+        std::string_view key, const std::function<void (std::ostream&)>& writeContent);
+
+    /// @brief Mark cache file as recently used, so trimCache removes it after the files that were not used.
+    void touchCacheFile(const boost::filesystem::path& path);
+
+    /// @brief Remove least recently used files from the directory and its subdirectories until their total size
+    /// doesn't exceed targetSize.
+    /// @return total size of remaining files
+    std::uintmax_t trimCache(const boost::filesystem::path& path, std::uintmax_t targetSize);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "mappedfile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <components/debug/debuglog.hpp>
+
+#include "memorystream.hpp"
+
+namespace Files
+{
+    namespace
+    {
+        class MappedFileStreamBuf : public MemBuf
+        {
+        public:
+            MappedFileStreamBuf(std::shared_ptr<const MappedFile> file, std::size_t start, std::size_t length)
+                : MemBuf(file->data() + start, length)
+                , mFile(std::move(file))
+            {
+            }
+
+            pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode) override
+            {
+                if((mode&std::ios_base::out) || !(mode&std::ios_base::in))
+                    return pos_type(off_type(-1));
+
+                off_type newPos;
+                switch (whence)
+                {
+                    case std::ios_base::beg:
+                        newPos = offset;
+                        break;
+                    case std::ios_base::cur:
+                        newPos = (gptr() - bufferStart) + offset;
+                        break;
+                    case std::ios_base::end:
+                        newPos = (bufferEnd - bufferStart) + offset;
+                        break;
+                    default:
+                        return pos_type(off_type(-1));
+                }
+
+                if (newPos < 0 || newPos > bufferEnd - bufferStart)
+                    return pos_type(off_type(-1));
+
+                setg(bufferStart, bufferStart + newPos, bufferEnd);
+                return newPos;
+            }
+
+            pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override
+            {
+                return seekoff(pos, std::ios_base::beg, mode);
+            }
+
+        private:
+            std::shared_ptr<const MappedFile> mFile;
+        };
+    }
+
+    MappedFile::MappedFile(const std::string& filename)
+        : mSource(filename)
+    {
+    }
+
+    std::shared_ptr<const MappedFile> mapFile(const std::string& filename)
+    {
+        try
+        {
+            return std::make_shared<const MappedFile>(filename);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to map file " << filename << ", falling back to regular file access: " << e.what();
+            return nullptr;
+        }
+    }
+
+    IStreamPtr openMappedFileStream(std::shared_ptr<const MappedFile> file, std::size_t start, std::size_t length)
+    {
+        if (start > file->size())
+            throw std::runtime_error("Mapped file stream start is out of file bounds");
+        length = std::min(length, file->size() - start);
+        auto buf = std::unique_ptr<std::streambuf>(new MappedFileStreamBuf(std::move(file), start, length));
+        return IStreamPtr(new ConstrainedFileStream(std::move(buf)));
+    }
+}
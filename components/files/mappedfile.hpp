@@ -0,0 +1,43 @@
+#ifndef OPENMW_COMPONENTS_FILES_MAPPEDFILE_H
+#define OPENMW_COMPONENTS_FILES_MAPPEDFILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "constrainedfilestream.hpp"
+
+namespace Files
+{
+
+/// Read-only memory mapping of a whole file. Streams created from it read directly from the mapping
+/// and keep it alive, so no file handle is opened and no data is copied into intermediate buffers.
+/// @note Thread safe.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return mSource.data(); }
+
+    std::size_t size() const { return mSource.size(); }
+
+private:
+    boost::iostreams::mapped_file_source mSource;
+};
+
+/// Map the whole file. Returns nullptr and logs a warning when file can't be mapped (e.g. it is empty or
+/// there is not enough address space), callers are expected to fall back to openConstrainedFileStream.
+std::shared_ptr<const MappedFile> mapFile(const std::string& filename);
+
+/// Open a stream over the region of the mapped file specified by the 'start' and 'length' parameters.
+IStreamPtr openMappedFileStream(std::shared_ptr<const MappedFile> file, std::size_t start=0, std::size_t length=0xFFFFFFFF);
+
+}
+
+#endif
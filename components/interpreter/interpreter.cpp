@@ -7,8 +7,11 @@
 
 namespace Interpreter
 {
-    void Interpreter::execute (Type_Code code)
+    Interpreter::Instruction Interpreter::decode (Type_Code code) const
     {
+        Instruction instruction {code, 0, nullptr, nullptr};
+
+        // Unknown opcodes are reported by execute(), so they are only an error when they are reached
         unsigned int segSpec = code>>30;
 
         switch (segSpec)
@@ -16,31 +19,27 @@ namespace Interpreter
             case 0:
             {
                 int opcode = code>>24;
-                unsigned int arg0 = code & 0xffffff;
-
-                std::map<int, Opcode1 *>::iterator iter = mSegment0.find (opcode);
+                instruction.mArg0 = code & 0xffffff;
 
-                if (iter==mSegment0.end())
-                    abortUnknownCode (0, opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment0.find (opcode);
 
-                iter->second->execute (mRuntime, arg0);
+                if (iter!=mSegment0.end())
+                    instruction.mOpcode1 = iter->second;
 
-                return;
+                return instruction;
             }
 
             case 2:
             {
                 int opcode = (code>>20) & 0x3ff;
-                unsigned int arg0 = code & 0xfffff;
-
-                std::map<int, Opcode1 *>::iterator iter = mSegment2.find (opcode);
+                instruction.mArg0 = code & 0xfffff;
 
-                if (iter==mSegment2.end())
-                    abortUnknownCode (2, opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment2.find (opcode);
 
-                iter->second->execute (mRuntime, arg0);
+                if (iter!=mSegment2.end())
+                    instruction.mOpcode1 = iter->second;
 
-                return;
+                return instruction;
             }
         }
 
@@ -51,33 +50,60 @@ namespace Interpreter
             case 0x30:
             {
                 int opcode = (code>>8) & 0x3ffff;
-                unsigned int arg0 = code & 0xff;
+                instruction.mArg0 = code & 0xff;
 
-                std::map<int, Opcode1 *>::iterator iter = mSegment3.find (opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment3.find (opcode);
 
-                if (iter==mSegment3.end())
-                    abortUnknownCode (3, opcode);
+                if (iter!=mSegment3.end())
+                    instruction.mOpcode1 = iter->second;
 
-                iter->second->execute (mRuntime, arg0);
-
-                return;
+                return instruction;
             }
 
             case 0x32:
             {
                 int opcode = code & 0x3ffffff;
 
-                std::map<int, Opcode0 *>::iterator iter = mSegment5.find (opcode);
-
-                if (iter==mSegment5.end())
-                    abortUnknownCode (5, opcode);
+                std::map<int, Opcode0 *>::const_iterator iter = mSegment5.find (opcode);
 
-                iter->second->execute (mRuntime);
+                if (iter!=mSegment5.end())
+                    instruction.mOpcode0 = iter->second;
 
-                return;
+                return instruction;
             }
         }
 
+        return instruction;
+    }
+
+    void Interpreter::execute (const Instruction& instruction)
+    {
+        if (instruction.mOpcode1)
+        {
+            instruction.mOpcode1->execute (mRuntime, instruction.mArg0);
+            return;
+        }
+
+        if (instruction.mOpcode0)
+        {
+            instruction.mOpcode0->execute (mRuntime);
+            return;
+        }
+
+        const Type_Code code = instruction.mCode;
+
+        switch (code>>30)
+        {
+            case 0: abortUnknownCode (0, code>>24);
+            case 2: abortUnknownCode (2, (code>>20) & 0x3ff);
+        }
+
+        switch (code>>26)
+        {
+            case 0x30: abortUnknownCode (3, (code>>8) & 0x3ffff);
+            case 0x32: abortUnknownCode (5, code & 0x3ffffff);
+        }
+
         abortUnknownSegment (code);
     }
 
@@ -166,7 +192,36 @@ namespace Interpreter
         mSegment5.insert (std::make_pair (code, opcode));
     }
 
+    Interpreter::DecodedCode Interpreter::decode (const Type_Code *code, int codeSize) const
+    {
+        assert (codeSize>=4);
+
+        const int opcodes = static_cast<int> (code[0]);
+        const Type_Code *codeBlock = code + 4;
+
+        DecodedCode decoded;
+        decoded.reserve (opcodes);
+
+        for (int i = 0; i < opcodes; ++i)
+            decoded.push_back (decode (codeBlock[i]));
+
+        return decoded;
+    }
+
     void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    {
+        // One-shot scripts are not decoded in advance, each instruction is looked up when it is executed
+        run (code, codeSize, nullptr, context);
+    }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, const DecodedCode& decoded, Context& context)
+    {
+        assert (decoded.size()==code[0]);
+
+        run (code, codeSize, decoded.data(), context);
+    }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, const Instruction *decoded, Context& context)
     {
         assert (codeSize>=4);
 
@@ -176,15 +231,18 @@ namespace Interpreter
         {
             mRuntime.configure (code, codeSize, context);
 
-            int opcodes = static_cast<int> (code[0]);
-
+            const int opcodes = static_cast<int> (code[0]);
             const Type_Code *codeBlock = code + 4;
 
             while (mRuntime.getPC()>=0 && mRuntime.getPC()<opcodes)
             {
-                Type_Code runCode = codeBlock[mRuntime.getPC()];
-                mRuntime.setPC (mRuntime.getPC()+1);
-                execute (runCode);
+                const int pc = mRuntime.getPC();
+                mRuntime.setPC (pc+1);
+
+                if (decoded!=nullptr)
+                    execute (decoded[pc]);
+                else
+                    execute (decode (codeBlock[pc]));
             }
         }
         catch (...)
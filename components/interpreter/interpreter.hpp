@@ -3,6 +3,7 @@
 
 #include <map>
 #include <stack>
+#include <vector>
 
 #include "runtime.hpp"
 #include "types.hpp"
@@ -14,6 +15,21 @@ namespace Interpreter
 
     class Interpreter
     {
+        public:
+
+            /// Opcode with its handler already looked up
+            struct Instruction
+            {
+                Type_Code mCode;
+                unsigned int mArg0;
+                Opcode0 *mOpcode0;
+                Opcode1 *mOpcode1;
+            };
+
+            typedef std::vector<Instruction> DecodedCode;
+
+        private:
+
             std::stack<Runtime> mCallstack;
             bool mRunning;
             Runtime mRuntime;
@@ -26,11 +42,16 @@ namespace Interpreter
             Interpreter (const Interpreter&);
             Interpreter& operator= (const Interpreter&);
 
-            void execute (Type_Code code);
+            Instruction decode (Type_Code code) const;
 
-            void abortUnknownCode (int segment, int opcode);
+            void execute (const Instruction& instruction);
 
-            void abortUnknownSegment (Type_Code code);
+            void run (const Type_Code *code, int codeSize, const Instruction *decoded, Context& context);
+            ///< Execute \a code, looking up each instruction when it is executed if \a decoded is nullptr.
+
+            [[noreturn]] void abortUnknownCode (int segment, int opcode);
+
+            [[noreturn]] void abortUnknownSegment (Type_Code code);
 
             void begin();
 
@@ -54,7 +75,14 @@ namespace Interpreter
             void installSegment5 (int code, Opcode0 *opcode);
             ///< ownership of \a opcode is transferred to *this.
 
+            DecodedCode decode (const Type_Code *code, int codeSize) const;
+            ///< Look up handlers of all opcodes in \a code. The result stays valid as long as *this exists.
+
             void run (const Type_Code *code, int codeSize, Context& context);
+            ///< Execute \a code without decoding it in advance, meant for scripts executed only once.
+
+            void run (const Type_Code *code, int codeSize, const DecodedCode& decoded, Context& context);
+            ///< \a decoded must be the result of decode() for \a code.
     };
 }
 
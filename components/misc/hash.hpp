@@ -0,0 +1,62 @@
+#ifndef OPENMW_COMPONENTS_MISC_HASH_H
+#define OPENMW_COMPONENTS_MISC_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Misc
+{
+    /// @brief 64-bit FNV-1a hash. Unlike std::hash the result is stable between runs and builds,
+    /// so it can be used to name files of on-disk caches.
+    class Fnv1aHash
+    {
+        public:
+            static constexpr std::uint64_t sOffsetBasis = 14695981039346656037ull;
+            static constexpr std::uint64_t sPrime = 1099511628211ull;
+
+            explicit Fnv1aHash(std::uint64_t seed = sOffsetBasis) : mValue(seed) {}
+
+            Fnv1aHash& add(const void* data, std::size_t size)
+            {
+                const auto bytes = static_cast<const unsigned char*>(data);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    mValue ^= bytes[i];
+                    mValue *= sPrime;
+                }
+                return *this;
+            }
+
+            Fnv1aHash& add(std::string_view value)
+            {
+                return add(value.data(), value.size());
+            }
+
+            template <class T>
+            Fnv1aHash& addValue(const T& value)
+            {
+                return add(&value, sizeof(T));
+            }
+
+            std::uint64_t getValue() const
+            {
+                return mValue;
+            }
+
+        private:
+            std::uint64_t mValue;
+    };
+
+    inline std::uint64_t fnv1aHash(const void* data, std::size_t size)
+    {
+        return Fnv1aHash().add(data, size).getValue();
+    }
+
+    inline std::uint64_t fnv1aHash(std::string_view value)
+    {
+        return fnv1aHash(value.data(), value.size());
+    }
+}
+
+#endif
@@ -3,8 +3,10 @@
 
 #include <cctype>
 #include <string>
+#include <string_view>
 #include <algorithm>
 
+#include "hash.hpp"
 #include "utf8stream.hpp"
 
 namespace Misc
@@ -172,6 +174,31 @@ public:
         }
     };
 
+    /// Case insensitive hash for unordered containers, allows to look up a key without making a lower case copy
+    struct CiHash
+    {
+        std::size_t operator()(std::string_view value) const
+        {
+            Misc::Fnv1aHash hasher;
+            for (char ch : value)
+                hasher.addValue(toLower(ch));
+            return static_cast<std::size_t>(hasher.getValue());
+        }
+    };
+
+    struct CiEqual
+    {
+        bool operator()(std::string_view left, std::string_view right) const
+        {
+            if (left.size() != right.size())
+                return false;
+            for (std::size_t i = 0; i < left.size(); ++i)
+                if (toLower(left[i]) != toLower(right[i]))
+                    return false;
+            return true;
+        }
+    };
+
 
     /// Performs a binary search on a sorted container for a string that 'key' starts with
     template<typename Iterator, typename T>
@@ -5,8 +5,10 @@
 
 #include "nifstream.hpp"
 
+#include <algorithm>
+#include <numeric>
 #include <sstream>
-#include <map>
+#include <vector>
 
 #include "niffile.hpp"
 
@@ -43,13 +45,15 @@ using QuaternionKey = KeyT<osg::Quat>;
 
 template<typename T, T (NIFStream::*getValue)()>
 struct KeyMapT {
-    using MapType = std::map<float, KeyT<T>>;
-
     using ValueType = T;
     using KeyType = KeyT<T>;
 
     unsigned int mInterpolationType = InterpolationType_Linear;
-    MapType mKeys;
+
+    // Keys sorted by time with unique times. Times are stored separately from the values
+    // to keep them contiguous for the search done on every animation update.
+    std::vector<float> mTimes;
+    std::vector<KeyT<T>> mKeys;
 
     //Read in a KeyGroup (see http://niftools.sourceforge.net/doc/nif/NiKeyframeData.html)
     void read(NIFStream *nif, bool force = false, bool morph = false)
@@ -73,10 +77,14 @@ struct KeyMapT {
             return;
         }
 
+        mTimes.clear();
         mKeys.clear();
 
         mInterpolationType = nif->getUInt();
 
+        mTimes.reserve(count);
+        mKeys.reserve(count);
+
         KeyT<T> key;
         NIFStream &nifReference = *nif;
 
@@ -87,7 +95,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readValue(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         else if (mInterpolationType == InterpolationType_Quadratic)
@@ -96,7 +104,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readQuadratic(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         else if (mInterpolationType == InterpolationType_TBC)
@@ -105,7 +113,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readTBC(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         //XYZ keys aren't actually read here.
@@ -135,9 +143,50 @@ struct KeyMapT {
             error << "Unhandled interpolation type: " << mInterpolationType;
             nif->file->fail(error.str());
         }
+
+        sortKeys();
     }
 
 private:
+    void addKey(float time, const KeyT<T>& key)
+    {
+        mTimes.push_back(time);
+        mKeys.push_back(key);
+    }
+
+    // Keys are almost always stored in order, but to be safe sort them and drop duplicate times
+    // keeping the last key read for each time.
+    void sortKeys()
+    {
+        bool unique = true;
+        for (size_t i = 1; i < mTimes.size() && unique; ++i)
+            unique = mTimes[i - 1] < mTimes[i];
+        if (unique)
+            return;
+
+        std::vector<size_t> order(mTimes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&] (size_t lhs, size_t rhs) { return mTimes[lhs] < mTimes[rhs]; });
+
+        std::vector<float> times;
+        std::vector<KeyT<T>> keys;
+        times.reserve(order.size());
+        keys.reserve(order.size());
+        for (size_t index : order)
+        {
+            if (!times.empty() && times.back() == mTimes[index])
+            {
+                keys.back() = mKeys[index];
+                continue;
+            }
+            times.push_back(mTimes[index]);
+            keys.push_back(mKeys[index]);
+        }
+
+        mTimes = std::move(times);
+        mKeys = std::move(keys);
+    }
+
     static void readValue(NIFStream &nif, KeyT<T> &key)
     {
         key.mValue = (nif.*getValue)();
@@ -3,6 +3,8 @@
 // - removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
 // - template allows customized KeyType.
 // - objects with uninitialized time stamp are not removed.
+// - cache is split into shards selected by key hash, each with its own shared mutex, so lookups from
+//   different threads don't contend on a single lock and per-frame maintenance locks one shard at a time.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -23,10 +25,18 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 #include <osg/Node>
+#include <osg/Vec2f>
 
-#include <string>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace osg
 {
@@ -37,6 +47,52 @@ namespace osg
 
 namespace Resource {
 
+namespace ObjectCacheDetail
+{
+    inline void combineHash(std::size_t& seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    inline std::size_t hashKey(const osg::Vec2f& value)
+    {
+        std::size_t result = std::hash<float>()(value.x());
+        combineHash(result, std::hash<float>()(value.y()));
+        return result;
+    }
+
+    template <class T>
+    std::size_t hashKey(const T& value);
+
+    template <class First, class Second>
+    std::size_t hashKey(const std::pair<First, Second>& value);
+
+    template <class ... T>
+    std::size_t hashKey(const std::tuple<T ...>& value);
+
+    template <class T>
+    std::size_t hashKey(const T& value)
+    {
+        return std::hash<T>()(value);
+    }
+
+    template <class First, class Second>
+    std::size_t hashKey(const std::pair<First, Second>& value)
+    {
+        std::size_t result = hashKey(value.first);
+        combineHash(result, hashKey(value.second));
+        return result;
+    }
+
+    template <class ... T>
+    std::size_t hashKey(const std::tuple<T ...>& value)
+    {
+        std::size_t result = 0;
+        std::apply([&] (const auto& ... v) { (combineHash(result, hashKey(v)), ...); }, value);
+        return result;
+    }
+}
+
 template <typename KeyType>
 class GenericObjectCache : public osg::Referenced
 {
@@ -54,13 +110,17 @@ class GenericObjectCache : public osg::Referenced
         void updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime)
         {
             // look for objects with external references and update their time stamp.
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr=_objectCache.begin(); itr!=_objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                // If ref count is greater than 1, the object has an external reference.
-                // If the timestamp is yet to be initialized, it needs to be updated too.
-                if (itr->second.first->referenceCount()>1 || itr->second.second == 0.0)
-                    itr->second.second = referenceTime;
+                // time stamps are atomic, so readers of this shard are not blocked
+                std::shared_lock<std::shared_mutex> lock(shard._mutex);
+                for (auto& item : shard._objectCache)
+                {
+                    // If ref count is greater than 1, the object has an external reference.
+                    // If the timestamp is yet to be initialized, it needs to be updated too.
+                    if (item.second._object->referenceCount()>1 || item.second._timeStamp.load(std::memory_order_relaxed) == 0.0)
+                        item.second._timeStamp.store(referenceTime, std::memory_order_relaxed);
+                }
             }
         }
 
@@ -71,16 +131,17 @@ class GenericObjectCache : public osg::Referenced
         void removeExpiredObjectsInCache(double expiryTime)
         {
             std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+            for (Shard& shard : _shards)
             {
-                std::lock_guard<std::mutex> lock(_objectCacheMutex);
+                std::lock_guard<std::shared_mutex> lock(shard._mutex);
                 // Remove expired entries from object cache
-                typename ObjectCacheMap::iterator oitr = _objectCache.begin();
-                while(oitr != _objectCache.end())
+                auto oitr = shard._objectCache.begin();
+                while(oitr != shard._objectCache.end())
                 {
-                    if (oitr->second.second<=expiryTime)
+                    if (oitr->second._timeStamp.load(std::memory_order_relaxed)<=expiryTime)
                     {
-                        objectsToRemove.push_back(oitr->second.first);
-                        _objectCache.erase(oitr++);
+                        objectsToRemove.push_back(std::move(oitr->second._object));
+                        oitr = shard._objectCache.erase(oitr);
                     }
                     else
                         ++oitr;
@@ -93,43 +154,58 @@ class GenericObjectCache : public osg::Referenced
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear()
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache.clear();
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::shared_mutex> lock(shard._mutex);
+                shard._objectCache.clear();
+            }
         }
 
         /** Add a key,object,timestamp triple to the Registry::ObjectCache.*/
         void addEntryToObjectCache(const KeyType& key, osg::Object* object, double timestamp = 0.0)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache[key]=ObjectTimeStampPair(object,timestamp);
+            Shard& shard = getShard(key);
+            std::lock_guard<std::shared_mutex> lock(shard._mutex);
+            const auto it = shard._objectCache.find(key);
+            if (it == shard._objectCache.end())
+            {
+                shard._objectCache.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                           std::forward_as_tuple(object, timestamp));
+                return;
+            }
+            it->second._object = object;
+            it->second._timeStamp.store(timestamp, std::memory_order_relaxed);
         }
 
         /** Remove Object from cache.*/
         void removeFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end()) _objectCache.erase(itr);
+            Shard& shard = getShard(key);
+            std::lock_guard<std::shared_mutex> lock(shard._mutex);
+            auto itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end()) shard._objectCache.erase(itr);
         }
 
         /** Get an ref_ptr<Object> from the object cache*/
         osg::ref_ptr<osg::Object> getRefFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
-                return itr->second.first;
+            Shard& shard = getShard(key);
+            std::shared_lock<std::shared_mutex> lock(shard._mutex);
+            auto itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end())
+                return itr->second._object;
             else return nullptr;
         }
 
         /** Check if an object is in the cache, and if it is, update its usage time stamp. */
         bool checkInObjectCache(const KeyType& key, double timeStamp)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
+            Shard& shard = getShard(key);
+            std::shared_lock<std::shared_mutex> lock(shard._mutex);
+            auto itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end())
             {
-                itr->second.second = timeStamp;
+                itr->second._timeStamp.store(timeStamp, std::memory_order_relaxed);
                 return true;
             }
             else return false;
@@ -138,55 +214,90 @@ class GenericObjectCache : public osg::Referenced
         /** call releaseGLObjects on all objects attached to the object cache.*/
         void releaseGLObjects(osg::State* state)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                object->releaseGLObjects(state);
+                std::shared_lock<std::shared_mutex> lock(shard._mutex);
+                for (auto& item : shard._objectCache)
+                {
+                    osg::Object* object = item.second._object.get();
+                    object->releaseGLObjects(state);
+                }
             }
         }
 
         /** call node->accept(nv); for all nodes in the objectCache. */
         void accept(osg::NodeVisitor& nv)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                if (object)
+                std::shared_lock<std::shared_mutex> lock(shard._mutex);
+                for (auto& item : shard._objectCache)
                 {
-                    osg::Node* node = dynamic_cast<osg::Node*>(object);
-                    if (node)
-                        node->accept(nv);
+                    osg::Object* object = item.second._object.get();
+                    if (object)
+                    {
+                        osg::Node* node = dynamic_cast<osg::Node*>(object);
+                        if (node)
+                            node->accept(nv);
+                    }
                 }
             }
         }
 
-        /** call operator()(KeyType, osg::Object*) for each object in the cache. */
+        /** call operator()(KeyType, osg::Object*) for each object in the cache.
+          * @note Objects are visited shard by shard, not in key order. */
         template <class Functor>
         void call(Functor& f)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for (typename ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->first, it->second.first.get());
+            for (Shard& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard._mutex);
+                for (auto& item : shard._objectCache)
+                    f(item.first, item.second._object.get());
+            }
         }
 
         /** Get the number of objects in the cache. */
         unsigned int getCacheSize() const
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            return _objectCache.size();
+            std::size_t result = 0;
+            for (const Shard& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard._mutex);
+                result += shard._objectCache.size();
+            }
+            return static_cast<unsigned int>(result);
         }
 
     protected:
 
         virtual ~GenericObjectCache() {}
 
-        typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<KeyType, ObjectTimeStampPair >             ObjectCacheMap;
+        struct CacheItem
+        {
+            osg::ref_ptr<osg::Object> _object;
+            // updated under shared lock
+            std::atomic<double> _timeStamp;
+
+            CacheItem(osg::Object* object, double timeStamp) : _object(object), _timeStamp(timeStamp) {}
+        };
+
+        typedef std::map<KeyType, CacheItem>                        ObjectCacheMap;
+
+        struct Shard
+        {
+            ObjectCacheMap                      _objectCache;
+            mutable std::shared_mutex           _mutex;
+        };
+
+        static constexpr std::size_t sNumShards = 16;
+
+        Shard& getShard(const KeyType& key)
+        {
+            return _shards[ObjectCacheDetail::hashKey(key) % sNumShards];
+        }
 
-        ObjectCacheMap                          _objectCache;
-        mutable std::mutex                      _objectCacheMutex;
+        std::array<Shard, sNumShards>           _shards;
 
 };
 
@@ -250,6 +250,12 @@ namespace Resource
         node->accept(*shaderVisitor);
     }
 
+    void SceneManager::shareState(osg::ref_ptr<osg::Node> node)
+    {
+        std::lock_guard<std::mutex> lock(mSharedStateMutex);
+        mSharedStateManager->share(node.get());
+    }
+
     void SceneManager::setClampLighting(bool clamp)
     {
         mClampLighting = clamp;
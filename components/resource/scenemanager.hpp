@@ -53,6 +53,10 @@ namespace Resource
         /// Re-create shaders for this node, need to call this if texture stages or vertex color mode have changed.
         void recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix = "objects");
 
+        /// Share state of a node created outside of the SceneManager with the state of loaded scenes.
+        /// @note Thread safe.
+        void shareState(osg::ref_ptr<osg::Node> node);
+
         /// @see ShaderVisitor::setForceShaders
         void setForceShaders(bool force);
         bool getForceShaders() const;
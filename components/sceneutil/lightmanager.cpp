@@ -1,5 +1,8 @@
 #include "lightmanager.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <osgUtil/CullVisitor>
 
 #include <components/sceneutil/util.hpp>
@@ -154,7 +157,7 @@ namespace SceneUtil
         void operator()(osg::Node* node, osg::NodeVisitor* nv) override
         {
             LightManager* lightManager = static_cast<LightManager*>(node);
-            lightManager->update();
+            lightManager->update(nv->getTraversalNumber());
 
             traverse(node, nv);
         }
@@ -187,16 +190,35 @@ namespace SceneUtil
         return mLightingMask;
     }
 
-    void LightManager::update()
+    namespace
+    {
+        // StateSets of light lists not used for this number of frames are removed from the cache
+        constexpr unsigned int maxUnusedFrames = 120;
+        constexpr unsigned int cleanupInterval = 64;
+    }
+
+    void LightManager::update(unsigned int frameNum)
     {
         mLights.clear();
         mLightsInViewSpace.clear();
 
-        // do an occasional cleanup for orphaned lights
+        // do an occasional cleanup of StateSets for light lists that are no longer used, e.g. because of orphaned lights
+        if (frameNum % cleanupInterval != 0)
+            return;
+
         for (int i=0; i<2; ++i)
         {
-            if (mStateSetCache[i].size() > 5000)
-                mStateSetCache[i].clear();
+            for (auto it = mStateSetCache[i].begin(); it != mStateSetCache[i].end();)
+            {
+                std::vector<CachedLightStateSet>& entries = it->second;
+                entries.erase(std::remove_if(entries.begin(), entries.end(),
+                    [&] (const CachedLightStateSet& entry) { return frameNum - entry.mLastUsedFrame > maxUnusedFrames; }),
+                    entries.end());
+                if (entries.empty())
+                    it = mStateSetCache[i].erase(it);
+                else
+                    ++it;
+            }
         }
     }
 
@@ -226,11 +248,25 @@ namespace SceneUtil
         for (unsigned int i=0; i<lightList.size();++i)
             hash_combine(hash, lightList[i]->mLightSource->getId());
 
-        LightStateSetMap& stateSetCache = mStateSetCache[frameNum%2];
+        std::vector<CachedLightStateSet>& entries = mStateSetCache[frameNum%2][hash];
 
-        LightStateSetMap::iterator found = stateSetCache.find(hash);
-        if (found != stateSetCache.end())
-            return found->second;
+        // different light lists may have the same hash, so compare light IDs as well
+        const auto sameLights = [&] (const CachedLightStateSet& entry)
+        {
+            if (entry.mLightIds.size() != lightList.size())
+                return false;
+            for (unsigned int i=0; i<lightList.size(); ++i)
+                if (entry.mLightIds[i] != lightList[i]->mLightSource->getId())
+                    return false;
+            return true;
+        };
+
+        auto found = std::find_if(entries.begin(), entries.end(), sameLights);
+        if (found != entries.end())
+        {
+            found->mLastUsedFrame = frameNum;
+            return found->mStateSet;
+        }
         else
         {
             osg::ref_ptr<osg::StateSet> stateset = new osg::StateSet;
@@ -252,7 +288,12 @@ namespace SceneUtil
             for (unsigned int i=1; i<lightList.size(); ++i)
                 stateset->setAttribute(mDummies[i+mStartLight].get(), osg::StateAttribute::ON);
 
-            stateSetCache.emplace(hash, stateset);
+            std::vector<int> lightIds;
+            lightIds.reserve(lightList.size());
+            for (unsigned int i=0; i<lightList.size(); ++i)
+                lightIds.push_back(lightList[i]->mLightSource->getId());
+
+            entries.push_back(CachedLightStateSet {std::move(lightIds), stateset, frameNum});
             return stateset;
         }
     }
@@ -263,14 +304,73 @@ namespace SceneUtil
     }
 
     const std::vector<LightManager::LightSourceViewBound>& LightManager::getLightsInViewSpace(osg::Camera *camera, const osg::RefMatrix* viewMatrix)
+    {
+        return getViewSpaceLights(camera, viewMatrix).mLights;
+    }
+
+    namespace
+    {
+        // Lights covering more cells are tested against every node
+        constexpr std::size_t maxCellsPerLight = 64;
+        constexpr int maxCellIndex = (1 << 20) - 1;
+
+        int getCellIndex(float value, float cellSize)
+        {
+            const float index = std::floor(value / cellSize);
+            return static_cast<int>(std::max(-static_cast<float>(maxCellIndex), std::min(static_cast<float>(maxCellIndex), index)));
+        }
+
+        std::uint64_t makeCellKey(int x, int y, int z)
+        {
+            const auto pack = [] (int value) { return static_cast<std::uint64_t>(value + maxCellIndex) & 0x1FFFFF; };
+            return pack(x) << 42 | pack(y) << 21 | pack(z);
+        }
+
+        struct CellRange
+        {
+            int mMin[3];
+            int mMax[3];
+
+            CellRange(const osg::BoundingSphere& bound, float cellSize)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    mMin[i] = getCellIndex(bound.center()[i] - bound.radius(), cellSize);
+                    mMax[i] = getCellIndex(bound.center()[i] + bound.radius(), cellSize);
+                }
+            }
+
+            double getNumCells() const
+            {
+                double result = 1;
+                for (int i = 0; i < 3; ++i)
+                    result *= static_cast<double>(mMax[i] - mMin[i] + 1);
+                return result;
+            }
+
+            template <class Function>
+            void forEachCell(Function&& function) const
+            {
+                for (int x = mMin[0]; x <= mMax[0]; ++x)
+                    for (int y = mMin[1]; y <= mMax[1]; ++y)
+                        for (int z = mMin[2]; z <= mMax[2]; ++z)
+                            function(makeCellKey(x, y, z));
+            }
+        };
+    }
+
+    const LightManager::ViewSpaceLights& LightManager::getViewSpaceLights(osg::Camera *camera, const osg::RefMatrix* viewMatrix)
     {
         osg::observer_ptr<osg::Camera> camPtr (camera);
-        std::map<osg::observer_ptr<osg::Camera>, LightSourceViewBoundCollection>::iterator it = mLightsInViewSpace.find(camPtr);
+        std::map<osg::observer_ptr<osg::Camera>, ViewSpaceLights>::iterator it = mLightsInViewSpace.find(camPtr);
 
         if (it == mLightsInViewSpace.end())
         {
-            it = mLightsInViewSpace.insert(std::make_pair(camPtr, LightSourceViewBoundCollection())).first;
+            it = mLightsInViewSpace.insert(std::make_pair(camPtr, ViewSpaceLights())).first;
+            ViewSpaceLights& viewSpaceLights = it->second;
+            viewSpaceLights.mLights.reserve(mLights.size());
 
+            float radiusSum = 0;
             for (std::vector<LightSourceTransform>::iterator lightIt = mLights.begin(); lightIt != mLights.end(); ++lightIt)
             {
                 osg::Matrixf worldViewMat = lightIt->mWorldMatrix * (*viewMatrix);
@@ -280,12 +380,69 @@ namespace SceneUtil
                 LightSourceViewBound l;
                 l.mLightSource = lightIt->mLightSource;
                 l.mViewBound = viewBound;
-                it->second.push_back(l);
+                viewSpaceLights.mLights.push_back(l);
+                if (viewBound.valid())
+                    radiusSum += viewBound.radius();
+            }
+
+            // with cells about the size of an average light most lights cover no more than 8 cells
+            if (!viewSpaceLights.mLights.empty())
+                viewSpaceLights.mCellSize = std::max(1.f, 2 * radiusSum / viewSpaceLights.mLights.size());
+
+            for (std::size_t i = 0; i < viewSpaceLights.mLights.size(); ++i)
+            {
+                const osg::BoundingSphere& viewBound = viewSpaceLights.mLights[i].mViewBound;
+                if (!viewBound.valid())
+                    continue;
+                const CellRange range(viewBound, viewSpaceLights.mCellSize);
+                if (range.getNumCells() > maxCellsPerLight)
+                    viewSpaceLights.mLargeLights.push_back(i);
+                else
+                    range.forEachCell([&] (std::uint64_t key) { viewSpaceLights.mCells[key].push_back(i); });
             }
         }
         return it->second;
     }
 
+    void LightManager::getLightsInViewBound(osg::Camera* camera, const osg::RefMatrix* viewMatrix, const osg::BoundingSphere& viewBound, LightList& out)
+    {
+        out.clear();
+
+        const ViewSpaceLights& viewSpaceLights = getViewSpaceLights(camera, viewMatrix);
+        if (!viewBound.valid() || viewSpaceLights.mLights.empty())
+            return;
+
+        const CellRange range(viewBound, viewSpaceLights.mCellSize);
+
+        // For large bounds it's cheaper to test every light
+        if (range.getNumCells() > viewSpaceLights.mCells.size())
+        {
+            for (const LightSourceViewBound& light : viewSpaceLights.mLights)
+                if (light.mViewBound.intersects(viewBound))
+                    out.push_back(&light);
+            return;
+        }
+
+        mCandidates.assign(viewSpaceLights.mLargeLights.begin(), viewSpaceLights.mLargeLights.end());
+        range.forEachCell([&] (std::uint64_t key)
+        {
+            const auto cell = viewSpaceLights.mCells.find(key);
+            if (cell != viewSpaceLights.mCells.end())
+                mCandidates.insert(mCandidates.end(), cell->second.begin(), cell->second.end());
+        });
+
+        // Lights may be found in multiple cells, keep the order of the lights to get the same light list for the same lights
+        std::sort(mCandidates.begin(), mCandidates.end());
+        mCandidates.erase(std::unique(mCandidates.begin(), mCandidates.end()), mCandidates.end());
+
+        for (std::size_t index : mCandidates)
+        {
+            const LightSourceViewBound& light = viewSpaceLights.mLights[index];
+            if (light.mViewBound.intersects(viewBound))
+                out.push_back(&light);
+        }
+    }
+
     class DisableLight : public osg::StateAttribute
     {
     public:
@@ -402,8 +559,6 @@ namespace SceneUtil
 
         // Possible optimizations:
         // - cull list of lights by the camera frustum
-        // - organize lights in a quad tree
-
 
         // update light list if necessary
         // makes sure we don't update it more than once per frame when rendering with multiple cameras
@@ -413,7 +568,6 @@ namespace SceneUtil
 
             // Don't use Camera::getViewMatrix, that one might be relative to another camera!
             const osg::RefMatrix* viewMatrix = cv->getCurrentRenderStage()->getInitialViewMatrix();
-            const std::vector<LightManager::LightSourceViewBound>& lights = mLightManager->getLightsInViewSpace(cv->getCurrentCamera(), viewMatrix);
 
             // get the node bounds in view space
             // NB do not node->getBound() * modelView, that would apply the node's transformation twice
@@ -429,16 +583,13 @@ namespace SceneUtil
             osg::Matrixf mat = *cv->getModelViewMatrix();
             transformBoundingSphere(mat, nodeBound);
 
-            mLightList.clear();
-            for (unsigned int i=0; i<lights.size(); ++i)
-            {
-                const LightManager::LightSourceViewBound& l = lights[i];
-
-                if (mIgnoredLightSources.count(l.mLightSource))
-                    continue;
+            mLightManager->getLightsInViewBound(cv->getCurrentCamera(), viewMatrix, nodeBound, mLightList);
 
-                if (l.mViewBound.intersects(nodeBound))
-                    mLightList.push_back(&l);
+            if (!mIgnoredLightSources.empty())
+            {
+                mLightList.erase(std::remove_if(mLightList.begin(), mLightList.end(),
+                    [&] (const LightManager::LightSourceViewBound* l) { return mIgnoredLightSources.count(l->mLightSource) != 0; }),
+                    mLightList.end());
             }
         }
         if (!mLightList.empty())
@@ -469,10 +620,10 @@ namespace SceneUtil
 
                 if (lightList.size() > maxLights)
                 {
-                    // sort by proximity to camera, then get rid of furthest away lights
+                    // select lights closest to camera, then get rid of furthest away lights
+                    std::nth_element(lightList.begin(), lightList.begin() + maxLights, lightList.end(), sortLights);
+                    lightList.resize(maxLights);
                     std::sort(lightList.begin(), lightList.end(), sortLights);
-                    while (lightList.size() > maxLights)
-                        lightList.pop_back();
                 }
                 stateset = mLightManager->getLightListStateSet(lightList, cv->getTraversalNumber());
             }
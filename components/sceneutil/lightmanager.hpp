@@ -1,7 +1,9 @@
 #ifndef OPENMW_COMPONENTS_SCENEUTIL_LIGHTMANAGER_H
 #define OPENMW_COMPONENTS_SCENEUTIL_LIGHTMANAGER_H
 
+#include <cstdint>
 #include <set>
+#include <unordered_map>
 
 #include <osg/Light>
 
@@ -104,7 +106,7 @@ namespace SceneUtil
         int getStartLight() const;
 
         /// Internal use only, called automatically by the LightManager's UpdateCallback
-        void update();
+        void update(unsigned int frameNum);
 
         /// Internal use only, called automatically by the LightSource's UpdateCallback
         void addLight(LightSource* lightSource, const osg::Matrixf& worldMat, unsigned int frameNum);
@@ -127,6 +129,9 @@ namespace SceneUtil
 
         typedef std::vector<const LightSourceViewBound*> LightList;
 
+        /// Get lights with view space bound intersecting \a viewBound, in the same order as getLightsInViewSpace returns them.
+        void getLightsInViewBound(osg::Camera* camera, const osg::RefMatrix* viewMatrix, const osg::BoundingSphere& viewBound, LightList& out);
+
         osg::ref_ptr<osg::StateSet> getLightListStateSet(const LightList& lightList, unsigned int frameNum);
 
     private:
@@ -134,10 +139,37 @@ namespace SceneUtil
         std::vector<LightSourceTransform> mLights;
 
         typedef std::vector<LightSourceViewBound> LightSourceViewBoundCollection;
-        std::map<osg::observer_ptr<osg::Camera>, LightSourceViewBoundCollection> mLightsInViewSpace;
 
-        // < Light list hash , StateSet >
-        typedef std::map<size_t, osg::ref_ptr<osg::StateSet> > LightStateSetMap;
+        // Lights in view space of a camera binned into a uniform grid, so the lights affecting a node can be found
+        // without testing every light in the scene
+        struct ViewSpaceLights
+        {
+            LightSourceViewBoundCollection mLights;
+            float mCellSize = 1.f;
+            // < Cell key , indices of lights in mLights >
+            std::unordered_map<std::uint64_t, std::vector<std::size_t>> mCells;
+            // Lights covering too many cells to be binned
+            std::vector<std::size_t> mLargeLights;
+        };
+
+        std::map<osg::observer_ptr<osg::Camera>, ViewSpaceLights> mLightsInViewSpace;
+
+        const ViewSpaceLights& getViewSpaceLights(osg::Camera* camera, const osg::RefMatrix* viewMatrix);
+
+        // Temporary storage for getLightsInViewBound
+        std::vector<std::size_t> mCandidates;
+
+        struct CachedLightStateSet
+        {
+            std::vector<int> mLightIds;
+            osg::ref_ptr<osg::StateSet> mStateSet;
+            unsigned int mLastUsedFrame;
+        };
+
+        // < Light list hash , StateSets for light lists with this hash >
+        // Kept across frames, so objects with unchanged light lists reuse their StateSet.
+        // Entries not used for a while are removed in update().
+        typedef std::unordered_map<size_t, std::vector<CachedLightStateSet>> LightStateSetMap;
         LightStateSetMap mStateSetCache[2];
 
         std::vector<osg::ref_ptr<osg::StateAttribute>> mDummies;
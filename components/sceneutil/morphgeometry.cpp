@@ -1,6 +1,10 @@
 #include "morphgeometry.hpp"
 
+#include "morphing.hpp"
+
 #include <cassert>
+#include <cstring>
+#include <vector>
 
 #include <osg/Version>
 
@@ -163,17 +167,28 @@ void MorphGeometry::cull(osg::NodeVisitor *nv)
     const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
     osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
     assert(positionSrc->size() == positionDst->size());
-    for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
-        (*positionDst)[vertex] = (*positionSrc)[vertex];
 
-    for (unsigned int i=0; i<mMorphTargets.size(); ++i)
+    std::vector<ActiveMorphTarget> activeTargets;
+    for (const MorphTarget& target : mMorphTargets)
     {
-        float weight = mMorphTargets[i].getWeight();
+        const float weight = target.getWeight();
         if (weight == 0.f)
             continue;
-        const osg::Vec3Array* offsets = mMorphTargets[i].getOffsets();
-        for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
-            (*positionDst)[vertex] += (*offsets)[vertex] * weight;
+        const osg::Vec3Array* offsets = target.getOffsets();
+        if (offsets->size() < positionSrc->size())
+            continue;
+        activeTargets.push_back(ActiveMorphTarget {static_cast<const float*>(offsets->getDataPointer()), weight});
+    }
+
+    if (!positionSrc->empty())
+    {
+        const float* src = static_cast<const float*>(positionSrc->getDataPointer());
+        float* dst = &(*positionDst)[0][0];
+        const std::size_t count = positionSrc->size() * 3;
+        if (activeTargets.empty())
+            std::memcpy(dst, src, count * sizeof(float));
+        else
+            applyMorphTargets(src, activeTargets, dst, count);
     }
 
     positionDst->dirty();
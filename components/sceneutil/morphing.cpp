@@ -0,0 +1,30 @@
+#include "morphing.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENMW_MORPHING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace SceneUtil
+{
+    void applyMorphTargets(const float* src, const std::vector<ActiveMorphTarget>& targets, float* dst, std::size_t count)
+    {
+        std::size_t i = 0;
+#ifdef OPENMW_MORPHING_SSE
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 value = _mm_loadu_ps(src + i);
+            for (const ActiveMorphTarget& target : targets)
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(target.mOffsets + i), _mm_set1_ps(target.mWeight)));
+            _mm_storeu_ps(dst + i, value);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            float value = src[i];
+            for (const ActiveMorphTarget& target : targets)
+                value += target.mOffsets[i] * target.mWeight;
+            dst[i] = value;
+        }
+    }
+}
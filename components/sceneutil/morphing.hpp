@@ -0,0 +1,20 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_MORPHING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_MORPHING_H
+
+#include <cstddef>
+#include <vector>
+
+namespace SceneUtil
+{
+    struct ActiveMorphTarget
+    {
+        const float* mOffsets;
+        float mWeight;
+    };
+
+    /// @brief dst[i] = src[i] + sum of target.mOffsets[i] * target.mWeight, all targets are added in a single pass over dst.
+    /// @note Uses SSE when it's available for the target architecture, scalar code otherwise.
+    void applyMorphTargets(const float* src, const std::vector<ActiveMorphTarget>& targets, float* dst, std::size_t count);
+}
+
+#endif
@@ -5,30 +5,15 @@
 #include <components/debug/debuglog.hpp>
 
 #include "skeleton.hpp"
+#include "skinning.hpp"
 #include "util.hpp"
 
 namespace
 {
-    inline void accumulateMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& matrix, const float weight, osg::Matrixf& result)
+    template <class T, class ArrayT>
+    T* getData(ArrayT* array)
     {
-        osg::Matrixf m = invBindMatrix * matrix;
-        float* ptr = m.ptr();
-        float* ptrresult = result.ptr();
-        ptrresult[0] += ptr[0] * weight;
-        ptrresult[1] += ptr[1] * weight;
-        ptrresult[2] += ptr[2] * weight;
-
-        ptrresult[4] += ptr[4] * weight;
-        ptrresult[5] += ptr[5] * weight;
-        ptrresult[6] += ptr[6] * weight;
-
-        ptrresult[8] += ptr[8] * weight;
-        ptrresult[9] += ptr[9] * weight;
-        ptrresult[10] += ptr[10] * weight;
-
-        ptrresult[12] += ptr[12] * weight;
-        ptrresult[13] += ptr[13] * weight;
-        ptrresult[14] += ptr[14] * weight;
+        return array ? static_cast<T*>(const_cast<void*>(array->getDataPointer())) : nullptr;
     }
 }
 
@@ -218,26 +203,18 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
             if (bone == nullptr)
                 continue;
 
-            accumulateMatrix(weight.first.second, bone->mMatrixInSkeletonSpace, weight.second, resultMat);
+            accumulateSkinningMatrix(weight.first.second, bone->mMatrixInSkeletonSpace, weight.second, resultMat);
             index++;
         }
 
         if (mGeomToSkelMatrix)
             resultMat *= (*mGeomToSkelMatrix);
 
-        for (auto &vertex : pair.second)
-        {
-            (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
-            if (normalDst)
-                (*normalDst)[vertex] = osg::Matrixf::transform3x3((*normalSrc)[vertex], resultMat);
-
-            if (tangentDst)
-            {
-                const osg::Vec4f& srcTangent = (*tangentSrc)[vertex];
-                osg::Vec3f transformedTangent = osg::Matrixf::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
-                (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
-            }
-        }
+        const VertexList& vertices = pair.second;
+        skinVertices(resultMat, vertices.data(), vertices.size(),
+                     getData<osg::Vec3f>(positionSrc), getData<osg::Vec3f>(positionDst),
+                     getData<osg::Vec3f>(normalSrc), getData<osg::Vec3f>(normalDst),
+                     getData<osg::Vec4f>(tangentSrc), getData<osg::Vec4f>(tangentDst));
     }
 
     positionDst->dirty();
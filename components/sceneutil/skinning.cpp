@@ -0,0 +1,137 @@
+#include "skinning.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENMW_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+#ifdef OPENMW_SKINNING_SSE
+    struct MatrixRows
+    {
+        __m128 mRows[4];
+
+        explicit MatrixRows(const osg::Matrixf& matrix)
+        {
+            const float* ptr = matrix.ptr();
+            for (int i = 0; i < 4; ++i)
+                mRows[i] = _mm_loadu_ps(ptr + i * 4);
+        }
+
+        // Row vector by matrix product, the same as osg::Matrixf::transform3x3
+        __m128 transform3x3(const float* v) const
+        {
+            __m128 result = _mm_mul_ps(_mm_set1_ps(v[0]), mRows[0]);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v[1]), mRows[1]));
+            return _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v[2]), mRows[2]));
+        }
+
+        // The same as osg::Matrixf::preMult for affine matrix
+        __m128 transformPoint(const float* v) const
+        {
+            return _mm_add_ps(transform3x3(v), mRows[3]);
+        }
+    };
+
+    // Writes only 3 floats, vertices are stored tightly so storing 4 would overwrite the next one
+    inline void storeVec3(__m128 value, float* dst)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(value, value));
+    }
+#endif
+}
+
+namespace SceneUtil
+{
+    void accumulateSkinningMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& boneMatrix, float weight,
+                                  osg::Matrixf& result)
+    {
+#ifdef OPENMW_SKINNING_SSE
+        const MatrixRows bone(boneMatrix);
+        const float* inv = invBindMatrix.ptr();
+        float* ptrresult = result.ptr();
+        // Zero weight for the last column to keep it unchanged
+        const __m128 weights = _mm_set_ps(0, weight, weight, weight);
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128 row = _mm_add_ps(bone.transform3x3(inv + i * 4), _mm_mul_ps(_mm_set1_ps(inv[i * 4 + 3]), bone.mRows[3]));
+            row = _mm_add_ps(_mm_loadu_ps(ptrresult + i * 4), _mm_mul_ps(row, weights));
+            _mm_storeu_ps(ptrresult + i * 4, row);
+        }
+#else
+        osg::Matrixf m = invBindMatrix * boneMatrix;
+        float* ptr = m.ptr();
+        float* ptrresult = result.ptr();
+        ptrresult[0] += ptr[0] * weight;
+        ptrresult[1] += ptr[1] * weight;
+        ptrresult[2] += ptr[2] * weight;
+
+        ptrresult[4] += ptr[4] * weight;
+        ptrresult[5] += ptr[5] * weight;
+        ptrresult[6] += ptr[6] * weight;
+
+        ptrresult[8] += ptr[8] * weight;
+        ptrresult[9] += ptr[9] * weight;
+        ptrresult[10] += ptr[10] * weight;
+
+        ptrresult[12] += ptr[12] * weight;
+        ptrresult[13] += ptr[13] * weight;
+        ptrresult[14] += ptr[14] * weight;
+#endif
+    }
+
+    void skinVertices(const osg::Matrixf& matrix, const unsigned short* vertices, std::size_t count,
+                      const osg::Vec3f* positionSrc, osg::Vec3f* positionDst,
+                      const osg::Vec3f* normalSrc, osg::Vec3f* normalDst,
+                      const osg::Vec4f* tangentSrc, osg::Vec4f* tangentDst)
+    {
+#ifdef OPENMW_SKINNING_SSE
+        const MatrixRows rows(matrix);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const unsigned short vertex = vertices[i];
+            storeVec3(rows.transformPoint(positionSrc[vertex].ptr()), positionDst[vertex].ptr());
+        }
+
+        if (normalDst)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const unsigned short vertex = vertices[i];
+                storeVec3(rows.transform3x3(normalSrc[vertex].ptr()), normalDst[vertex].ptr());
+            }
+        }
+
+        if (tangentDst)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const unsigned short vertex = vertices[i];
+                const float w = tangentSrc[vertex].w();
+                // Tangent is a Vec4f so the whole value can be stored at once, w is copied from source
+                __m128 tangent = rows.transform3x3(tangentSrc[vertex].ptr());
+                tangent = _mm_shuffle_ps(tangent, _mm_unpackhi_ps(tangent, _mm_set1_ps(w)), _MM_SHUFFLE(1, 0, 1, 0));
+                _mm_storeu_ps(tangentDst[vertex].ptr(), tangent);
+            }
+        }
+#else
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const unsigned short vertex = vertices[i];
+            positionDst[vertex] = matrix.preMult(positionSrc[vertex]);
+            if (normalDst)
+                normalDst[vertex] = osg::Matrixf::transform3x3(normalSrc[vertex], matrix);
+
+            if (tangentDst)
+            {
+                const osg::Vec4f& srcTangent = tangentSrc[vertex];
+                osg::Vec3f transformedTangent = osg::Matrixf::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), matrix);
+                tangentDst[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+
+#include <cstddef>
+
+#include <osg/Matrixf>
+#include <osg/Vec3f>
+#include <osg/Vec4f>
+
+namespace SceneUtil
+{
+    /// @brief Add invBindMatrix * boneMatrix scaled by weight to the upper 4x3 part of result.
+    /// @note The last column of result is left unchanged, matrices are expected to be affine.
+    void accumulateSkinningMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& boneMatrix, float weight,
+                                  osg::Matrixf& result);
+
+    /// @brief Transform listed vertices of the source arrays by the affine matrix and write them to the destination arrays.
+    /// Positions are transformed as points, normals and tangents as directions. Normal and tangent arrays may be nullptr.
+    /// @note Uses SSE when it's available for the target architecture, scalar code otherwise.
+    void skinVertices(const osg::Matrixf& matrix, const unsigned short* vertices, std::size_t count,
+                      const osg::Vec3f* positionSrc, osg::Vec3f* positionDst,
+                      const osg::Vec3f* normalSrc, osg::Vec3f* normalDst,
+                      const osg::Vec4f* tangentSrc, osg::Vec4f* tangentDst);
+}
+
+#endif
@@ -4,6 +4,13 @@
 
 #include <numeric>
 
+namespace
+{
+    // Set for worker threads, so items added by running work items go to the queue of the same thread
+    thread_local const SceneUtil::WorkQueue* sCurrentQueue = nullptr;
+    thread_local std::size_t sCurrentThreadIndex = 0;
+}
+
 namespace SceneUtil
 {
 
@@ -21,11 +28,17 @@ void WorkItem::waitTillDone()
 
 void WorkItem::signalDone()
 {
+    std::vector<osg::ref_ptr<WorkItem>> dependents;
     {
         std::unique_lock<std::mutex> lock(mMutex);
         mDone = true;
+        dependents.swap(mDependents);
     }
     mCondition.notify_all();
+
+    for (osg::ref_ptr<WorkItem>& dependent : dependents)
+        if (--dependent->mPendingDependencies == 0)
+            dependent->mQueue->push(std::move(dependent));
 }
 
 bool WorkItem::isDone() const
@@ -33,27 +46,69 @@ bool WorkItem::isDone() const
     return mDone;
 }
 
+void WorkItem::cancel()
+{
+    mCancelled = true;
+    abort();
+}
+
+bool WorkItem::isCancelled() const
+{
+    return mCancelled;
+}
+
+void WorkItem::addDependency(osg::ref_ptr<WorkItem> item)
+{
+    mDependencies.push_back(std::move(item));
+}
+
 WorkQueue::WorkQueue(int workerThreads)
     : mIsReleased(false)
+    , mNumItems(0)
+    , mNextQueue(0)
 {
     for (int i=0; i<workerThreads; ++i)
-        mThreads.emplace_back(std::make_unique<WorkThread>(*this));
+        mQueues.emplace_back(std::make_unique<ThreadQueue>());
+    for (int i=0; i<workerThreads; ++i)
+        mThreads.emplace_back(std::make_unique<WorkThread>(*this, static_cast<std::size_t>(i)));
 }
 
 WorkQueue::~WorkQueue()
 {
     {
         std::unique_lock<std::mutex> lock(mMutex);
-        while (!mQueue.empty())
-            mQueue.pop_back();
         mIsReleased = true;
         mCondition.notify_all();
     }
 
     mThreads.clear();
+
+    // Release waiting threads, the items are never going to be processed
+    for (auto& queue : mQueues)
+    {
+        for (auto& items : queue->mItems)
+        {
+            for (auto& item : items)
+            {
+                item->mCancelled = true;
+                item->signalDone();
+            }
+            items.clear();
+        }
+    }
 }
 
 void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
+{
+    enqueue(std::move(item), front ? Priority::High : Priority::Normal, front);
+}
+
+void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, Priority priority)
+{
+    enqueue(std::move(item), priority, false);
+}
+
+void WorkQueue::enqueue(osg::ref_ptr<WorkItem> item, Priority priority, bool front)
 {
     if (item->isDone())
     {
@@ -61,35 +116,116 @@ void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
         return;
     }
 
-    std::unique_lock<std::mutex> lock(mMutex);
-    if (front)
-        mQueue.push_front(item);
-    else
-        mQueue.push_back(item);
+    item->mQueue = this;
+    item->mPriority = static_cast<std::size_t>(priority);
+    item->mFront = front;
+
+    // Hold one pending dependency until all dependencies are registered, so the item isn't queued by the
+    // dependency that is done in the middle of the loop
+    item->mPendingDependencies = 1;
+    for (const osg::ref_ptr<WorkItem>& dependency : item->mDependencies)
+    {
+        std::lock_guard<std::mutex> lock(dependency->mMutex);
+        if (dependency->mDone)
+            continue;
+        ++item->mPendingDependencies;
+        dependency->mDependents.push_back(item);
+    }
+    item->mDependencies.clear();
+
+    if (--item->mPendingDependencies == 0)
+        push(std::move(item));
+}
+
+void WorkQueue::push(osg::ref_ptr<WorkItem> item)
+{
+    if (mIsReleased)
+    {
+        item->mCancelled = true;
+        item->signalDone();
+        return;
+    }
+
+    if (mQueues.empty())
+        return;
+
+    const std::size_t index = sCurrentQueue == this
+        ? sCurrentThreadIndex
+        : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size();
+
+    // Count is increased first to never get below the number of items in the queues
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        ++mNumItems;
+    }
+
+    {
+        ThreadQueue& queue = *mQueues[index];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        auto& items = queue.mItems[item->mPriority];
+        if (item->mFront)
+            items.push_front(std::move(item));
+        else
+            items.push_back(std::move(item));
+    }
+
     mCondition.notify_one();
 }
 
-osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem()
+osg::ref_ptr<WorkItem> WorkQueue::takeWorkItem(std::size_t threadIndex)
 {
-    std::unique_lock<std::mutex> lock(mMutex);
-    while (mQueue.empty() && !mIsReleased)
+    for (std::size_t priority = 0; priority < sNumPriorities; ++priority)
     {
-        mCondition.wait(lock);
+        // Own queue is processed in order, other threads' queues from the back to take the work
+        // they would get to last
+        for (std::size_t i = 0; i < mQueues.size(); ++i)
+        {
+            const std::size_t index = (threadIndex + i) % mQueues.size();
+            ThreadQueue& queue = *mQueues[index];
+            std::lock_guard<std::mutex> lock(queue.mMutex);
+            auto& items = queue.mItems[priority];
+            if (items.empty())
+                continue;
+            osg::ref_ptr<WorkItem> item;
+            if (index == threadIndex)
+            {
+                item = std::move(items.front());
+                items.pop_front();
+            }
+            else
+            {
+                item = std::move(items.back());
+                items.pop_back();
+            }
+            --mNumItems;
+            return item;
+        }
     }
-    if (!mQueue.empty())
+    return nullptr;
+}
+
+osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem(std::size_t threadIndex)
+{
+    while (true)
     {
-        osg::ref_ptr<WorkItem> item = mQueue.front();
-        mQueue.pop_front();
-        return item;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [&] { return mNumItems > 0 || mIsReleased; });
+            if (mIsReleased)
+                return nullptr;
+        }
+
+        if (osg::ref_ptr<WorkItem> item = takeWorkItem(threadIndex))
+            return item;
+
+        // Other thread took the item first or it's not pushed yet
+        std::this_thread::yield();
     }
-    else
-        return nullptr;
 }
 
 unsigned int WorkQueue::getNumItems() const
 {
-    std::unique_lock<std::mutex> lock(mMutex);
-    return mQueue.size();
+    return mNumItems;
 }
 
 unsigned int WorkQueue::getNumActiveThreads() const
@@ -98,8 +234,9 @@ unsigned int WorkQueue::getNumActiveThreads() const
         [] (auto r, const auto& t) { return r + t->isActive(); });
 }
 
-WorkThread::WorkThread(WorkQueue& workQueue)
+WorkThread::WorkThread(WorkQueue& workQueue, std::size_t index)
     : mWorkQueue(&workQueue)
+    , mIndex(index)
     , mActive(false)
     , mThread([this] { run(); })
 {
@@ -112,13 +249,17 @@ WorkThread::~WorkThread()
 
 void WorkThread::run()
 {
+    sCurrentQueue = mWorkQueue;
+    sCurrentThreadIndex = mIndex;
+
     while (true)
     {
-        osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
+        osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem(mIndex);
         if (!item)
             return;
         mActive = true;
-        item->doWork();
+        if (!item->isCancelled())
+            item->doWork();
         item->signalDone();
         mActive = false;
     }
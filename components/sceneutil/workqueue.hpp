@@ -4,15 +4,20 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 
+#include <array>
 #include <atomic>
-#include <queue>
+#include <deque>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 namespace SceneUtil
 {
 
+    class WorkQueue;
+
     class WorkItem : public osg::Referenced
     {
     public:
@@ -30,52 +35,107 @@ namespace SceneUtil
         /// Set abort flag in order to return from doWork() as soon as possible. May not be respected by all WorkItems.
         virtual void abort() {}
 
+        /// Don't start doWork() if it's not started yet and abort() it otherwise. The item is signalled done either way.
+        void cancel();
+
+        bool isCancelled() const;
+
+        /// Don't start this item until the given item is done. Must be called before the item is added to a WorkQueue.
+        /// @note The dependency has to be added to a WorkQueue as well, or this item will never be started.
+        void addDependency(osg::ref_ptr<WorkItem> item);
+
     private:
+        friend class WorkQueue;
+
         std::atomic_bool mDone {false};
+        std::atomic_bool mCancelled {false};
         std::mutex mMutex;
         std::condition_variable mCondition;
+
+        std::vector<osg::ref_ptr<WorkItem>> mDependencies;
+        // Guarded by mMutex
+        std::vector<osg::ref_ptr<WorkItem>> mDependents;
+        std::atomic_int mPendingDependencies {0};
+        WorkQueue* mQueue = nullptr;
+        std::size_t mPriority = 0;
+        bool mFront = false;
     };
 
     class WorkThread;
 
     /// @brief A work queue that users can push work items onto, to be completed by one or more background threads.
-    /// @note Work items will be processed in the order that they were given in, however
+    /// @par Each thread has its own queue of items per priority, items added from outside go to the thread queues
+    /// in round robin order and items added from a worker thread go to its own queue. A thread that has nothing
+    /// to do takes work from the other threads' queues, higher priority items are always taken first.
+    /// @note Work items of the same priority will be started in about the order that they were given in, however
     /// if multiple work threads are involved then it is possible for a later item to complete before earlier items.
     class WorkQueue : public osg::Referenced
     {
     public:
+        enum class Priority
+        {
+            High,
+            Normal,
+            Low,
+        };
+
         WorkQueue(int numWorkerThreads=1);
         ~WorkQueue();
 
         /// Add a new work item to the back of the queue.
         /// @par The work item's waitTillDone() method may be used by the caller to wait until the work is complete.
-        /// @param front If true, add item to the front of the queue. If false (default), add to the back.
+        /// @param front If true, add item to the front of the high priority queue, so it is started before
+        /// all other items of the same thread queue. If false (default), add to the back of the normal priority queue.
         void addWorkItem(osg::ref_ptr<WorkItem> item, bool front=false);
 
-        /// Get the next work item from the front of the queue. If the queue is empty, waits until a new item is added.
+        /// Add a new work item to the back of the queue of the given priority.
+        /// The item is queued when all of its dependencies are done.
+        void addWorkItem(osg::ref_ptr<WorkItem> item, Priority priority);
+
+        /// Get the next work item for the given thread, taking it from other threads' queues if there is nothing
+        /// else to do. If the queue is empty, waits until a new item is added.
         /// If the workqueue is in the process of being destroyed, may return nullptr.
         /// @par Used internally by the WorkThread.
-        osg::ref_ptr<WorkItem> removeWorkItem();
+        osg::ref_ptr<WorkItem> removeWorkItem(std::size_t threadIndex);
 
         unsigned int getNumItems() const;
 
         unsigned int getNumActiveThreads() const;
 
     private:
-        bool mIsReleased;
-        std::deque<osg::ref_ptr<WorkItem> > mQueue;
+        static constexpr std::size_t sNumPriorities = 3;
+
+        struct ThreadQueue
+        {
+            std::mutex mMutex;
+            std::array<std::deque<osg::ref_ptr<WorkItem>>, sNumPriorities> mItems;
+        };
+
+        std::atomic_bool mIsReleased;
+        std::atomic_uint mNumItems;
+        std::atomic_size_t mNextQueue;
+        std::vector<std::unique_ptr<ThreadQueue>> mQueues;
 
         mutable std::mutex mMutex;
         std::condition_variable mCondition;
 
         std::vector<std::unique_ptr<WorkThread>> mThreads;
+
+        friend class WorkItem;
+
+        void enqueue(osg::ref_ptr<WorkItem> item, Priority priority, bool front);
+
+        /// Put item which dependencies are done to the thread queue.
+        void push(osg::ref_ptr<WorkItem> item);
+
+        osg::ref_ptr<WorkItem> takeWorkItem(std::size_t threadIndex);
     };
 
     /// Internally used by WorkQueue.
     class WorkThread
     {
     public:
-        WorkThread(WorkQueue& workQueue);
+        WorkThread(WorkQueue& workQueue, std::size_t index);
 
         ~WorkThread();
 
@@ -83,6 +143,7 @@ namespace SceneUtil
 
     private:
         WorkQueue* mWorkQueue;
+        std::size_t mIndex;
         std::atomic<bool> mActive;
         std::thread mThread;
 
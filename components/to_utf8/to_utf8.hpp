@@ -40,6 +40,8 @@ namespace ToUTF8
                 return getLegacyEnc(str.c_str(), str.size());
             }
 
+            FromType getEncoding() const { return mEncoding; }
+
         private:
             void resize(size_t size);
             size_t getLength(const char* input, bool &ascii);
@@ -47,6 +49,7 @@ namespace ToUTF8
             size_t getLength2(const char* input, bool &ascii);
             void copyFromArray2(const char*& chp, char* &out);
 
+            FromType mEncoding;
             std::vector<char> mOutput;
             signed char* translationArray;
     };
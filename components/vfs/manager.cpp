@@ -43,6 +43,7 @@ namespace VFS
 
     void Manager::reset()
     {
+        mPathIndex.clear();
         mIndex.clear();
         for (std::vector<Archive*>::iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             delete *it;
@@ -56,34 +57,50 @@ namespace VFS
 
     void Manager::buildIndex()
     {
+        mPathIndex.clear();
         mIndex.clear();
 
         for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+
+        mPathIndex.build(mIndex);
     }
 
-    Files::IStreamPtr Manager::get(const std::string &name) const
+    Files::IStreamPtr Manager::get(std::string_view name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        File* file = find(name);
+        if (file == nullptr)
+        {
+            std::string normalized(name);
+            normalize_path(normalized, mStrict);
+            throw std::runtime_error("Resource '" + normalized + "' not found");
+        }
+        return file->open();
+    }
 
-        return getNormalized(normalized);
+    Files::IStreamPtr Manager::getNormalized(std::string_view normalizedName) const
+    {
+        File* file = mPathIndex.find(normalizedName, [] (char ch) { return ch; });
+        if (file == nullptr)
+            throw std::runtime_error("Resource '" + std::string(normalizedName) + "' not found");
+        return file->open();
     }
 
-    Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
+    bool Manager::exists(std::string_view name) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
-            throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return find(name) != nullptr;
     }
 
-    bool Manager::exists(const std::string &name) const
+    bool Manager::existsNormalized(std::string_view normalizedName) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        return mPathIndex.find(normalizedName, [] (char ch) { return ch; }) != nullptr;
+    }
 
-        return mIndex.find(normalized) != mIndex.end();
+    File* Manager::find(std::string_view name) const
+    {
+        if (mStrict)
+            return mPathIndex.find(name, [] (char ch) { return strict_normalize_char(ch); });
+        return mPathIndex.find(name, [] (char ch) { return nonstrict_normalize_char(ch); });
     }
 
     const std::map<std::string, File*>& Manager::getIndex() const
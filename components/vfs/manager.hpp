@@ -5,6 +5,9 @@
 
 #include <vector>
 #include <map>
+#include <string_view>
+
+#include "pathindex.hpp"
 
 namespace VFS
 {
@@ -38,7 +41,11 @@ namespace VFS
 
         /// Does a file with this name exist?
         /// @note May be called from any thread once the index has been built.
-        bool exists(const std::string& name) const;
+        bool exists(std::string_view name) const;
+
+        /// Does a file with this name exist? (name is already normalized)
+        /// @note May be called from any thread once the index has been built.
+        bool existsNormalized(std::string_view normalizedName) const;
 
         /// Get a complete list of files from all archives
         /// @note May be called from any thread once the index has been built.
@@ -51,12 +58,12 @@ namespace VFS
         /// Retrieve a file by name.
         /// @note Throws an exception if the file can not be found.
         /// @note May be called from any thread once the index has been built.
-        Files::IStreamPtr get(const std::string& name) const;
+        Files::IStreamPtr get(std::string_view name) const;
 
         /// Retrieve a file by name (name is already normalized).
         /// @note Throws an exception if the file can not be found.
         /// @note May be called from any thread once the index has been built.
-        Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
+        Files::IStreamPtr getNormalized(std::string_view normalizedName) const;
 
     private:
         bool mStrict;
@@ -64,6 +71,11 @@ namespace VFS
         std::vector<Archive*> mArchives;
 
         std::map<std::string, File*> mIndex;
+
+        /// Used for lookups by name, mIndex is kept for ordered iteration over the files
+        PathIndex mPathIndex;
+
+        File* find(std::string_view name) const;
     };
 
 }
@@ -0,0 +1,32 @@
+#include "pathindex.hpp"
+
+namespace VFS
+{
+
+    void PathIndex::clear()
+    {
+        mSlots.clear();
+        mMask = 0;
+    }
+
+    void PathIndex::build(const std::map<std::string, File*>& files)
+    {
+        // Keep load factor at most 0.5 to make probe sequences short
+        std::size_t capacity = 16;
+        while (capacity < files.size() * 2)
+            capacity *= 2;
+
+        mSlots.assign(capacity, Slot());
+        mMask = capacity - 1;
+
+        for (const auto& file : files)
+        {
+            const std::uint64_t hash = Misc::fnv1aHash(file.first);
+            std::size_t i = static_cast<std::size_t>(hash) & mMask;
+            while (mSlots[i].mFile != nullptr)
+                i = (i + 1) & mMask;
+            mSlots[i] = Slot {hash, &file.first, file.second};
+        }
+    }
+
+}
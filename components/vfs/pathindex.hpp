@@ -0,0 +1,76 @@
+#ifndef OPENMW_COMPONENTS_VFS_PATHINDEX_H
+#define OPENMW_COMPONENTS_VFS_PATHINDEX_H
+
+#include <components/misc/hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VFS
+{
+
+    class File;
+
+    /// @brief Open addressing hash table over normalized file names.
+    /// @par Names are normalized while hashing and comparing, so a lookup does not need to copy the name.
+    /// @note Stores pointers to the keys of the map given to build(), the map must outlive the index or the next build().
+    class PathIndex
+    {
+    public:
+        void clear();
+
+        void build(const std::map<std::string, File*>& files);
+
+        /// @param normalize function applied to each character of @a name, must produce the same
+        /// result as the function used to normalize the keys given to build()
+        template <class Normalize>
+        File* find(std::string_view name, Normalize&& normalize) const
+        {
+            if (mSlots.empty())
+                return nullptr;
+
+            Misc::Fnv1aHash hasher;
+            for (char ch : name)
+                hasher.addValue(normalize(ch));
+            const std::uint64_t hash = hasher.getValue();
+
+            for (std::size_t i = static_cast<std::size_t>(hash) & mMask; ; i = (i + 1) & mMask)
+            {
+                const Slot& slot = mSlots[i];
+                if (slot.mFile == nullptr)
+                    return nullptr;
+                if (slot.mHash == hash && equals(*slot.mName, name, normalize))
+                    return slot.mFile;
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            std::uint64_t mHash = 0;
+            const std::string* mName = nullptr;
+            File* mFile = nullptr;
+        };
+
+        std::vector<Slot> mSlots;
+        std::size_t mMask = 0;
+
+        template <class Normalize>
+        static bool equals(const std::string& normalized, std::string_view name, Normalize&& normalize)
+        {
+            if (normalized.size() != name.size())
+                return false;
+            for (std::size_t i = 0; i < name.size(); ++i)
+                if (normalized[i] != normalize(name[i]))
+                    return false;
+            return true;
+        }
+    };
+
+}
+
+#endif